@@ -1,7 +1,14 @@
 # SPDX-License-Identifier: MIT | Author: Rohit Patil
 find_package(Python3 REQUIRED COMPONENTS Interpreter)
 
-set(INPUT_YAML "${EVENT_DESCRIPTION_FILE}")
+# One YAML file per stream, all streams end up in one metadata.
+set(INPUT_YAML ${EVENT_DESCRIPTION_FILE})
+
+# Field order, padding and CTF `align` follow the library event layout.
+set(EVENT_GENERATE_LAYOUT "")
+if (EVENT_ALIGNED_LAYOUT)
+    set(EVENT_GENERATE_LAYOUT "--aligned")
+endif ()
 
 if (EXISTS "${EVENT_GENERATED_OUT_DIR}")
     set(OUTPUT_DIR "${EVENT_GENERATED_OUT_DIR}")
@@ -11,19 +18,57 @@ endif ()
 
 set(EVENT_TYPE_HEADER "${OUTPUT_DIR}/event_types.hpp")
 set(EVENT_BABELTRACE_CONFIG "${OUTPUT_DIR}/metadata")
+set(EVENT_GENERATE_STAMP "${CMAKE_CURRENT_BINARY_DIR}/event_generate.stamp")
+
+# One event_types_<yaml name>.hpp per YAML file (group).
+set(EVENT_GROUP_HEADERS "")
+foreach(yaml ${INPUT_YAML})
+    get_filename_component(group "${yaml}" NAME_WLE)
+    string(MAKE_C_IDENTIFIER "${group}" group)
+    list(APPEND EVENT_GROUP_HEADERS "${OUTPUT_DIR}/event_types_${group}.hpp")
+endforeach()
 
-# Custom command to run the Python script
+# Custom command to run the Python script.  The generator only rewrites
+# the outputs whose content changed, the stamp records the last run.
 add_custom_command(
-    OUTPUT "${EVENT_TYPE_HEADER}" "${EVENT_BABELTRACE_CONFIG}"
+    OUTPUT "${EVENT_GENERATE_STAMP}"
+    BYPRODUCTS "${EVENT_TYPE_HEADER}" "${EVENT_BABELTRACE_CONFIG}"
+               "${OUTPUT_DIR}/event_streams.hpp" "${OUTPUT_DIR}/event_registry.hpp"
+               ${EVENT_GROUP_HEADERS}
     COMMAND ${CMAKE_COMMAND} -E make_directory "${OUTPUT_DIR}"
     COMMAND ${Python3_EXECUTABLE} "${CMAKE_CURRENT_LIST_DIR}/../tools/event_generate.py"
-            "${INPUT_YAML}" "${OUTPUT_DIR}"
-    DEPENDS "${INPUT_YAML}" "${CMAKE_CURRENT_LIST_DIR}/../tools/event_generate.py"
+            ${EVENT_GENERATE_LAYOUT} ${INPUT_YAML} "${OUTPUT_DIR}"
+    COMMAND ${CMAKE_COMMAND} -E touch "${EVENT_GENERATE_STAMP}"
+    DEPENDS ${INPUT_YAML} "${CMAKE_CURRENT_LIST_DIR}/../tools/event_generate.py"
+            "${CMAKE_CURRENT_BINARY_DIR}/genHdr/config.hpp"
     COMMENT "Running Python tool to generate header and config"
     VERBATIM
 )
 
 # Add a target that depends on generated files
 add_custom_target(generate_config
-    DEPENDS "${EVENT_TYPE_HEADER}" "${EVENT_BABELTRACE_CONFIG}"
+    DEPENDS "${EVENT_GENERATE_STAMP}"
 )
+
+# ------------------------------------------------------------
+# event_log_strings(<target>)
+#
+# Post-link step: extract the EVT_LOG format strings of <target>
+# into `log_strings.yml` next to the generated metadata.
+# ------------------------------------------------------------
+function(event_log_strings target)
+    find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+    if (EXISTS "${EVENT_GENERATED_OUT_DIR}")
+        set(LOG_STRINGS_DIR "${EVENT_GENERATED_OUT_DIR}")
+    else ()
+        set(LOG_STRINGS_DIR "${CMAKE_CURRENT_BINARY_DIR}")
+    endif ()
+
+    add_custom_command(TARGET ${target} POST_BUILD
+        COMMAND ${Python3_EXECUTABLE} "${CMAKE_CURRENT_FUNCTION_LIST_DIR}/../tools/event_log_strings.py"
+                extract "$<TARGET_FILE:${target}>" "${LOG_STRINGS_DIR}/log_strings.yml"
+        COMMENT "Extracting EVT_LOG format strings of ${target}"
+        VERBATIM
+    )
+endfunction()
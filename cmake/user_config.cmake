@@ -2,3 +2,4 @@
 set(MAX_EVENT_SIZE 64 CACHE STRING "Maximum size of event allowed")
 set(MAX_EVENT_PER_PACKET 10 CACHE STRING "Maximum event count store in single packet")
 set(MAX_PACKETS 3 CACHE STRING "Maximum number of packet supported by system")
+set(EVENT_ALIGNED_LAYOUT OFF CACHE BOOL "Naturally aligned event fields instead of packed ones")
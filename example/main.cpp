@@ -1,10 +1,13 @@
 // SPDX-License-Identifier: MIT | Author: Rohit Patil
 
-#include <fstream>
+#include <ctime>
 #include <iostream>
 #include <thread>
 
+#include <eventLog.hpp>
+#include <event_registry.hpp>
 #include <examplePlatform.hpp>
+#include <posix/eventFileSink.hpp>
 
 using namespace std;
 
@@ -17,6 +20,32 @@ using namespace std;
  */
 static TestPlatform g_pltf;
 
+/*
+ * Driver events go to their own collector instance: a separate, smaller
+ * packet budget and its own locks, so a chatty driver cannot starve the
+ * main stream.  32 byte events, 4 events per packet, 2 packets.
+ *
+ * The driver stream declares packet context fields (driver.yml): the
+ * platform fills them once per packet instead of in every event.
+ */
+class driverPlatform : public eventPlatformRef {
+	uint32_t bootId = static_cast<uint32_t>( time( nullptr ) );
+
+public:
+	using eventPlatformRef::eventPlatformRef;
+
+	void getPacketContext( driver_context_t &ctx ) {
+		ctx.cpu_id	= 0;
+		ctx.boot_id = bootId;
+	}
+};
+
+typedef basicEventCollector<driverPlatform, eventConfig<32, 4, 2, 1, driver_context_t>>
+	driverCollector_t;
+
+static TestPlatform g_drvPltf;
+static driverCollector_t g_drvCollector{ driverPlatform( &g_drvPltf ) };
+
 /*
  * Demonstrates posting an event that carries an array of numbers.
  *
@@ -48,7 +77,8 @@ void event_array_example() {
  *
  * Each event carries an incrementing counter (type `loopCount_t`).
  * The function can be used to stress‑test timing or performance
- * characteristics of the collector.
+ * characteristics of the collector.  The loop itself is timed by a
+ * scope event (`loopSpan`).
  */
 void event_loop_index( uint32_t maxLoopCount ) {
 	uint32_t idx = 0;
@@ -59,6 +89,10 @@ void event_loop_index( uint32_t maxLoopCount ) {
 	/* Retrieve the singleton instance of the collector. */
 	inst = eventCollector::getInstance();
 
+	/* One span event covering the whole loop, emitted at scope exit. */
+	loopSpan_scope_t span;
+	span.getParam()->iterations = maxLoopCount;
+
 	param = evt.getParam();
 	for ( idx = 0; idx < maxLoopCount; idx++ ) {
 		/* Update the counter and push the event. */
@@ -68,40 +102,86 @@ void event_loop_index( uint32_t maxLoopCount ) {
 }
 
 /*
- * Dumps all packets collected so far into a binary file.
+ * Posts sensor samples with encoded fields (example.yml): the sequence
+ * number as a delta to the previous sample, the signed level and the
+ * length in as few bytes as their value needs.
+ */
+void event_sample_example() {
+	eventCollector *inst = eventCollector::getInstance();
+
+	for ( uint32_t i = 0; i < 6; i++ ) {
+		auto evt = sensorSample_event( 70000 + i, static_cast<int16_t>( ( i % 2 ) ? -3 : 300 ),
+									   static_cast<uint16_t>( i ), { 0xA5, static_cast<uint8_t>( i ) } );
+		inst->pushEvent( &evt );
+	}
+}
+
+/*
+ * Posts printf style messages.
  *
- * The function forces the collector to flush its buffers, then
- * repeatedly retrieves packets via `getSendPacket()`.  Each packet
- * is written to the supplied output stream and marked as sent
- * using `sendPacketCompleted()`.
+ * Only the interned string id and the arguments are stored in the
+ * packet; the text is restored on host from `log_strings.yml`.
  */
-bool dumpFile( string_view filePath ) {
-	ofstream ofs( filePath.data(), ios::binary );
-	eventCollector *inst = nullptr;
+void event_log_example() {
+	EVT_LOG( "example started" );
+	EVT_LOG( "loop done count %u last %d", 10u, -1 );
+}
 
-	if ( !ofs ) {
-		cerr << "Failed to open file.\n";
-		return false;
+/*
+ * Posts interrupt events on the driver stream.
+ */
+void event_driver_example() {
+	Event<driverIrq_t> evt;
+
+	for ( uint16_t line = 0; line < 6; line++ ) {
+		evt.getParam()->line   = line;
+		evt.getParam()->status = 0;
+		g_drvCollector.pushEvent( &evt );
 	}
 
-	/* Retrieve the singleton instance of the collector. */
-	inst = eventCollector::getInstance();
+	/* From here on only failed IRQs are captured (`where` in driver.yml). */
+	EventWhere<driverIrq_t>::enable( true );
+
+	/* A burst of IRQs: one clock read and one lock for the whole batch. */
+	g_drvCollector.pushEvents( driverIrq_event( 7, 1 ), driverIrq_event( 8, 0 ),
+							   driverIrq_event( 9, 2 ) );
 
-	/* Flush pending data so that packets are available for export. */
-	inst->forceSync();
-	auto pkt = inst->getSendPacket();
+	EVT_LOG_TO( &g_drvCollector, "driver irq lines %u", 6u );
+}
 
-	/* Write all available packets to the file. */
-	while ( pkt.has_value() ) {
-		auto data = pkt.value();
-		ofs.write( reinterpret_cast<const char *>( data.data() ), data.size() );
-		inst->sendPacketCompleted(); // Mark packet as transmitted.
-		pkt = inst->getSendPacket(); // Get next packet, if any.
+/*
+ * The generated registry describes every event of the catalog with a dense
+ * index; it matches the generated types at compile time.
+ */
+static_assert( eventRegistry::events[ eventRegistry::indexOf( EVENT_STREAM_ID_DRIVER,
+															  EventId<driverIrq_t>::value ) ]
+				   .size == sizeof( driverIrq_t ) );
+
+void event_registry_example() {
+	for ( const eventInfo &info : eventRegistry::events ) {
+		cout << "stream " << info.streamId << " event " << info.id << " " << info.name << ": "
+			 << info.size << " bytes, " << info.fieldCount << " fields" << endl;
 	}
+}
 
-	ofs.close();
+/*
+ * Exports all packets collected so far as a CTF trace directory:
+ * `trace/metadata` plus one file per stream, readable by babeltrace2.
+ *
+ * Each collector is flushed first, then the sink drains its ready
+ * packets (`getSendPacket()` / `sendPacketCompleted()`).
+ */
+template <typename... Collector> bool dumpTrace( const char *dirPath, Collector *...inst ) {
+	eventFileSink sink;
 
-	return true;
+	if ( !sink.open( { .directory = dirPath, .metadataPath = EVENT_METADATA_PATH } ) ) {
+		cerr << "Failed to create trace directory.\n";
+		return false;
+	}
+
+	( ( inst->forceSync(), sink.drain( *inst ) ), ... );
+
+	return sink.close();
 }
 
 int main() {
@@ -109,15 +189,21 @@ int main() {
 
 	/* Initialise the collector with a stream ID and platform interface. */
 	inst = eventCollector::getInstance();
-	inst->setStreamId( EVENT_STREAM_ID );
+	inst->setStreamId( EVENT_STREAM_ID_MAIN );
 	inst->setPlatformIntf( &g_pltf );
 
+	g_drvCollector.setStreamId( EVENT_STREAM_ID_DRIVER );
+
 	/* Generate sample events. */
+	event_log_example();
 	event_loop_index( 10 );
 	event_array_example();
+	event_sample_example();
+	event_driver_example();
+	event_registry_example();
 
-	/* Export the collected data to a file. */
-	if ( !dumpFile( "stream.bin" ) ) {
+	/* Export the collected data, one file per stream. */
+	if ( !dumpTrace( "trace", inst, &g_drvCollector ) ) {
 		cerr << "Stream is not captured " << endl;
 		return -1;
 	}
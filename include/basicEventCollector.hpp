@@ -0,0 +1,532 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <event.hpp>
+#include <eventConfig.hpp>
+#include <eventEncoding.hpp>
+#include <eventPacketStore.hpp>
+#include <eventShed.hpp>
+#include <eventTransport.hpp>
+#include <eventWhere.hpp>
+#include <internal/eventPacket.hpp>
+
+/* --------------------------------------------------------------------------
+ *  Concept: EventPlatformPolicy
+ *
+ *  Clock and lock policy of a collector.  Same operations as the virtual
+ *  `eventPlatform` interface, but resolved at compile time so they can be
+ *  inlined (e.g. a cycle counter read or an interrupt mask).
+ * -------------------------------------------------------------------------- */
+template <typename P>
+concept EventPlatformPolicy = requires( P p ) {
+	{ p.getTimestamp() } -> std::same_as<uint64_t>;
+	{ p.eventTryLock() } -> std::same_as<bool>;
+	{ p.eventUnlock() } -> std::same_as<void>;
+	{ p.packetLock() } -> std::same_as<void>;
+	{ p.packetUnlock() } -> std::same_as<void>;
+};
+
+/* --------------------------------------------------------------------------
+ *  Execution levels (optional platform extension)
+ *
+ *  A platform pushing events from interrupt handlers declares its nesting
+ *  levels:
+ *
+ *      static constexpr std::size_t execLevelCount = 3; // thread, IRQ, NMI
+ *      std::size_t getExecLevel();                      // 0 = thread
+ *
+ *  A level only preempts lower ones and runs to completion before they
+ *  resume.  Each level then builds its own packet: an interrupt taken in
+ *  the middle of an event copy logs into its packet instead of dropping,
+ *  and levels above 0 take no event lock.  packetLock() is still taken on
+ *  a packet switch and must mask every level pushing events.
+ * -------------------------------------------------------------------------- */
+template <EventPlatformPolicy P> inline constexpr std::size_t eventPlatformExecLevels = 1;
+
+template <EventPlatformPolicy P>
+	requires requires( P p ) {
+		{ P::execLevelCount } -> std::convertible_to<std::size_t>;
+		{ p.getExecLevel() } -> std::convertible_to<std::size_t>;
+	}
+inline constexpr std::size_t eventPlatformExecLevels<P> = P::execLevelCount;
+
+/* --------------------------------------------------------------------------
+ *  Drain wake hook (optional platform extension)
+ *
+ *  A platform that can park a thread declares:
+ *
+ *      void drainWait( uint64_t timeoutTicks ); // park, 0 = no timeout
+ *      void drainWake();                        // unpark the drain
+ *
+ *  e.g. an eventfd or futex on Linux, a binary semaphore on an RTOS.  A
+ *  wake given before the wait must not be lost, and an early return is
+ *  harmless.  drainWake() is only called on a packet switch while the
+ *  drain is parked in waitForPackets(), from the level that queued the
+ *  packet, so it must be safe in every level that pushes events.
+ * -------------------------------------------------------------------------- */
+template <typename P>
+concept EventPlatformDrainWake = requires( P p, uint64_t timeoutTicks ) {
+	{ p.drainWait( timeoutTicks ) } -> std::same_as<void>;
+	{ p.drainWake() } -> std::same_as<void>;
+};
+
+/* --------------------------------------------------------------------------
+ *  Elapsed clock ticks as the `duration` of a scope event (eventScope.hpp),
+ *  saturated to 32 bits.
+ * -------------------------------------------------------------------------- */
+constexpr uint32_t eventScopeDuration( uint64_t elapsed ) {
+	return ( elapsed > std::numeric_limits<uint32_t>::max() ) ? std::numeric_limits<uint32_t>::max()
+															  : static_cast<uint32_t>( elapsed );
+}
+
+/* --------------------------------------------------------------------------
+ *  Basic Event Collector
+ *
+ *  Collects events into packets.  Clock, locks (`Platform`), buffer
+ *  sizes (`Config`) and packet storage (`Store`) are compile time
+ *  policies.  By default the packet pool and the ready queue are owned by
+ *  the instance so no dynamic allocation happens.
+ *  The collector keeps three kinds of packet pointers:
+ *
+ *      - levels[].curr : packet currently being built, one per execution
+ *                        level
+ *      - nextPkt       : packet pre-armed by the drain side, switched in
+ *                        when a current packet closes
+ *      - sendPkt       : packet that has been finished and is ready for
+ *                        sending
+ * -------------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config,
+		  EventPacketStorePolicy Store = eventPacketStore<Config>>
+class basicEventCollector {
+public:
+	typedef basicEventPacket<Config> packet_t;
+
+	static_assert( std::is_same_v<typename Store::packet_t, packet_t>,
+				   "packet store built for another configuration" );
+
+	typedef typename packet_t::context_t context_t;
+
+	static_assert( std::is_empty_v<context_t> ||
+					   requires( Platform p, context_t &ctx ) { p.getPacketContext( ctx ); },
+				   "a stream with packet context needs Platform::getPacketContext( context_t & )" );
+
+	/* Nesting execution levels, each with its own current packet. */
+	static constexpr std::size_t execLevelMax = eventPlatformExecLevels<Platform>;
+
+	static_assert( execLevelMax > 0, "at least the thread level is needed" );
+
+	/* Packets a transport may be sending at once. */
+	static constexpr std::size_t inFlightMax = eventConfigInFlight<Config>;
+
+	static_assert( inFlightMax > 0 && inFlightMax <= Config::packetCountMax && inFlightMax <= 256,
+				   "in flight packets must fit in the pool and in a token" );
+
+	/* Consumers that may read the same packets (fan-out). */
+	static constexpr std::size_t consumerMax = eventConfigConsumers<Config>;
+
+	static_assert( consumerMax > 0 && consumerMax < 256, "consumer references must fit in a byte" );
+
+	/* Encoded event types with a delta state per level. */
+	static constexpr std::size_t encodedTypesMax = eventConfigEncodedTypes<Config>;
+
+private:
+	/* ----------------------------------------------------------------------
+	 *  Platform policy
+	 *
+	 *  The collector delegates timestamp and locking to this object.
+	 * ---------------------------------------------------------------------- */
+	[[no_unique_address]] Platform pltf;
+
+	/* ----------------------------------------------------------------------
+	 *  Packet storage
+	 *
+	 *  Pool of packet objects and queue of packets ready for transmission.
+	 *  The queue capacity matches the pool size so insertion never fails.
+	 * ---------------------------------------------------------------------- */
+	Store store;
+
+	/* ----------------------------------------------------------------------
+	 *  Packet bookkeeping
+	 *
+	 *  Packet pointers maintained:
+	 *      - levels[].curr: the packet being populated by a level
+	 *      - nextPkt: allocated and cleared ahead, becomes a current
+	 *                 packet (packetLock)
+	 *      - sendPkt: the packet that is in progress to send out.
+	 *
+	 *  The packets of a level form their own sequence (packet_seq_count)
+	 *  and time range; drain them to one file per level.
+	 * ---------------------------------------------------------------------- */
+	typedef struct {
+		packet_t *curr;		// packet being populated by this level
+		uint32_t seqNo;		// sequence number of the next packet of this level
+		uint32_t discarded; // events dropped because no packet was available
+		bool busy;			// inside a push, written by this level only
+
+		// encoder state of each encoded type, indexed by eventEncodeSlot<T>()
+		std::array<std::array<std::byte, EventEncodeStateBytesMax>, encodedTypesMax> encode;
+	} level_t;
+
+	std::array<level_t, execLevelMax> levels;
+	packet_t *nextPkt;
+	packet_t *sendPkt;
+
+	uint32_t streamId; // identifier that will be embedded in each packet header.
+
+	/* ----------------------------------------------------------------------
+	 *  Transport (push mode)
+	 *
+	 *  One slot per packet handed to the transport.  The token given to
+	 *  the driver is ( gen << 8 ) | slot, so a completion arriving after
+	 *  the ack timeout reused the slot is recognised and ignored.
+	 * ---------------------------------------------------------------------- */
+	typedef struct {
+		packet_t *pkt;	   // packet owned by the slot, nullptr when free
+		uint64_t submitTs; // time of the accepted submit, for the ack timeout
+		uint32_t gen;	   // bumped each time the slot is freed
+		bool submitted;	   // accepted by the transport
+	} inFlight_t;
+
+	eventTransport *transport;
+	uint64_t ackTimeout;	  // clock ticks, 0 = wait forever
+	uint32_t ackTimeoutCount; // packets dropped on ack timeout
+	std::array<inFlight_t, inFlightMax> inFlight;
+
+	/* ----------------------------------------------------------------------
+	 *  Load shedding (see eventShed.hpp)
+	 *
+	 *  The level is written under packetLock when a packet is queued or
+	 *  released, read with a relaxed load by the pushes of events of non
+	 *  zero verbosity.  `shedLast` is the marker of the last change, not
+	 *  yet in the trace while `shedPending` is set.
+	 * ---------------------------------------------------------------------- */
+	eventShedConfig shedCfg;
+	std::atomic<uint8_t> shedLevel;
+	std::atomic<bool> shedPending;
+	eventShedMarker shedLast;
+
+	/* moves the shed level one step on the watermarks.  Caller holds packetLock. */
+	void shedUpdate();
+
+	/* records a level change for the marker.  Caller holds packetLock. */
+	void shedSet( uint8_t level, std::size_t ready, std::size_t used );
+
+	/* pushes the marker of a pending level change, stamped like the event following it. */
+	void shedMarkerFlush( const uint64_t *ts );
+
+	/* ----------------------------------------------------------------------
+	 *  Drain wait (see EventPlatformDrainWake)
+	 *
+	 *  Set by waitForPackets() under packetLock before it parks; the
+	 *  packet switch reaching `drainMin` ready packets clears `drainParked`
+	 *  and wakes the drain once.
+	 * ---------------------------------------------------------------------- */
+	std::size_t drainMin;
+	bool drainParked;
+
+	/* true when the parked drain is due a wake.  Caller holds packetLock. */
+	bool drainDue();
+
+	/* wakes the parked drain, after packetLock is released. */
+	void drainWake();
+
+	/* closes the packets of every level for a drain on level 0. */
+	void drainFlush();
+
+	/* ----------------------------------------------------------------------
+	 *  Consumers (fan-out)
+	 *
+	 *  Ready packets move from the store into `fanPkt`, a ring indexed by
+	 *  sequence number.  Each consumer reads the ring from its own cursor.
+	 *  The references are kept per packet in `fanRefPkt` / `fanRefs`, not
+	 *  per ring slot: a held packet may fall out of the ring.  The last
+	 *  reference returns the packet to the pool.  Guarded by packetLock.
+	 * ---------------------------------------------------------------------- */
+	typedef struct {
+		packet_t *held;	 // packet returned by getSendPacket( id ), not completed
+		uint64_t cursor; // sequence of the next packet to read
+		uint32_t lagMax;  // 0: lossless, otherwise packets kept behind the head
+		uint32_t lost;	  // packets skipped while lagging
+		bool active;
+	} consumer_t;
+
+	std::array<consumer_t, consumerMax> consumers;
+	std::array<packet_t *, Config::packetCountMax> fanPkt;
+	std::array<packet_t *, Config::packetCountMax> fanRefPkt; // referenced packets
+	std::array<uint8_t, Config::packetCountMax> fanRefs;	  // their references, 0: entry free
+	uint64_t fanHead; // sequence of the next packet entering the ring
+
+	/* moves the ready packets into the ring, lossy consumers skip ahead.  Caller holds packetLock. */
+	void fanPump();
+
+	/* drops one reference of a packet.  Caller holds packetLock. */
+	void fanUnref( packet_t *pkt );
+
+	/* hands ready packets to free transport slots. */
+	void transportPump();
+
+	/* returns the packet of a slot to the pool, under packetLock. */
+	void transportFree( inFlight_t &slot );
+
+	/* level of the caller, 0 without nesting levels */
+	std::size_t execLevel();
+
+	/* marks the level inside a push, takes the event lock on level 0 */
+	bool levelEnter( std::size_t level );
+	void levelExit( std::size_t level );
+
+	/* lazily creates or re‑uses a packet for writing. */
+	packet_t *getCurrentPacket( std::size_t level );
+
+	/* hands the current packet to send-Q and switches to the pre-armed one */
+	void sendPacket( std::size_t level );
+
+	/* closes the packet of another level not inside a push */
+	void flushLevel( std::size_t level );
+
+	/* allocates and clears nextPkt, drain side */
+	void armNextPacket();
+
+	/* writes the platform context into a packet being started */
+	void stampContext( packet_t *pkt );
+
+	/* serialises an event into the current packet.  A null `ts` stamps the
+	 * event with the platform clock, otherwise the given value is used.
+	 * With `scopeStart` the payload `duration` is the time since then.
+	 * Returns false when the event was filtered, shed or dropped. */
+	template <IsEventType E> bool sendEvent( E *evt, const uint64_t *ts, const uint64_t *scopeStart = nullptr );
+
+	/* adds an event to the packet of `level`, through the generated encoder
+	 * when its payload has encoded fields (see eventEncoding.hpp).  An
+	 * encoded type beyond `encodedTypesMax` is dropped. */
+	template <IsEventType E> void packetAdd( packet_t *pkt, E *evt, std::size_t level );
+
+	/* State of one batch: level, packet in use, event lock held for it. */
+	typedef struct {
+		std::size_t level;
+		packet_t *curr;
+		bool locked;
+		bool refused;	// event lock busy, drop the batch
+		bool exhausted; // no packet available, drop the rest
+	} batch_t;
+
+	/* adds one event of a batch, switches packet when it fills. */
+	template <IsEventType E> void batchAdd( batch_t &batch, E *evt, uint64_t ts );
+	void batchEnd( batch_t &batch );
+
+protected:
+	/* Access to the platform policy for derived collectors. */
+	Platform &platform() noexcept { return pltf; }
+
+public:
+	explicit basicEventCollector( const Platform &_pltf = Platform() );
+
+	/* Collector on an external packet store (e.g. shared memory). */
+	basicEventCollector( const Platform &_pltf, const Store &_store );
+
+	basicEventCollector( const basicEventCollector & )			  = delete;
+	basicEventCollector &operator=( const basicEventCollector & ) = delete;
+
+	/* ----------------------------------------------------------------------
+	 *  Event submission
+	 *
+	 *  The template accepts any type that satisfies the `IsEventType`
+	 *  concept.  The concrete type is kept, so serialisation is not a
+	 *  virtual call.  An event rejected by its enabled capture predicate
+	 *  (see eventWhere.hpp) or shed by the load controller (eventShed.hpp)
+	 *  is left out before the clock is read.
+	 * ---------------------------------------------------------------------- */
+	template <IsEventType E> inline void pushEvent( E *ptr ) { sendEvent( ptr, nullptr ); }
+
+	/* Same as above with a timestamp already read by the caller. */
+	template <IsEventType E> inline void pushEvent( E *ptr, uint64_t ts ) {
+		sendEvent( ptr, &ts );
+	}
+
+	/* Scope event (eventScope.hpp): the exit time is read under the event
+	 * lock and written both as the timestamp and as the `duration` since
+	 * `startTs`, so a push preempting the exit is never stamped later
+	 * while landing ahead of it. */
+	template <IsEventType E>
+		requires std::same_as<decltype( std::declval<typename E::param_t>().duration ), uint32_t>
+	inline void pushScopeEvent( E *ptr, uint64_t startTs ) {
+		sendEvent( ptr, nullptr, &startTs );
+	}
+
+	/* ----------------------------------------------------------------------
+	 *  Batch submission
+	 *
+	 *  A burst of events with one clock read and one event lock for the
+	 *  batch instead of per event; a full packet is switched once for the
+	 *  batch.
+	 *
+	 *      ec.pushEvents( &evtA, &evtB, &evtC );               // same timestamp
+	 *      ec.pushEvents( loopCount_event( 1 ), driverIrq_event( 4, 0 ) );
+	 *      ec.pushEvents( std::span( samples ), deltas );        // base + deltas[i]
+	 *
+	 *  The `<name>_event()` helpers are generated in event_types.hpp.
+	 * ---------------------------------------------------------------------- */
+	template <IsEventType... E> void pushEvents( E *...evts ) {
+		batch_t batch = {};
+		uint64_t ts	  = 0;
+
+		shedMarkerFlush( nullptr );
+		ts = pltf.getTimestamp();
+
+		batch.level = execLevel();
+		( batchAdd( batch, evts, ts ), ... );
+		batchEnd( batch );
+	}
+
+	/* Same as above for events built in place (temporaries). */
+	template <typename... E>
+		requires( IsEventType<std::remove_cvref_t<E>> && ... )
+	void pushEvents( E &&...evts ) {
+		pushEvents( &evts... );
+	}
+
+	/* Homogeneous burst; event i is stamped with the batch clock read plus
+	 * `deltas[ i ]` (non decreasing, platform clock ticks) when given. */
+	template <IsEventType E, std::size_t Extent>
+	void pushEvents( std::span<E, Extent> evts, std::span<const uint32_t> deltas = {} );
+
+	/* Current platform clock, same time base as the event timestamps. */
+	uint64_t getTimestamp() { return pltf.getTimestamp(); }
+
+	/* ----------------------------------------------------------------------
+	 *  Packet retrieval
+	 *
+	 *  If a packet has been queued for transmission, this returns a span over
+	 *  its raw bytes.  The caller is responsible for handling the data and
+	 *  then notifying the collector that sending is finished.
+	 * ---------------------------------------------------------------------- */
+	std::optional<std::span<const std::byte>> getSendPacket();
+	void sendPacketCompleted(); // Notify that the platform has finished sending `sendPkt`
+
+	/* ----------------------------------------------------------------------
+	 *  Blocking drain
+	 *
+	 *  Parks the calling thread until `minCount` packets are ready or
+	 *  `timeoutTicks` (clock ticks, 0 = no timeout) elapse.  On timeout
+	 *  the packets being built are closed, so a quiet system still drains.
+	 *  Returns the ready packets.  Producers never call the platform on
+	 *  an event; the packet switch that reaches the watermark wakes the
+	 *  drain once.  Needs a platform with the drain wake hook and a store
+	 *  reporting its occupancy.
+	 *
+	 *      while ( running ) {
+	 *          ec.waitForPackets( 4, flushTicks );
+	 *          sink.drain( ec );
+	 *      }
+	 * ---------------------------------------------------------------------- */
+	std::size_t waitForPackets( std::size_t minCount, uint64_t timeoutTicks )
+		requires EventPlatformDrainWake<Platform> && EventPacketStoreOccupancy<Store>;
+
+	/* ----------------------------------------------------------------------
+	 *  Consumers (fan-out)
+	 *
+	 *  Several sinks read the same packets without a copy, e.g. a crash
+	 *  ring file and the live link:
+	 *
+	 *      auto file = ec.addConsumer();         // lossless
+	 *      auto link = ec.addConsumer( 4 );      // lossy, at most 4 behind
+	 *      ...
+	 *      auto pkt = ec.getSendPacket( *link );
+	 *      ...
+	 *      ec.sendPacketCompleted( *link );
+	 *
+	 *  A packet returns to the pool once every consumer completed it.  A
+	 *  lossy consumer more than `lagMax` packets behind skips the oldest
+	 *  ones instead of stalling the others (getConsumerLost()).  The first
+	 *  consumer also gets the packets already queued, a later one those
+	 *  queued after it was added.  Do not mix with getSendPacket() or a
+	 *  transport.
+	 * ---------------------------------------------------------------------- */
+	std::optional<std::size_t> addConsumer( uint32_t lagMax = 0 );
+	void removeConsumer( std::size_t id );
+	std::optional<std::span<const std::byte>> getSendPacket( std::size_t id );
+	void sendPacketCompleted( std::size_t id );
+
+	/* Packets a lossy consumer skipped. */
+	uint32_t getConsumerLost( std::size_t id ) const { return consumers[ id ].lost; }
+
+	/* Execution level that built the packet returned by getSendPacket(). */
+	std::size_t getSendPacketLevel() const { return sendPkt != nullptr ? sendPkt->getExecLevel() : 0; }
+
+	/* Same as above for the packet returned by getSendPacket( id ). */
+	std::size_t getSendPacketLevel( std::size_t id ) const {
+		return consumers[ id ].held != nullptr ? consumers[ id ].held->getExecLevel() : 0;
+	}
+
+	/* --------------------------------------------------------------------
+	 *  If system stuck and not generating enough event to push packet for send.
+	 *  In such scenario, call this API, this will force current packet to send
+	 *  all collected event.  With nesting levels the packets of the other
+	 *  levels are closed too, except a lower level interrupted in a push.
+	 * -------------------------------------------------------------------- */
+	void forceSync( void );
+
+	/* --------------------------------------------------------------------
+	 *  The platform context (task, cpu...) changed: the current packet is
+	 *  closed so following events go to a packet carrying the new context.
+	 *  Call from the task switch hook when several contexts share a
+	 *  collector; with one collector per thread it is never needed.
+	 * -------------------------------------------------------------------- */
+	void contextChanged( void );
+
+	/* ----------------------------------------------------------------------
+	 *  Transport (push mode)
+	 *
+	 *  setTransport       – attach a driver; `ackTimeoutTicks` in clock
+	 *                       ticks, 0 disables the timeout.  Do not mix with
+	 *                       getSendPacket().
+	 *  transportComplete  – driver callback, the packet of `token` is sent.
+	 *  transportPoll      – call periodically and on eventTransport::ready():
+	 *                       submits queued packets, applies the ack timeout
+	 *                       and retries packets the driver refused.
+	 * ---------------------------------------------------------------------- */
+	void setTransport( eventTransport *_transport, uint64_t ackTimeoutTicks = 0 );
+	void transportComplete( uint32_t token );
+	void transportPoll( void );
+
+	/* Number of packets dropped because the transport did not complete them in time. */
+	uint32_t getAckTimeoutCount() const { return ackTimeoutCount; }
+
+	/* ----------------------------------------------------------------------
+	 *  Load shedding
+	 *
+	 *  setLoadShedding – watermarks of the controller; `levelMax` 0 turns
+	 *                    it off and captures everything again.  Needs a
+	 *                    store reporting its occupancy.
+	 *  getShedLevel    – current level, 0 when every event is captured.
+	 * ---------------------------------------------------------------------- */
+	void setLoadShedding( const eventShedConfig &cfg );
+	uint8_t getShedLevel() const { return shedLevel.load( std::memory_order_relaxed ); }
+
+	/* ----------------------------------------------------------------------
+	 *  Configuration helpers
+	 *
+	 *  streamId – sets the identifier that will be embedded in every packet.
+	 * ---------------------------------------------------------------------- */
+	void setStreamId( uint32_t _streamId );
+};
+
+// include template implementation
+#include <internal/basicEventCollector.tpp>
@@ -7,6 +7,7 @@
  * -------------------------------------------------------------------------- */
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <span>
 #include <type_traits>
 
@@ -32,6 +33,31 @@ concept EventMemCopyable =
 	std::is_standard_layout_v<T> && std::is_trivially_copyable_v<T> && std::is_aggregate_v<T> &&
 	!std::is_polymorphic_v<T> && sizeof( T ) <= CONFIG_EVENT_SIZE_MAX;
 
+/* --------------------------------------------------------------------------
+ *  Event layout
+ *
+ *  By default events are packed: a 12 byte header (id, timestamp) then the
+ *  payload fields, one event right after the other.  With
+ *  CONFIG_EVENT_ALIGNED every field sits on its natural boundary: the
+ *  header is 16 bytes (timestamp at offset 8), every event starts on an
+ *  8 byte boundary of the packet and the generator orders payload fields
+ *  by decreasing size.  The CTF metadata carries the matching `align`.
+ * -------------------------------------------------------------------------- */
+#if CONFIG_EVENT_ALIGNED
+#define EVENT_LAYOUT_PACKED
+#else
+#define EVENT_LAYOUT_PACKED __attribute__( ( packed ) )
+#endif
+
+/* Bytes of the event header and boundary every event starts on. */
+inline constexpr std::size_t EventHeaderBytes = CONFIG_EVENT_ALIGNED ? 16 : 12;
+inline constexpr std::size_t EventAlignment	  = CONFIG_EVENT_ALIGNED ? 8 : 1;
+
+/* `bytes` rounded up to the event boundary. */
+constexpr std::size_t eventAlignUp( std::size_t bytes ) {
+	return ( bytes + EventAlignment - 1 ) & ~( EventAlignment - 1 );
+}
+
 /* Forward declaration of EventId.
  *   EventId<T>::value must provide a unique 32‑bit identifier for the payload type T. */
 template <typename T> struct EventId;
@@ -56,19 +82,31 @@ public:
  *  Concrete Event implementation
  *
  *  T must satisfy EventMemCopyable.
- *  The payload structure is packed to avoid any compiler‑added padding.
+ *  The payload structure follows the event layout: packed, or naturally
+ *  aligned with the tail padding left out of the raw view.
  * -------------------------------------------------------------------------- */
 template <EventMemCopyable T> class Event final : public EventIntf {
-	/* Packed event payload that will be serialised as raw bytes. */
-	struct __attribute__( ( packed ) ) EventPayload {
+	/* Event payload that will be serialised as raw bytes. */
+	struct EVENT_LAYOUT_PACKED EventPayload {
 		uint32_t id;
 		uint64_t timestamp;
 		T param;
 	} evtPayload;
 
+	static_assert( offsetof( EventPayload, param ) == EventHeaderBytes );
+
 public:
+	/* Payload type of the event. */
+	typedef T param_t;
+
 	/* Constructor initialises the id field from EventId<T> */
-	Event() { evtPayload.id = EventId<T>::value; }
+	Event() {
+		// Padding of the aligned layout goes on wire, never stale stack data.
+		if constexpr ( CONFIG_EVENT_ALIGNED ) {
+			std::memset( &evtPayload, 0, sizeof( evtPayload ) );
+		}
+		evtPayload.id = EventId<T>::value;
+	}
 	~Event() = default;
 
 	/* Return a pointer to the payload so callers can read/write it. */
@@ -76,11 +114,14 @@ public:
 
 	/* Implement the interface: expose the whole event as a byte span. */
 	std::span<const std::byte> getEventInRaw() {
-		return std::as_bytes( std::span<EventPayload>( &evtPayload, 1 ) );
+		return std::as_bytes( std::span<EventPayload>( &evtPayload, 1 ) ).first( EventHeaderBytes + sizeof( T ) );
 	}
 
-	/* Store the timestamp in the packed payload. */
+	/* Store the timestamp in the payload. */
 	void setTimestamp( uint64_t ts ) { evtPayload.timestamp = ts; }
+
+	/* Timestamp stored by the collector. */
+	uint64_t getTimestamp() const { return evtPayload.timestamp; }
 };
 
 /* --------------------------------------------------------------------------
@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <eventConfig.hpp>
+#include <internal/eventPacket.hpp>
+
+/* --------------------------------------------------------------------------
+ *  Runtime trace memory (arena) and packet size classes
+ *
+ *  With the default store the packet count is fixed at build time.  The
+ *  arena store instead takes its packets from memory handed over at
+ *  startup, so one image adapts its trace budget to the product it runs
+ *  on.  Packet geometry stays a compile time policy: each configuration
+ *  is a size class, and several classes can share one arena.
+ *
+ *      // small packets flush quickly, big packets carry bulk data
+ *      typedef eventConfig<32, 8, 64>    latencyClass;
+ *      typedef eventConfig<64, 128, 16>  throughputClass;
+ *
+ *      eventArena arena( std::span( traceRam, skuTraceBytes() ) );
+ *      auto fast = eventArenaStore<latencyClass>::create( arena, arena.remaining() / 4 );
+ *      auto bulk = eventArenaStore<throughputClass>::create( arena, arena.remaining() );
+ *
+ *      basicEventCollector<plat, latencyClass, eventArenaStore<latencyClass>> ctrl( p, fast );
+ *      basicEventCollector<plat, throughputClass, eventArenaStore<throughputClass>> data( p, bulk );
+ *
+ *  `Config::packetCountMax` caps the packets a class takes from the arena.
+ *  Arena memory is never given back; carve it once at startup.
+ * -------------------------------------------------------------------------- */
+
+/* --------------------------------------------------------------------------
+ *  eventArena – bump allocator over caller supplied memory.
+ * -------------------------------------------------------------------------- */
+class eventArena {
+	std::byte *base	 = nullptr;
+	std::size_t size = 0;
+	std::size_t used = 0;
+
+public:
+	eventArena() = default;
+	explicit eventArena( std::span<std::byte> mem ) : base( mem.data() ), size( mem.size() ) {}
+
+	/* `bytes` aligned on `align`, nullptr when the arena is exhausted. */
+	void *carve( std::size_t bytes, std::size_t align ) {
+		void *ptr		= base + used;
+		std::size_t len = size - used;
+
+		if ( std::align( align, bytes, ptr, len ) == nullptr ) {
+			return nullptr;
+		}
+
+		used = static_cast<std::size_t>( static_cast<std::byte *>( ptr ) - base ) + bytes;
+		return ptr;
+	}
+
+	std::size_t remaining() const noexcept { return size - used; }
+	std::size_t capacity() const noexcept { return size; }
+};
+
+/* --------------------------------------------------------------------------
+ *  eventArenaStore – collector store policy on arena memory.
+ *
+ *  A handle (copied into the collector) on a block carved from the arena:
+ *
+ *      state_t                 packet count, free stack, ready ring
+ *      uint32_t free[count]    indices of the free packets
+ *      uint32_t ready[count]   ring of the packets ready to send
+ *      packet_t packets[count]
+ *
+ *  The ready ring holds one entry per packet so insertion never fails.
+ * -------------------------------------------------------------------------- */
+template <EventCollectorConfig Config> class eventArenaStore {
+public:
+	typedef basicEventPacket<Config> packet_t;
+
+private:
+	typedef struct {
+		uint32_t count;		 // packets of the class
+		uint32_t freeCount;	 // entries on the free stack
+		uint32_t readyHead;	 // oldest ready entry
+		uint32_t readyCount; // entries in the ready ring
+	} state_t;
+
+	state_t *state	  = nullptr;
+	uint32_t *freeIdx = nullptr;
+	uint32_t *ready	  = nullptr;
+	packet_t *packets = nullptr;
+
+	/* Bookkeeping bytes of one packet: free stack and ready ring entries. */
+	static constexpr std::size_t perPacketBytes = sizeof( packet_t ) + 2 * sizeof( uint32_t );
+
+	/* State and worst case alignment padding. */
+	static constexpr std::size_t fixedBytes = alignof( state_t ) + sizeof( state_t ) + alignof( packet_t );
+
+public:
+	eventArenaStore() = default;
+
+	/* Arena bytes needed for `count` packets. */
+	static constexpr std::size_t bytesFor( std::size_t count ) { return fixedBytes + count * perPacketBytes; }
+
+	/* Packets `bytes` of arena memory hold, at most Config::packetCountMax. */
+	static constexpr std::size_t packetsFor( std::size_t bytes ) {
+		std::size_t count = ( bytes > fixedBytes ) ? ( bytes - fixedBytes ) / perPacketBytes : 0;
+
+		return ( count < Config::packetCountMax ) ? count : Config::packetCountMax;
+	}
+
+	/* ----------------------------------------------------------------------
+	 *  Carve as many packets as `bytes` hold from `arena`.  The store is
+	 *  invalid (see valid()) when not even one packet fits; the arena is
+	 *  then left untouched.
+	 * ---------------------------------------------------------------------- */
+	static eventArenaStore create( eventArena &arena, std::size_t bytes ) {
+		eventArenaStore s;
+		std::size_t count = packetsFor( bytes < arena.remaining() ? bytes : arena.remaining() );
+
+		if ( count == 0 ) {
+			return s;
+		}
+
+		s.state	  = static_cast<state_t *>( arena.carve( sizeof( state_t ), alignof( state_t ) ) );
+		s.freeIdx = static_cast<uint32_t *>( arena.carve( count * sizeof( uint32_t ), alignof( uint32_t ) ) );
+		s.ready	  = static_cast<uint32_t *>( arena.carve( count * sizeof( uint32_t ), alignof( uint32_t ) ) );
+		s.packets = static_cast<packet_t *>( arena.carve( count * sizeof( packet_t ), alignof( packet_t ) ) );
+
+		*s.state = { static_cast<uint32_t>( count ), static_cast<uint32_t>( count ), 0, 0 };
+		for ( std::size_t i = 0; i < count; i++ ) {
+			new ( &s.packets[ i ] ) packet_t();
+			// Lowest index on top, handed out first.
+			s.freeIdx[ i ] = static_cast<uint32_t>( count - 1 - i );
+		}
+
+		return s;
+	}
+
+	bool valid() const noexcept { return state != nullptr; }
+	std::size_t packetCount() const noexcept { return valid() ? state->count : 0; }
+
+	/* Take a free packet, nullptr when every packet is in use.  An invalid
+	 * store has no packet: a collector on it drops its events. */
+	packet_t *allocate() {
+		if ( !valid() || state->freeCount == 0 ) {
+			return nullptr;
+		}
+
+		return &packets[ freeIdx[ --state->freeCount ] ];
+	}
+
+	/* Return a sent packet to the arena store. */
+	void release( packet_t *pkt ) {
+		std::size_t idx = indexOf( pkt );
+
+		if ( idx < packetCount() ) {
+			freeIdx[ state->freeCount++ ] = static_cast<uint32_t>( idx );
+		}
+	}
+
+	/* Queue a finished packet for transmission. */
+	bool pushReady( packet_t *pkt ) {
+		std::size_t idx = indexOf( pkt );
+
+		if ( idx >= packetCount() || state->readyCount == state->count ) {
+			return false;
+		}
+
+		ready[ ( state->readyHead + state->readyCount++ ) % state->count ] = static_cast<uint32_t>( idx );
+		return true;
+	}
+
+	/* Oldest packet ready for transmission, nullptr when none. */
+	packet_t *popReady() {
+		packet_t *pkt = nullptr;
+
+		if ( !valid() || state->readyCount == 0 ) {
+			return nullptr;
+		}
+
+		pkt				 = &packets[ ready[ state->readyHead ] ];
+		state->readyHead = ( state->readyHead + 1 ) % state->count;
+		state->readyCount--;
+		return pkt;
+	}
+
+	/* Position independent handle of a packet (packetCount() when foreign). */
+	std::size_t indexOf( const packet_t *pkt ) const {
+		auto idx = static_cast<std::size_t>( pkt - packets );
+
+		return ( idx < packetCount() ) ? idx : packetCount();
+	}
+
+	/* Occupancy, for diagnostics. */
+	std::size_t readyCount() const { return valid() ? state->readyCount : 0; }
+	std::size_t usedCount() const { return valid() ? state->count - state->freeCount : 0; }
+};
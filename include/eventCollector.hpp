@@ -5,20 +5,16 @@
 /* --------------------------------------------------------------------------
  *  Standard library headers
  * -------------------------------------------------------------------------- */
-#include <array>
-#include <cstddef>
+#include <cassert>
 #include <cstdint>
-#include <optional>
-#include <span>
 
 /* --------------------------------------------------------------------------
  *  Project headers
  * -------------------------------------------------------------------------- */
+#include <basicEventCollector.hpp>
 #include <config.hpp>
 #include <event.hpp>
-
-/* Forward declaration – the packet type is defined elsewhere */
-class eventPacket;
+#include <eventConfig.hpp>
 
 /* --------------------------------------------------------------------------
  *  Platform Interface
@@ -47,70 +43,53 @@ public:
 };
 
 /* --------------------------------------------------------------------------
- *  Event Collector
+ *  eventPlatformRef – platform policy forwarding to an `eventPlatform`
  *
- *  `eventCollector` is a singleton that collects events into packets.
- *  It owns an opaque implementation object (`Impl`) stored in a fixed‑size
- *  buffer to avoid dynamic allocation on the critical path.  The collector
- *  keeps two packet pointers:
+ *  Runtime (virtual) platform used by the compatibility collector below.
+ *  Also lets a sized collector instance reuse an `eventPlatform`:
  *
- *      - currPkt : packet currently being built
- *      - sendPkt : packet that has been finished and is ready for sending
+ *      basicEventCollector<eventPlatformRef, eventConfig<32, 8, 2>>
+ *          drvCollector{ eventPlatformRef( &drvPlatform ) };
  * -------------------------------------------------------------------------- */
-class eventCollector {
-	/* ----------------------------------------------------------------------
-	 *  Impl
-	 *
-	 *  The actual implementation details are hidden behind the pointer `impl`.
-	 *  To keep memory usage predictable, the implementation is stored inside
-	 *  a fixed‑size array (`storage`) that is large enough for any expected
-	 *  layout.  The size of this buffer is intentionally small – it can be
-	 *  tuned by changing `ImplSize` if the implementation grows.
-	 * ---------------------------------------------------------------------- */
-	struct Impl;						   // forward declaration
-	static constexpr size_t ImplSize = 48; // bytes reserved for Impl
-	alignas( std::max_align_t ) std::array<std::byte, ImplSize> storage;
+class eventPlatformRef {
+	eventPlatform *pltf = nullptr;
 
-	Impl *impl;
+public:
+	eventPlatformRef() = default;
+	explicit eventPlatformRef( eventPlatform *_pltf ) : pltf( _pltf ) {}
 
-	/* ----------------------------------------------------------------------
-	 *  Platform pointer
-	 *
-	 *  The collector delegates timestamp and locking to this interface.
-	 * ---------------------------------------------------------------------- */
-	eventPlatform *pltf;
+	/* It must only be set once; otherwise a double‑initialisation would corrupt state. */
+	void attach( eventPlatform *_pltf ) {
+		assert( pltf == nullptr );
 
-	/* ----------------------------------------------------------------------
-	 *  Packet bookkeeping
-	 *
-	 *  Two packet pointers are maintained:
-	 *      - currPkt: the packet being populated with events
-	 *      - sendPkt: the packet that is in progress to send out.
-	 * ---------------------------------------------------------------------- */
-	eventPacket *currPkt;
-	eventPacket *sendPkt;
+		pltf = _pltf;
+	}
+
+	uint64_t getTimestamp() { return pltf->getTimestamp(); }
+	bool eventTryLock() { return pltf->eventTryLock(); }
+	void eventUnlock() { pltf->eventUnlock(); }
+	void packetLock() { pltf->packetLock(); }
+	void packetUnlock() { pltf->packetUnlock(); }
+};
 
-	uint32_t
-		discardEventCount; // number of events dropped because the current packet is not available
-	uint32_t pktSqnNo;	   // monotonically increasing sequence number for packets.
-	uint32_t streamId;	   // identifier that will be embedded in each packet header.
+/* The compatibility collector is instantiated once in the library. */
+extern template class basicEventCollector<eventPlatformRef, eventDefaultConfig>;
 
+/* --------------------------------------------------------------------------
+ *  Event Collector
+ *
+ *  `eventCollector` is the process wide singleton built on
+ *  `basicEventCollector` with the virtual `eventPlatform` and the
+ *  configure time limits of config.hpp.  Code that knows its platform at
+ *  compile time can instantiate `basicEventCollector` directly instead.
+ * -------------------------------------------------------------------------- */
+class eventCollector final : public basicEventCollector<eventPlatformRef, eventDefaultConfig> {
 	/* ----------------------------------------------------------------------
 	 *  Private constructor
 	 *
-	 *  The singleton is created on first use via `getInstance()`.  The ctor
-	 *  sets up the Impl object inside the storage buffer.
+	 *  The singleton is created on first use via `getInstance()`.
 	 * ---------------------------------------------------------------------- */
-	eventCollector();
-
-	/* lazily creates or re‑uses a packet for writing. */
-	eventPacket *getCurrentPacket();
-
-	/* finalises the current packet and hands it to send-Q */
-	void sendPacket();
-
-	/* serialises an event into the current packet.*/
-	void sendEvent( EventIntf *evt );
+	eventCollector() = default;
 
 public:
 	/* ----------------------------------------------------------------------
@@ -121,40 +100,9 @@ public:
 	static eventCollector *getInstance() noexcept;
 
 	/* ----------------------------------------------------------------------
-	 *  Event submission
-	 *
-	 *  The template accepts any type that satisfies the `IsEventType`
-	 *  concept.  It simply casts to the base interface and forwards it
-	 *  to `sendEvent()`.
-	 * ---------------------------------------------------------------------- */
-	template <IsEventType E> inline void pushEvent( E *ptr ) {
-		EventIntf *intf = ptr;
-		sendEvent( intf );
-	}
-
-	/* ----------------------------------------------------------------------
-	 *  Packet retrieval
-	 *
-	 *  If a packet has been queued for transmission, this returns a span over
-	 *  its raw bytes.  The caller is responsible for handling the data and
-	 *  then notifying the collector that sending is finished.
-	 * ---------------------------------------------------------------------- */
-	std::optional<std::span<const std::byte>> getSendPacket();
-	void sendPacketCompleted(); // Notify that the platform has finished sending `sendPkt`
-
-	/* --------------------------------------------------------------------
-	 *  If system stuck and not generating enough event to push packet for send.
-	 *  In such scenario, call this API, this will force current packet to send
-	 *  all collected event.
-	 * -------------------------------------------------------------------- */
-	void forceSync( void );
-
-	/* ----------------------------------------------------------------------
-	 *  Configuration helpers
+	 *  Configuration helper
 	 *
-	 *  streamId – sets the identifier that will be embedded in every packet.
-	 *  pltf     – registers the platform interface implementation.
+	 *  pltf – registers the platform interface implementation.
 	 * ---------------------------------------------------------------------- */
-	void setStreamId( uint32_t _streamId );
 	void setPlatformIntf( eventPlatform *_pltf );
 };
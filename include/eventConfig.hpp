@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <concepts>
+#include <cstddef>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <config.hpp>
+
+/* --------------------------------------------------------------------------
+ *  Concept: EventCollectorConfig
+ *
+ *  Compile time buffer-size policy of a collector:
+ *      • eventSizeMax      – maximum size of one raw event in bytes
+ *      • eventMaxPerPacket – maximum event count stored in one packet
+ *      • packetCountMax    – number of packets owned by the collector
+ * -------------------------------------------------------------------------- */
+template <typename C>
+concept EventCollectorConfig = requires {
+	{ C::eventSizeMax } -> std::convertible_to<std::size_t>;
+	{ C::eventMaxPerPacket } -> std::convertible_to<std::size_t>;
+	{ C::packetCountMax } -> std::convertible_to<std::size_t>;
+} && ( C::eventSizeMax > 0 ) && ( C::eventMaxPerPacket > 0 ) && ( C::packetCountMax > 0 );
+
+/* --------------------------------------------------------------------------
+ *  Packet context of a stream without context fields.
+ * -------------------------------------------------------------------------- */
+struct eventNoContext {};
+
+/* --------------------------------------------------------------------------
+ *  eventConfig – buffer-size policy built from plain values.
+ *
+ *  `InFlight` is the number of packets a transport may be sending at once
+ *  (see eventTransport.hpp).  `Context` is the packed struct of packet
+ *  context fields generated for the stream (`<stream>_context_t`), written
+ *  once per packet after the header.
+ * -------------------------------------------------------------------------- */
+template <std::size_t EventSize, std::size_t EventPerPacket, std::size_t PacketCount,
+		  std::size_t InFlight = 1, typename Context = eventNoContext>
+struct eventConfig {
+	static constexpr std::size_t eventSizeMax	   = EventSize;
+	static constexpr std::size_t eventMaxPerPacket = EventPerPacket;
+	static constexpr std::size_t packetCountMax	   = PacketCount;
+	static constexpr std::size_t inFlightMax	   = InFlight;
+
+	typedef Context packetContext_t;
+
+	/* Bytes of event data in one packet (see EVENT_MAX_PAYLOAD_IN_BYTES). */
+	static constexpr std::size_t payloadBytesMax = EventSize * EventPerPacket;
+};
+
+/* In flight packet limit of a config, 1 when it does not define one. */
+template <EventCollectorConfig C> inline constexpr std::size_t eventConfigInFlight = 1;
+
+template <EventCollectorConfig C>
+	requires requires { C::inFlightMax; }
+inline constexpr std::size_t eventConfigInFlight<C> = C::inFlightMax;
+
+/* Packet consumers of a config (fan-out), 2 when it does not define
+ * `consumerMax`. */
+template <EventCollectorConfig C> inline constexpr std::size_t eventConfigConsumers = 2;
+
+template <EventCollectorConfig C>
+	requires requires { C::consumerMax; }
+inline constexpr std::size_t eventConfigConsumers<C> = C::consumerMax;
+
+/* Encoded event types (see eventEncoding.hpp) a collector keeps the
+ * state of, 4 when the config does not define `encodedTypesMax`. */
+template <EventCollectorConfig C> inline constexpr std::size_t eventConfigEncodedTypes = 4;
+
+template <EventCollectorConfig C>
+	requires requires { C::encodedTypesMax; }
+inline constexpr std::size_t eventConfigEncodedTypes<C> = C::encodedTypesMax;
+
+/* Packet context of a config, eventNoContext when it does not define one. */
+template <EventCollectorConfig C> struct eventConfigContext {
+	typedef eventNoContext type;
+};
+
+template <EventCollectorConfig C>
+	requires requires { typename C::packetContext_t; }
+struct eventConfigContext<C> {
+	typedef typename C::packetContext_t type;
+};
+
+/* Policy matching the configure time limits of config.hpp. */
+typedef eventConfig<CONFIG_EVENT_SIZE_MAX, CONFIG_EVENT_MAX_PER_PACKET, CONFIG_PACKET_COUNT_MAX>
+	eventDefaultConfig;
@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/* --------------------------------------------------------------------------
+ *  Field encodings (YAML `encoding`)
+ *
+ *  A scalar field may be written in fewer bytes than its type:
+ *
+ *      params:
+ *        - name: count
+ *          type: uint32_t
+ *          encoding: delta    # difference to the previous event of the type
+ *        - name: len
+ *          type: uint16_t
+ *          encoding: varint   # unsigned value in the fewest bytes
+ *        - name: offset
+ *          type: int32_t
+ *          encoding: zigzag   # signed value in the fewest bytes
+ *
+ *  On wire an encoded field is a width tag (uint8_t: 0, 1, 2 or 4) then
+ *  that many little endian bytes, 0 for a zero value.  `zigzag` and
+ *  `delta` values are signed, so small magnitudes of either sign stay
+ *  short; `delta` is the difference to the same field of the previous
+ *  event of the type in the packet, modulo the field width.  The CTF
+ *  metadata describes the field as a variant selected by the tag, so any
+ *  CTF reader decodes it; tools/trace_index.py rebuilds the delta values.
+ *
+ *  The previous values start at 0 in every packet, a packet decodes on
+ *  its own (lost or reordered packets do not corrupt the next ones).
+ *  Events with an encoded field are written in YAML field order, byte
+ *  packed, in both layouts.
+ *
+ *  The generator writes `EventEncoding<T>` for such payloads; the
+ *  collector serialises them with `encode()` instead of copying the
+ *  payload (see basicEventPacket::addEvent).
+ * -------------------------------------------------------------------------- */
+
+/* Encoder of payload T, specialised by the generator. */
+template <typename T> struct EventEncoding;
+
+/* --------------------------------------------------------------------------
+ *  Concept: EventEncoded – payload with a generated encoder.
+ * -------------------------------------------------------------------------- */
+template <typename T>
+concept EventEncoded = requires( const T &param, typename EventEncoding<T>::state_t &prev, std::byte *out ) {
+	{ EventEncoding<T>::bytesMax } -> std::convertible_to<std::size_t>;
+	{ EventEncoding<T>::encode( param, prev, out ) } -> std::same_as<std::byte *>;
+};
+
+/* --------------------------------------------------------------------------
+ *  Previous values of payload T and the packet (and its reuse) they
+ *  belong to; reset when the event goes to another packet.
+ * -------------------------------------------------------------------------- */
+template <typename T> struct eventEncodeState {
+	const void *packet	= nullptr;
+	uint32_t generation = 0;
+	typename EventEncoding<T>::state_t prev{};
+};
+
+/* --------------------------------------------------------------------------
+ *  Per collector storage of the encoder states.
+ *
+ *  A collector keeps one slot of `EventEncodeStateBytesMax` bytes per
+ *  encoded type and level; `eventEncodeSlot<T>()` numbers the encoded
+ *  types in the order they are first pushed, over the whole program.
+ *  All zero bytes are the initial state.
+ * -------------------------------------------------------------------------- */
+inline constexpr std::size_t EventEncodeStateBytesMax = 32;
+
+inline std::size_t eventEncodeSlotNext() {
+	static std::atomic<std::size_t> next = 0;
+
+	return next.fetch_add( 1, std::memory_order_relaxed );
+}
+
+template <typename T> inline std::size_t eventEncodeSlot() {
+	static const std::size_t slot = eventEncodeSlotNext();
+
+	return slot;
+}
+
+/* --------------------------------------------------------------------------
+ *  Encoders used by the generated `EventEncoding<T>::encode()`.  Each
+ *  writes at `out` and returns the end of what it wrote.
+ * -------------------------------------------------------------------------- */
+
+/* Field copied as is (not encoded, or array). */
+inline std::byte *eventEncodeBytes( std::byte *out, const void *src, std::size_t size ) {
+	std::memcpy( out, src, size );
+	return out + size;
+}
+
+/* Width tag and the low `width` bytes of `value`. */
+inline std::byte *eventEncodeTagged( std::byte *out, uint32_t value, uint8_t width ) {
+	*out = static_cast<std::byte>( width );
+	std::memcpy( out + 1, &value, width );
+	return out + 1 + width;
+}
+
+/* Unsigned value in the fewest bytes. */
+template <std::unsigned_integral V> inline std::byte *eventEncodeVarint( std::byte *out, V value ) {
+	uint32_t u = value;
+
+	return eventEncodeTagged( out, u, u == 0 ? 0 : u <= 0xFF ? 1 : u <= 0xFFFF ? 2 : 4 );
+}
+
+/* Signed value in the fewest bytes (sign extended by the reader). */
+template <std::signed_integral V> inline std::byte *eventEncodeZigzag( std::byte *out, V value ) {
+	int32_t s = value;
+	uint8_t width =
+		s == 0 ? 0 : ( s >= INT8_MIN && s <= INT8_MAX ) ? 1 : ( s >= INT16_MIN && s <= INT16_MAX ) ? 2 : 4;
+
+	return eventEncodeTagged( out, static_cast<uint32_t>( s ), width );
+}
+
+/* Difference to `prev` modulo the field width, as a signed value; `prev`
+ * becomes `value`. */
+template <std::integral V> inline std::byte *eventEncodeDelta( std::byte *out, V value, V &prev ) {
+	typedef std::make_unsigned_t<V> U;
+
+	U diff = static_cast<U>( static_cast<U>( value ) - static_cast<U>( prev ) );
+	prev   = value;
+	return eventEncodeZigzag( out, static_cast<std::make_signed_t<V>>( diff ) );
+}
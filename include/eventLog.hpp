@@ -0,0 +1,222 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <event.hpp>
+#include <eventCollector.hpp>
+
+/* --------------------------------------------------------------------------
+ *  Format string logging (EVT_LOG)
+ *
+ *  Printf style messages without shipping the text.  The format string is
+ *  kept in the `evt_log_fmt` section of the image and only its 32‑bit hash
+ *  (FNV‑1a) travels in the packet together with the packed arguments.  The
+ *  post‑link step `tools/event_log_strings.py` extracts the section into a
+ *  string table the host uses to expand the message again.
+ *
+ *  On wire the record is a regular event with the reserved id below:
+ *
+ *      uint32_t fmt_id;         // FNV‑1a hash of the format string
+ *      uint8_t  argc;           // number of arguments
+ *      uint8_t  _padding[3];    // aligned layout only
+ *      uint32_t args[argc];     // every argument widened to 32 bits
+ * -------------------------------------------------------------------------- */
+
+/* Reserved event id of the log record.  Must match `tools/event_generate.py`. */
+inline constexpr uint32_t EventLogId = 0xFFFF;
+
+/* Linker section which holds the interned format strings. */
+#define EVENT_LOG_FMT_SECTION "evt_log_fmt"
+
+/* --------------------------------------------------------------------------
+ *  Compile time helpers
+ * -------------------------------------------------------------------------- */
+
+/* FNV‑1a hash of the format string, used as string id on wire. */
+consteval uint32_t eventLogFmtId( std::string_view fmt ) {
+	uint32_t hash = 0x811C9DC5u;
+
+	for ( char c : fmt ) {
+		hash ^= static_cast<uint8_t>( c );
+		hash *= 0x01000193u;
+	}
+
+	return hash;
+}
+
+/* Returned by eventLogArgCount() for a format EVT_LOG cannot carry. */
+inline constexpr std::size_t EventLogFmtInvalid = SIZE_MAX;
+
+/* --------------------------------------------------------------------------
+ *  Count the conversion specifiers of a format string, with the grammar
+ *  of `_fmt_spec` in tools/event_log_strings.py:
+ *
+ *      %%                                                literal
+ *      %[-+ #0]*[0-9]*(.[0-9]*)?(hh|h|ll|l|z|j|t)?[diuxXoceEfgGp]
+ *
+ *  Anything else (`*` width or precision, %s, %n, a trailing %) has no
+ *  32-bit argument slot and gives EventLogFmtInvalid.
+ * -------------------------------------------------------------------------- */
+consteval std::size_t eventLogArgCount( std::string_view fmt ) {
+	constexpr std::string_view flags = "-+ #0";
+	constexpr std::string_view types = "diuxXoceEfgGp";
+	std::size_t count				 = 0;
+	std::size_t i					 = 0;
+
+	auto digits = [ & ] {
+		while ( i < fmt.size() && fmt[ i ] >= '0' && fmt[ i ] <= '9' ) {
+			i++;
+		}
+	};
+
+	while ( i < fmt.size() ) {
+		if ( fmt[ i++ ] != '%' ) {
+			continue;
+		}
+
+		if ( i < fmt.size() && fmt[ i ] == '%' ) {
+			i++;
+			continue;
+		}
+
+		while ( i < fmt.size() && flags.find( fmt[ i ] ) != std::string_view::npos ) {
+			i++;
+		}
+		digits();
+		if ( i < fmt.size() && fmt[ i ] == '.' ) {
+			i++;
+			digits();
+		}
+		if ( fmt.substr( i, 2 ) == "hh" || fmt.substr( i, 2 ) == "ll" ) {
+			i += 2;
+		} else if ( i < fmt.size() && std::string_view( "hlzjt" ).find( fmt[ i ] ) != std::string_view::npos ) {
+			i++;
+		}
+
+		if ( i >= fmt.size() || types.find( fmt[ i ] ) == std::string_view::npos ) {
+			return EventLogFmtInvalid;
+		}
+		i++;
+		count++;
+	}
+
+	return count;
+}
+
+/* Only scalar values that fit in one 32‑bit argument slot are accepted. */
+template <typename A>
+concept EventLogArg =
+	( std::is_integral_v<A> || std::is_enum_v<A> || std::is_same_v<A, float> ) &&
+	sizeof( A ) <= sizeof( uint32_t );
+
+/* --------------------------------------------------------------------------
+ *  Log record payload
+ *
+ *  Sized exactly by argument count so a log costs about as much as a small
+ *  struct event.  Follows the event layout to match the CTF sequence.
+ * -------------------------------------------------------------------------- */
+template <std::size_t N> struct EVENT_LAYOUT_PACKED EventLogRecord {
+	uint32_t fmtId;
+	uint8_t argc;
+#if CONFIG_EVENT_ALIGNED
+	uint8_t padding[ 3 ]; // described in the metadata, args on 4 bytes
+#endif
+	uint32_t args[ N ];
+};
+
+/* Message without argument: no zero length array. */
+template <> struct EVENT_LAYOUT_PACKED EventLogRecord<0> {
+	uint32_t fmtId;
+	uint8_t argc;
+#if CONFIG_EVENT_ALIGNED
+	uint8_t padding[ 3 ];
+#endif
+};
+
+template <std::size_t N> struct EventId<EventLogRecord<N>> {
+	static constexpr uint32_t value = EventLogId;
+};
+
+/* Widen one argument into its 32‑bit slot. */
+template <EventLogArg A> constexpr uint32_t eventLogArgToWord( A arg ) {
+	if constexpr ( std::is_same_v<A, float> ) {
+		return std::bit_cast<uint32_t>( arg );
+	} else if constexpr ( std::is_enum_v<A> ) {
+		return static_cast<uint32_t>( static_cast<std::underlying_type_t<A>>( arg ) );
+	} else {
+		return static_cast<uint32_t>( arg );
+	}
+}
+
+/* --------------------------------------------------------------------------
+ *  Build a log event for the given string id.
+ * -------------------------------------------------------------------------- */
+template <uint32_t FmtId, EventLogArg... Args>
+Event<EventLogRecord<sizeof...( Args )>> eventLogMake( Args... args ) {
+	Event<EventLogRecord<sizeof...( Args )>> evt;
+	auto *param = evt.getParam();
+
+	param->fmtId = FmtId;
+	param->argc	 = static_cast<uint8_t>( sizeof...( Args ) );
+
+	if constexpr ( sizeof...( Args ) > 0 ) {
+		uint32_t words[] = { eventLogArgToWord( args )... };
+
+		for ( std::size_t i = 0; i < sizeof...( Args ); i++ ) {
+			param->args[ i ] = words[ i ];
+		}
+	}
+
+	return evt;
+}
+
+/* Build and push a log event to the given collector. */
+template <uint32_t FmtId, typename Collector, EventLogArg... Args>
+inline void eventLogPush( Collector *inst, Args... args ) {
+	auto evt = eventLogMake<FmtId>( args... );
+
+	inst->pushEvent( &evt );
+}
+
+/* Argument count check used by EVT_LOG. */
+template <uint32_t FmtId, std::size_t Expected, typename Collector, EventLogArg... Args>
+inline void eventLogPushChecked( Collector *inst, Args... args ) {
+	static_assert( Expected != EventLogFmtInvalid,
+				   "EVT_LOG format: no * width or precision, %s or %n (one 32-bit word per argument)" );
+	static_assert( Expected == EventLogFmtInvalid || Expected == sizeof...( Args ),
+				   "EVT_LOG argument count mismatch with format" );
+
+	eventLogPush<FmtId>( inst, args... );
+}
+
+/* --------------------------------------------------------------------------
+ *  EVT_LOG( "fmt %u %d", a, b )
+ *  EVT_LOG_TO( collector, "fmt %u %d", a, b )
+ *
+ *  `fmt` must be a string literal.  The argument count is checked against
+ *  the conversion specifiers at compile time.  EVT_LOG goes to the
+ *  `eventCollector` singleton, EVT_LOG_TO to any collector instance.
+ * -------------------------------------------------------------------------- */
+#define EVT_LOG_TO( collector, fmt, ... )                                                          \
+	do {                                                                                           \
+		__attribute__( ( section( EVENT_LOG_FMT_SECTION ), used ) ) static const char              \
+			evtLogFmtStr[] = fmt;                                                                  \
+		(void)evtLogFmtStr;                                                                        \
+		eventLogPushChecked<eventLogFmtId( fmt ), eventLogArgCount( fmt )>(                        \
+			( collector ) __VA_OPT__(, ) __VA_ARGS__ );                                            \
+	} while ( 0 )
+
+#define EVT_LOG( fmt, ... )                                                                        \
+	EVT_LOG_TO( eventCollector::getInstance(), fmt __VA_OPT__(, ) __VA_ARGS__ )
@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <bitset>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <Queue.hpp>
+#include <eventConfig.hpp>
+#include <internal/eventPacket.hpp>
+#include <staticPool.hpp>
+
+/* --------------------------------------------------------------------------
+ *  Concept: EventPacketStorePolicy
+ *
+ *  Where a collector keeps its packets: a pool of free packets and the
+ *  queue of packets ready to send.  The collector calls it under
+ *  `packetLock()`.
+ * -------------------------------------------------------------------------- */
+template <typename S>
+concept EventPacketStorePolicy = requires( S s, typename S::packet_t *pkt ) {
+	{ s.allocate() } -> std::same_as<typename S::packet_t *>;
+	{ s.release( pkt ) } -> std::same_as<void>;
+	{ s.pushReady( pkt ) } -> std::same_as<bool>;
+	{ s.popReady() } -> std::same_as<typename S::packet_t *>;
+};
+
+/* --------------------------------------------------------------------------
+ *  Concept: EventPacketStoreOccupancy – store reporting how many packets
+ *  wait in the ready queue and how many are taken from the pool (load
+ *  shedding, see eventShed.hpp).  Called under `packetLock()` too.
+ * -------------------------------------------------------------------------- */
+template <typename S>
+concept EventPacketStoreOccupancy = requires( S s ) {
+	{ s.readyCount() } -> std::convertible_to<std::size_t>;
+	{ s.usedCount() } -> std::convertible_to<std::size_t>;
+};
+
+/* --------------------------------------------------------------------------
+ *  eventPacketStore – packet pool and ready queue
+ *
+ *  The ready queue holds pool indices, not pointers, so the whole object is
+ *  position independent and can be placed in memory mapped by several
+ *  processes (see posix/eventShm.hpp).  The queue capacity matches the pool
+ *  size so insertion never fails.
+ * -------------------------------------------------------------------------- */
+template <EventCollectorConfig Config> class eventPacketStore {
+public:
+	typedef basicEventPacket<Config> packet_t;
+
+private:
+	StaticPool<packet_t, Config::packetCountMax> pool;
+	Queue<uint32_t, Config::packetCountMax> ready;
+
+public:
+	/* Take a free packet, nullptr when every packet is in use. */
+	packet_t *allocate() { return pool.allocate(); }
+
+	/* Return a sent packet to the pool. */
+	void release( packet_t *pkt ) { pool.release( pkt ); }
+
+	/* Queue a finished packet for transmission. */
+	bool pushReady( packet_t *pkt ) {
+		return ready.insert( static_cast<uint32_t>( pool.indexOf( pkt ) ) );
+	}
+
+	/* Oldest packet ready for transmission, nullptr when none. */
+	packet_t *popReady() {
+		auto idx = ready.remove();
+
+		return idx.has_value() ? pool.at( idx.value() ) : nullptr;
+	}
+
+	/* Position independent handle of a packet (packetCountMax when foreign). */
+	std::size_t indexOf( const packet_t *pkt ) const { return pool.indexOf( pkt ); }
+	packet_t *at( std::size_t idx ) { return pool.at( idx ); }
+
+	/* --------------------------------------------------------------------
+	 *  Rebuild the store found in memory kept over a reset (see
+	 *  eventPersist.hpp).  The `sending` packets (taken from the queue, not
+	 *  released) go ahead of the ready packets, oldest first, then the
+	 *  `open` packets (allocated, not queued) that hold events.  Every queued
+	 *  packet is finalised; every other packet returns to the pool.
+	 *  Returns false when the ready queue or one of its packets is not
+	 *  consistent.
+	 * -------------------------------------------------------------------- */
+	bool recover( const std::bitset<Config::packetCountMax> &sending,
+				  const std::bitset<Config::packetCountMax> &open ) {
+		Queue<uint32_t, Config::packetCountMax> pending = ready;
+		std::bitset<Config::packetCountMax> left		= sending;
+
+		if ( !pending.isValid() ) {
+			return false;
+		}
+
+		ready = Queue<uint32_t, Config::packetCountMax>();
+		while ( left.any() ) {
+			std::size_t oldest = Config::packetCountMax;
+
+			for ( std::size_t i = 0; i < Config::packetCountMax; i++ ) {
+				if ( left.test( i ) && ( oldest == Config::packetCountMax ||
+										 pool.at( i )->getBeginTimestamp() < pool.at( oldest )->getBeginTimestamp() ) ) {
+					oldest = i;
+				}
+			}
+			left.reset( oldest );
+			ready.insert( static_cast<uint32_t>( oldest ) );
+		}
+
+		while ( auto idx = pending.remove() ) {
+			if ( idx.value() >= Config::packetCountMax || !pool.at( idx.value() )->isIntact() ) {
+				return false;
+			}
+			if ( !ready.contains( idx.value() ) ) {
+				ready.insert( idx.value() );
+			}
+		}
+
+		for ( std::size_t i = 0; i < Config::packetCountMax; i++ ) {
+			if ( open.test( i ) && !pool.at( i )->isEmpty() &&
+				 !ready.contains( static_cast<uint32_t>( i ) ) ) {
+				ready.insert( static_cast<uint32_t>( i ) );
+			}
+		}
+
+		for ( std::size_t i = 0; i < Config::packetCountMax; i++ ) {
+			if ( ready.contains( static_cast<uint32_t>( i ) ) ) {
+				pool.at( i )->buildPacketAtLastEvent();
+			} else {
+				pool.release( pool.at( i ) );
+			}
+		}
+
+		return true;
+	}
+
+	/* --------------------------------------------------------------------
+	 *  Make the store consistent again after a writer died in the middle
+	 *  of an update (see posix/eventShm.hpp).  A pool bit is a single
+	 *  write; the ready queue count is restored from its head and tail,
+	 *  then only allocated, distinct packets are queued again.  A packet
+	 *  the writer had taken stays taken.
+	 * -------------------------------------------------------------------- */
+	void repair() {
+		Queue<uint32_t, Config::packetCountMax> pending = ready;
+
+		pending.resync();
+		ready = Queue<uint32_t, Config::packetCountMax>();
+		while ( auto idx = pending.remove() ) {
+			if ( pool.isUsed( idx.value() ) && !ready.contains( idx.value() ) ) {
+				ready.insert( idx.value() );
+			}
+		}
+	}
+
+	/* Occupancy, for diagnostics. */
+	std::size_t readyCount() const { return ready.size(); }
+	std::size_t usedCount() { return pool.usedCount(); }
+};
@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <eventConfig.hpp>
+#include <eventPacketStore.hpp>
+
+/* --------------------------------------------------------------------------
+ *  Crash persistent packet store
+ *
+ *  The packet pool, the ready queue and which packets are being built and
+ *  sent (every packet in flight on the transport or held by a consumer)
+ *  live in RAM that is not cleared at reset (a `.noinit` section on
+ *  target).  At the next boot `eventPersistRegion::attach()` checks the
+ *  integrity marker and the bookkeeping; when intact, every packet of the
+ *  previous run holding events is finalised and queued, oldest first, so
+ *  `getSendPacket()` returns them before the packets of the new run.
+ *  Otherwise the store starts empty.
+ *
+ *      EVENT_NOINIT static eventPersistStorage<cfg> traceMem;
+ *
+ *      eventPersistRegion<cfg> region;
+ *      size_t old = region.attach( &traceMem );   // packets of previous run
+ *      basicEventCollector<myPlatform, cfg, eventPersistStore<cfg>>
+ *          ec( myPlatform(), region.packetStore() );
+ *
+ *  The linker script must place `.noinit` in RAM outside `.bss`.
+ *  Recovered packets keep their sequence numbers and time base, so drain
+ *  them to their own file before the first event of the new run.
+ * -------------------------------------------------------------------------- */
+
+#ifndef EVENT_NOINIT
+#define EVENT_NOINIT __attribute__( ( section( ".noinit" ) ) )
+#endif
+
+/* "EVPR", little endian. */
+inline constexpr uint32_t EventPersistMagic = 0x52505645;
+
+/* --------------------------------------------------------------------------
+ *  Layout of the persistent memory.
+ * -------------------------------------------------------------------------- */
+template <EventCollectorConfig Config> struct eventPersistLayout {
+	uint32_t magic;		 // EventPersistMagic once initialised
+	uint32_t storeBytes; // sizeof( store ), catches a firmware with another config
+	std::bitset<Config::packetCountMax> sending; // taken from the queue, not yet released
+	std::bitset<Config::packetCountMax> open;	 // allocated, not yet queued (current, pre-armed)
+	eventPacketStore<Config> store;
+};
+
+/* --------------------------------------------------------------------------
+ *  Raw storage to place in the `.noinit` section.  Trivial type, so no
+ *  constructor clears it at startup.
+ * -------------------------------------------------------------------------- */
+template <EventCollectorConfig Config> struct alignas( eventPersistLayout<Config> ) eventPersistStorage {
+	std::byte raw[ sizeof( eventPersistLayout<Config> ) ];
+};
+
+/* --------------------------------------------------------------------------
+ *  eventPersistStore – collector store policy on the persistent layout.
+ *
+ *  Next to the pool and queue operations it records which packets are
+ *  being built and sent.  The order of the writes keeps every packet accounted
+ *  for if the reset hits in between; only a packet being taken from the
+ *  queue when the reset hits may be lost.
+ * -------------------------------------------------------------------------- */
+template <EventCollectorConfig Config> class eventPersistStore {
+public:
+	typedef basicEventPacket<Config> packet_t;
+
+private:
+	eventPersistLayout<Config> *layout = nullptr;
+
+public:
+	eventPersistStore() = default;
+	explicit eventPersistStore( eventPersistLayout<Config> *_layout ) : layout( _layout ) {}
+
+	packet_t *allocate() {
+		packet_t *pkt = layout->store.allocate();
+
+		if ( pkt != nullptr ) {
+			std::atomic_signal_fence( std::memory_order_seq_cst );
+			layout->open.set( layout->store.indexOf( pkt ) );
+		}
+		return pkt;
+	}
+
+	void release( packet_t *pkt ) {
+		std::size_t idx = layout->store.indexOf( pkt );
+
+		if ( idx < Config::packetCountMax ) {
+			layout->sending.reset( idx );
+			layout->open.reset( idx );
+		}
+		std::atomic_signal_fence( std::memory_order_seq_cst );
+		layout->store.release( pkt );
+	}
+
+	bool pushReady( packet_t *pkt ) {
+		bool ok = layout->store.pushReady( pkt );
+
+		std::atomic_signal_fence( std::memory_order_seq_cst );
+		layout->open.reset( layout->store.indexOf( pkt ) );
+		return ok;
+	}
+
+	packet_t *popReady() {
+		packet_t *pkt = layout->store.popReady();
+
+		if ( pkt != nullptr ) {
+			std::atomic_signal_fence( std::memory_order_seq_cst );
+			layout->sending.set( layout->store.indexOf( pkt ) );
+		}
+		return pkt;
+	}
+
+	/* Occupancy, for load shedding. */
+	std::size_t readyCount() const { return layout->store.readyCount(); }
+	std::size_t usedCount() { return layout->store.usedCount(); }
+};
+
+/* --------------------------------------------------------------------------
+ *  eventPersistRegion – boot time check and recovery of the storage.
+ * -------------------------------------------------------------------------- */
+template <EventCollectorConfig Config> class eventPersistRegion {
+	typedef eventPersistLayout<Config> layout_t;
+
+	layout_t *layout = nullptr;
+
+	/* Marker, geometry and packet bookkeeping of the previous run. */
+	bool isIntact() {
+		if ( layout->magic != EventPersistMagic || layout->storeBytes != sizeof( eventPacketStore<Config> ) ) {
+			return false;
+		}
+
+		// Packets of the ready queue are checked by recover().
+		for ( std::size_t i = 0; i < Config::packetCountMax; i++ ) {
+			if ( ( layout->open.test( i ) || layout->sending.test( i ) ) &&
+				 !layout->store.at( i )->isIntact() ) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+public:
+	/* --------------------------------------------------------------------
+	 *  Attach to the storage at boot.
+	 *  Returns the number of packets recovered from the previous run and
+	 *  queued for sending; 0 when the storage was not intact (it is then
+	 *  initialised empty).
+	 * -------------------------------------------------------------------- */
+	std::size_t attach( eventPersistStorage<Config> *mem ) {
+		layout = reinterpret_cast<layout_t *>( mem->raw );
+
+		if ( isIntact() ) {
+			if ( layout->store.recover( layout->sending, layout->open ) ) {
+				layout->open.reset();
+				layout->sending.reset();
+				return layout->store.readyCount();
+			}
+		}
+
+		// Power on, other firmware or damaged content: start empty.
+		layout->magic = 0;
+		std::atomic_signal_fence( std::memory_order_seq_cst );
+
+		new ( &layout->store ) eventPacketStore<Config>();
+		layout->storeBytes = sizeof( eventPacketStore<Config> );
+		layout->open.reset();
+		layout->sending.reset();
+
+		std::atomic_signal_fence( std::memory_order_seq_cst );
+		layout->magic = EventPersistMagic;
+		return 0;
+	}
+
+	eventPersistStore<Config> packetStore() const { return eventPersistStore<Config>( layout ); }
+};
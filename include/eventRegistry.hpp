@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+/* --------------------------------------------------------------------------
+ *  Event registry
+ *
+ *  The generator writes `event_registry.hpp`: a `constexpr` description of
+ *  every event of the catalog, numbered with a dense index (streams in
+ *  order, then events by id).  Runtime filters and per event counters are
+ *  flat arrays of `eventRegistry::count` entries indexed in O(1):
+ *
+ *      std::array<uint32_t, eventRegistry::count> hits;
+ *      hits[ eventRegistry::indexOf( streamId, id ) ]++;
+ *
+ *  The generated header only depends on this one, so host decoders can be
+ *  compiled against the same table as the firmware.
+ * -------------------------------------------------------------------------- */
+
+/* Scalar type of a field, as in the YAML description. */
+enum class eventFieldType : uint8_t { u8, u16, u32, i8, i16, i32 };
+
+/* Wire encoding of a field, YAML `encoding` (see eventEncoding.hpp). */
+enum class eventFieldEncoding : uint8_t { none, delta, varint, zigzag };
+
+/* --------------------------------------------------------------------------
+ *  One field of an event payload.
+ * -------------------------------------------------------------------------- */
+typedef struct {
+	const char *name;
+	eventFieldType type;
+	uint16_t offset; // byte offset in the payload struct
+	uint16_t count;	 // array length, 1 for a scalar
+	eventFieldEncoding encoding; // wire size varies unless none
+} eventFieldInfo;
+
+/* --------------------------------------------------------------------------
+ *  One event of the catalog.
+ * -------------------------------------------------------------------------- */
+typedef struct {
+	uint32_t streamId;
+	uint32_t id;
+	const char *name;
+	uint16_t size;		 // payload bytes, without the event header
+	uint16_t firstField; // index in `fields`
+	uint16_t fieldCount;
+	bool scope; // last field is the scope `duration`
+} eventInfo;
+
+/* --------------------------------------------------------------------------
+ *  Id table of one stream: `slots[ firstSlot + id ]` is the dense index
+ *  of event `id`, for `id < slotCount`.
+ * -------------------------------------------------------------------------- */
+typedef struct {
+	uint32_t streamId;
+	uint32_t firstSlot;
+	uint32_t slotCount;
+} eventRegistryStream;
+
+/* Slot of an id without event. */
+inline constexpr uint16_t eventRegistryNoSlot = 0xFFFF;
+
+/* --------------------------------------------------------------------------
+ *  Concept: EventRegistry – shape of the generated registry.
+ * -------------------------------------------------------------------------- */
+template <typename R>
+concept EventRegistry = requires {
+	{ R::count } -> std::convertible_to<std::size_t>;
+	R::events[ 0 ];
+	R::fields.size();
+	R::streams[ 0 ];
+	R::slots[ 0 ];
+};
+
+/* --------------------------------------------------------------------------
+ *  Dense index of event `id` of stream `streamId`, `R::count` when the
+ *  catalog does not define it.  Constant time: a scan of the (few)
+ *  streams and one table read.
+ * -------------------------------------------------------------------------- */
+template <EventRegistry R> constexpr std::size_t eventRegistryLookup( uint32_t streamId, uint32_t id ) {
+	for ( const eventRegistryStream &s : R::streams ) {
+		if ( s.streamId != streamId ) {
+			continue;
+		}
+		if ( id >= s.slotCount || R::slots[ s.firstSlot + id ] == eventRegistryNoSlot ) {
+			return R::count;
+		}
+		return R::slots[ s.firstSlot + id ];
+	}
+
+	return R::count;
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <cstdint>
+#include <type_traits>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <event.hpp>
+#include <eventCollector.hpp>
+#include <eventWhere.hpp>
+
+/* --------------------------------------------------------------------------
+ *  Concept: EventScopeType
+ *
+ *  Payload of a scope event, generated for YAML events marked `scope: true`.
+ *  The generator appends the `duration` field (uint32_t, clock ticks).
+ * -------------------------------------------------------------------------- */
+template <typename T>
+concept EventScopeType = EventMemCopyable<T> && requires( T t ) {
+	requires std::is_same_v<decltype( t.duration ), uint32_t>;
+};
+
+/* --------------------------------------------------------------------------
+ *  EventScope – RAII duration event
+ *
+ *  Reads the clock once on construction and once on destruction and emits a
+ *  single event carrying the elapsed time in `duration`.  The exit time is
+ *  read by the collector under its event lock (pushScopeEvent()), so the
+ *  event header timestamp keeps the stream clock monotonic for babeltrace2
+ *  even when another push preempts the exit; the scope start is
+ *  `timestamp - duration`.  A duration above 32 bits saturates to
+ *  UINT32_MAX.  A capture predicate runs before the lock: it sees the
+ *  duration up to a first exit clock read.
+ *
+ *  `Collector` is any `basicEventCollector`; the default constructor uses
+ *  the `eventCollector` singleton.
+ * -------------------------------------------------------------------------- */
+template <EventScopeType T, typename Collector = eventCollector> class EventScope final {
+	Event<T> evt;
+	Collector *inst;
+	uint64_t startTs;
+
+public:
+	explicit EventScope( Collector *_inst ) : inst( _inst ) { startTs = inst->getTimestamp(); }
+
+	EventScope()
+		requires std::is_same_v<Collector, eventCollector>
+		: EventScope( eventCollector::getInstance() ) {}
+
+	~EventScope() {
+		if constexpr ( EventHasWhere<T> ) {
+			evt.getParam()->duration = eventScopeDuration( inst->getTimestamp() - startTs );
+		}
+		inst->pushScopeEvent( &evt, startTs );
+	}
+
+	EventScope( const EventScope & )			= delete;
+	EventScope &operator=( const EventScope & ) = delete;
+
+	/* Payload of the scope event, may be updated until the scope ends. */
+	T *getParam() { return evt.getParam(); }
+};
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <event.hpp>
+
+/* --------------------------------------------------------------------------
+ *  Adaptive load shedding
+ *
+ *  An event may declare how detailed it is (YAML `verbosity`, 0 to 3):
+ *
+ *      - name: rxByte
+ *        verbosity: 3       # shed first
+ *      - name: driverIrq
+ *        verbosity: 1       # shed last
+ *      - name: fault        # 0 (default): always captured
+ *
+ *  When the drain falls behind, the collector raises its shed level from
+ *  the occupancy of the ready queue and of the packet pool; at level `s`
+ *  the events of verbosity above 3 - s are left out in pushEvent() /
+ *  pushEvents(), before the clock read.  Below the low watermarks the
+ *  level goes down again, one step per packet switch or release.  A shed
+ *  instance is not a loss: it does not count in events_discarded.
+ *
+ *      ec.setLoadShedding( { .levelMax = 3, .readyHigh = 6, .readyLow = 2,
+ *                            .usedHigh = 7, .usedLow = 4 } );
+ *
+ *  Every change is recorded in the trace: an `evt_shed` marker (reserved
+ *  id, in every stream) goes ahead of the next event captured, with the
+ *  new level and the occupancy that caused it.
+ * -------------------------------------------------------------------------- */
+
+/* Highest shed level: every event of non zero verbosity is left out. */
+inline constexpr uint8_t eventShedLevelMax = 3;
+
+/* Verbosity of payload T, specialised by the generator when not 0. */
+template <typename T> struct EventVerbosity {
+	static constexpr uint8_t value = 0;
+};
+
+/* --------------------------------------------------------------------------
+ *  Watermarks of the controller, in packets.  The level goes up when
+ *  either occupancy reaches its high mark, down when both are at or
+ *  below their low mark.  `levelMax` 0 disables shedding.
+ * -------------------------------------------------------------------------- */
+typedef struct {
+	uint8_t levelMax   = 0;			 // highest level used, up to eventShedLevelMax
+	uint16_t readyHigh = UINT16_MAX; // packets waiting for the drain
+	uint16_t readyLow  = 0;
+	uint16_t usedHigh  = UINT16_MAX; // packets taken from the pool
+	uint16_t usedLow   = 0;
+} eventShedConfig;
+
+/* --------------------------------------------------------------------------
+ *  Marker of a shed level change, `evt_shed` in the CTF metadata.
+ * -------------------------------------------------------------------------- */
+typedef struct EVENT_LAYOUT_PACKED {
+	uint32_t level; // new shed level
+	uint32_t ready; // ready queue depth that caused the change
+	uint32_t used;	// packets in use that caused the change
+} eventShedMarker;
+
+template <> struct EventId<eventShedMarker> {
+	static constexpr uint32_t value = 0xFFFE;
+};
+
+/* --------------------------------------------------------------------------
+ *  True when the event is captured at shed level `level`.  Events of
+ *  verbosity 0 do not read the level.
+ * -------------------------------------------------------------------------- */
+template <IsEventType E> inline bool eventShedAccepts( [[maybe_unused]] const std::atomic<uint8_t> &level ) {
+	constexpr uint8_t verbosity = EventVerbosity<typename E::param_t>::value;
+
+	static_assert( verbosity <= eventShedLevelMax, "verbosity out of range" );
+
+	if constexpr ( verbosity == 0 ) {
+		return true;
+	} else {
+		return verbosity + level.load( std::memory_order_relaxed ) <= eventShedLevelMax;
+	}
+}
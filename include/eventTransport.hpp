@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/* --------------------------------------------------------------------------
+ *  Transport driver interface (push mode)
+ *
+ *  Instead of polling `getSendPacket()`, register a transport with
+ *  `setTransport()`.  The collector submits ReadyToSend packets from the
+ *  driver side, keeping up to `Config::inFlightMax` packets in flight
+ *  (DMA / UART TX chains, asynchronous file writes).  The driver reports
+ *  the end of a transfer with `transportComplete( token )` on the
+ *  collector, from any context; that completion submits the next packet.
+ *
+ *  The event that closes a packet only queues it and calls `ready()`, the
+ *  driver then submits from its own context with `transportPoll()` (pend
+ *  a software interrupt, post to its task...).  Without `ready()`, packets
+ *  leave on the next completion or periodic poll.
+ *
+ *  With an ack timeout, a packet not completed in time is dropped and its
+ *  buffer returned to the pool (`transportPoll()`); a late completion of
+ *  that packet is ignored.
+ * -------------------------------------------------------------------------- */
+class eventTransport {
+public:
+	virtual ~eventTransport() = default;
+
+	/* Start sending `pkt`.  The span stays valid until the packet is
+	 * completed or cancelled.  Return false when the driver cannot take it
+	 * now: the packet is offered again on the next completion or poll. */
+	virtual bool submit( std::span<const std::byte> pkt, uint32_t token ) = 0;
+
+	/* Ack timeout of `token`: stop using its buffer, it is reused once
+	 * this returns. */
+	virtual void cancel( uint32_t token ) { ( void ) token; }
+
+	/* A packet was queued, called on the event path: schedule a
+	 * `transportPoll()`.  Must not block or call into the collector. */
+	virtual void ready() {}
+};
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <atomic>
+#include <concepts>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <event.hpp>
+
+/* --------------------------------------------------------------------------
+ *  Capture predicates (YAML `where`)
+ *
+ *  An event may declare a condition on its payload fields, C syntax, with
+ *  the named values of the file's `constants` entry:
+ *
+ *      - constants: { OK: 0 }
+ *      - events:
+ *        - name: loopCount
+ *          where: count % 100 == 0
+ *        - name: driverIrq
+ *          where: status != OK
+ *
+ *  The generator compiles it into `EventWhere<T>::test()`.  The collector
+ *  runs it first in pushEvent() / pushEvents(), before the event lock, the
+ *  clock read and the copy, so a rejected instance costs the test only.
+ *  A rejected instance is filtered, it does not count in events_discarded.
+ *
+ *  Predicates are off at startup (every instance is captured) and switched
+ *  at runtime, e.g. from a debug command:
+ *
+ *      EventWhere<loopCount_t>::enable( true );
+ *      eventWhereSet( EVENT_STREAM_ID_MAIN, 1, true );   // by id
+ *      eventWhereSetAll( false );
+ * -------------------------------------------------------------------------- */
+
+/* Predicate of payload T, specialised by the generator. */
+template <typename T> struct EventWhere;
+
+/* --------------------------------------------------------------------------
+ *  Runtime switch of the predicate of T, base of every specialisation.
+ *  One flag per predicate, read with a relaxed load in the push path.
+ * -------------------------------------------------------------------------- */
+template <typename T> struct eventWhereSwitch {
+	static inline std::atomic<bool> active = false;
+
+	static void enable( bool on ) { active.store( on, std::memory_order_relaxed ); }
+	static bool enabled() { return active.load( std::memory_order_relaxed ); }
+};
+
+/* --------------------------------------------------------------------------
+ *  Concept: EventHasWhere – payload with a generated predicate.
+ * -------------------------------------------------------------------------- */
+template <typename T>
+concept EventHasWhere = requires( const T &param ) {
+	{ EventWhere<T>::test( param ) } -> std::same_as<bool>;
+	{ EventWhere<T>::enabled() } -> std::same_as<bool>;
+};
+
+/* --------------------------------------------------------------------------
+ *  True when the event is to be captured: no predicate, predicate off, or
+ *  predicate holding on the payload.
+ * -------------------------------------------------------------------------- */
+template <IsEventType E> inline bool eventWhereAccepts( E *evt ) {
+	typedef typename E::param_t param_t;
+
+	if constexpr ( EventHasWhere<param_t> ) {
+		return !EventWhere<param_t>::enabled() || EventWhere<param_t>::test( *evt->getParam() );
+	} else {
+		return true;
+	}
+}
@@ -0,0 +1,1050 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <atomic>
+#include <cassert>
+#include <cstring>
+
+/* --------------------------------------------------------------------
+ *  Constructor – initialise state.
+ *
+ *  The packet store is a member, nothing is allocated here.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+basicEventCollector<Platform, Config, Store>::basicEventCollector( const Platform &_pltf )
+	: pltf( _pltf ) {
+	sendPkt			= nullptr;
+	nextPkt			= nullptr;
+	levels			= {};
+	streamId		= 0;
+	transport		= nullptr;
+	ackTimeout		= 0;
+	ackTimeoutCount = 0;
+	inFlight		= {};
+	shedCfg			= {};
+	shedLevel		= 0;
+	shedPending		= false;
+	shedLast		= {};
+	drainMin		= 0;
+	drainParked		= false;
+	consumers		= {};
+	fanPkt			= {};
+	fanRefPkt		= {};
+	fanRefs			= {};
+	fanHead			= 0;
+}
+
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+basicEventCollector<Platform, Config, Store>::basicEventCollector( const Platform &_pltf,
+																   const Store &_store )
+	: pltf( _pltf ), store( _store ) {
+	sendPkt			= nullptr;
+	nextPkt			= nullptr;
+	levels			= {};
+	streamId		= 0;
+	transport		= nullptr;
+	ackTimeout		= 0;
+	ackTimeoutCount = 0;
+	inFlight		= {};
+	shedCfg			= {};
+	shedLevel		= 0;
+	shedPending		= false;
+	shedLast		= {};
+	drainMin		= 0;
+	drainParked		= false;
+	consumers		= {};
+	fanPkt			= {};
+	fanRefPkt		= {};
+	fanRefs			= {};
+	fanHead			= 0;
+}
+
+/* --------------------------------------------------------------------
+ *  Execution level of the caller.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+std::size_t basicEventCollector<Platform, Config, Store>::execLevel() {
+	if constexpr ( execLevelMax > 1 ) {
+		std::size_t level = pltf.getExecLevel();
+
+		assert( level < execLevelMax );
+		return level;
+	} else {
+		return 0;
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Enter / leave a push on a level.
+ *
+ *  Threads share level 0 and are serialised by the event lock.  Higher
+ *  levels only nest, so marking the level busy is enough: it tells a
+ *  flush from another level to keep off the packet being written.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+bool basicEventCollector<Platform, Config, Store>::levelEnter( std::size_t level ) {
+	if ( level == 0 && !pltf.eventTryLock() ) {
+		return false;
+	}
+
+	levels[ level ].busy = true;
+	std::atomic_signal_fence( std::memory_order_seq_cst );
+	return true;
+}
+
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::levelExit( std::size_t level ) {
+	std::atomic_signal_fence( std::memory_order_seq_cst );
+	levels[ level ].busy = false;
+
+	if ( level == 0 ) {
+		pltf.eventUnlock();
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Acquire the current packet of a level for event insertion.
+ *
+ *  Normally the current packet is the pre-armed one switched in when the
+ *  previous packet closed.  If no packet is active (first event, or no
+ *  packet was armed in time) allocate one from the pool, initialise it
+ *  with the current stream ID and sequence number and reset the discard
+ *  counter.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+typename basicEventCollector<Platform, Config, Store>::packet_t *
+basicEventCollector<Platform, Config, Store>::getCurrentPacket( std::size_t level ) {
+	level_t &lvl  = levels[ level ];
+	packet_t *pkt = lvl.curr;
+	uint64_t ts	  = 0;
+
+	if ( pkt == nullptr ) {
+		pltf.packetLock();
+		pkt = store.allocate();
+		pltf.packetUnlock();
+
+		if ( pkt == nullptr ) {
+			// Pool exhausted, every packet is waiting for transmission.
+			return nullptr;
+		}
+
+		ts = pltf.getTimestamp();
+		pkt->init( streamId, lvl.seqNo, ts );
+		pkt->setExecLevel( static_cast<uint32_t>( level ) );
+		stampContext( pkt );
+		lvl.curr	  = pkt;
+		lvl.discarded = 0;
+		lvl.seqNo++;
+	}
+
+	return pkt;
+}
+
+/* --------------------------------------------------------------------
+ *  Send the current packet of a level to the queue.
+ *
+ *  The packet must already exist (checked by assert).  It is
+ *  inserted into the internal queue and the pre-armed packet, if any,
+ *  becomes current.  Because the queue capacity equals the pool size,
+ *  insertion never fails – the following assert guarantees that.
+ *
+ *  The queued packet is not finalised here: the drain side builds it
+ *  (buildPacketAtLastEvent) so the event that fills a packet costs no
+ *  more than any other.  The next packet begins at the last event of the
+ *  queued one, keeping the packet time ranges contiguous.
+ *  With a transport attached the driver is only signalled, it submits
+ *  the packet from its own context (transportPoll).
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::sendPacket( std::size_t level ) {
+	[[maybe_unused]] bool qstatus = false;
+	level_t &lvl				  = levels[ level ];
+	packet_t *pkt				  = nullptr;
+	uint64_t lastTs				  = 0;
+	bool wake					  = false;
+	// this must not be null in this path as per design.
+	assert( lvl.curr != nullptr );
+
+	lastTs = lvl.curr->getLastTimestamp();
+
+	pltf.packetLock();
+	qstatus = store.pushReady( lvl.curr );
+
+	// As queue size and packet buffer have same count it
+	// never get asserted.
+	assert( qstatus );
+	shedUpdate();
+	wake = drainDue();
+
+	pkt		 = nextPkt;
+	nextPkt	 = nullptr;
+	lvl.curr = pkt;
+	pltf.packetUnlock();
+
+	if ( wake ) {
+		drainWake();
+	}
+
+	if ( pkt != nullptr ) {
+		pkt->start( streamId, lvl.seqNo, lastTs );
+		pkt->setExecLevel( static_cast<uint32_t>( level ) );
+		stampContext( pkt );
+		lvl.discarded = 0;
+		lvl.seqNo++;
+	}
+
+	if ( transport != nullptr ) {
+		transport->ready();
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Close the packet of another level.
+ *
+ *  A higher level is never inside a push while a lower one runs; a lower
+ *  level may have been interrupted in one (busy) and is left alone.  The
+ *  packet is taken with an atomic exchange, so a higher level preempting
+ *  the flush either still writes into it or allocates a fresh one.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::flushLevel( std::size_t level ) {
+	[[maybe_unused]] bool qstatus = false;
+	level_t &lvl				  = levels[ level ];
+	packet_t *pkt				  = nullptr;
+	packet_t *none				  = nullptr;
+	bool wake					  = false;
+
+	std::atomic_signal_fence( std::memory_order_seq_cst );
+	if ( lvl.busy ) {
+		return;
+	}
+
+	pkt = __atomic_exchange_n( &lvl.curr, nullptr, __ATOMIC_SEQ_CST );
+	if ( pkt == nullptr ) {
+		return;
+	}
+
+	pltf.packetLock();
+	if ( !pkt->isEmpty() ) {
+		qstatus = store.pushReady( pkt );
+		assert( qstatus );
+		shedUpdate();
+		wake = drainDue();
+	} else if ( !__atomic_compare_exchange_n( &lvl.curr, &none, pkt, false, __ATOMIC_SEQ_CST,
+											  __ATOMIC_SEQ_CST ) ) {
+		// Nothing to send and the level started another packet meanwhile.
+		store.release( pkt );
+	}
+	pltf.packetUnlock();
+
+	if ( wake ) {
+		drainWake();
+	}
+}
+
+
+/* --------------------------------------------------------------------
+ *  Packet context: read once from the platform when a packet starts.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::stampContext( packet_t *pkt ) {
+	if constexpr ( !std::is_empty_v<context_t> ) {
+		context_t ctx = {};
+
+		pltf.getPacketContext( ctx );
+		pkt->setContext( ctx );
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Pre-arm the next packet: allocate and clear it outside the event
+ *  path.  Called from the drain side (getSendPacket, completions).
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::armNextPacket() {
+	packet_t *pkt = nullptr;
+
+	pltf.packetLock();
+	if ( nextPkt == nullptr ) {
+		pkt = store.allocate();
+	}
+	pltf.packetUnlock();
+
+	if ( pkt == nullptr ) {
+		return;
+	}
+
+	pkt->init( streamId, 0, 0 );
+
+	pltf.packetLock();
+	if ( nextPkt == nullptr ) {
+		nextPkt = pkt;
+	} else {
+		// Armed concurrently by another drain context.
+		store.release( pkt );
+	}
+	pltf.packetUnlock();
+}
+
+/* --------------------------------------------------------------------
+ *  Add an event to a packet.
+ *
+ *  An encoded payload keeps the previous values of its fields per level
+ *  in this collector: a level interrupting a push does not change the
+ *  state of the interrupted one, and the packet resets it when the event
+ *  goes to a new packet.  The state is copied in and out of the level
+ *  slot of the type, the slot only stores its bytes.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+template <IsEventType E>
+void basicEventCollector<Platform, Config, Store>::packetAdd( packet_t *pkt, E *evt, std::size_t level ) {
+	typedef typename E::param_t param_t;
+
+	if constexpr ( EventEncoded<param_t> ) {
+		typedef eventEncodeState<param_t> state_t;
+
+		static_assert( std::is_trivially_copyable_v<state_t> &&
+						   sizeof( state_t ) <= EventEncodeStateBytesMax,
+					   "delta fields of the event exceed EventEncodeStateBytesMax" );
+
+		std::size_t slot = eventEncodeSlot<param_t>();
+		state_t state;
+
+		// More encoded types than the config provides: count the loss.
+		if ( slot >= encodedTypesMax ) {
+			pkt->dropEvent();
+			return;
+		}
+
+		auto &raw = levels[ level ].encode[ slot ];
+		std::memcpy( &state, raw.data(), sizeof( state ) );
+		pkt->addEvent( evt, state );
+		std::memcpy( raw.data(), &state, sizeof( state ) );
+	} else {
+		static_assert( EventHeaderBytes + sizeof( param_t ) <= Config::eventSizeMax,
+					   "event does not fit eventSizeMax" );
+
+		pkt->addEvent( evt );
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Add an event to the collector.
+ *
+ *  1. Test the capture predicate of the event, if enabled.
+ *  2. Enter the level of the caller (event lock on the thread level).
+ *  3. Obtain or create the current packet of the level.
+ *  4. Acquire platform timestamp (unless provided) and store it in the event.
+ *  5. Add the event to the packet.
+ *  6. If the packet becomes full, enqueue it for sending.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+template <IsEventType E>
+bool basicEventCollector<Platform, Config, Store>::sendEvent( E *evt, const uint64_t *ts,
+															   const uint64_t *scopeStart ) {
+	std::size_t level = 0;
+	packet_t *curr	  = nullptr;
+	uint64_t _ts	  = 0;
+
+	// Filtered by its capture predicate or shed under load: not an
+	// overflow, nothing to count.
+	if ( !eventWhereAccepts( evt ) || !eventShedAccepts<E>( shedLevel ) ) {
+		return false;
+	}
+
+	// A level change is recorded ahead of the first event captured after it.
+	shedMarkerFlush( ts );
+
+	level = execLevel();
+	if ( !levelEnter( level ) ) {
+		// Another thread is pushing: count the loss on the packet.
+		curr = getCurrentPacket( level );
+		if ( curr != nullptr ) {
+			curr->dropEvent();
+		}
+		return false;
+	}
+
+	curr = getCurrentPacket( level );
+	if ( curr == nullptr ) {
+		levels[ level ].discarded++;
+		levelExit( level );
+		return false;
+	}
+
+	_ts = ( ts != nullptr ) ? *ts : pltf.getTimestamp();
+	evt->setTimestamp( _ts );
+	if constexpr ( requires { evt->getParam()->duration; } ) {
+		if ( scopeStart != nullptr ) {
+			evt->getParam()->duration = eventScopeDuration( _ts - *scopeStart );
+		}
+	}
+	packetAdd( curr, evt, level );
+
+	if ( curr->isPacketFull() ) {
+		sendPacket( level );
+	}
+	levelExit( level );
+	return true;
+}
+
+/* --------------------------------------------------------------------
+ *  Add one event of a batch.
+ *
+ *  The level is entered on the first event and the packet kept until it
+ *  fills, so the per event cost is the copy and the packet-full check.
+ *  When the event lock is busy the events are counted as dropped, like
+ *  with pushEvent().
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+template <IsEventType E>
+void basicEventCollector<Platform, Config, Store>::batchAdd( batch_t &batch, E *evt, uint64_t ts ) {
+	if ( !eventWhereAccepts( evt ) || !eventShedAccepts<E>( shedLevel ) ) {
+		return;
+	}
+
+	if ( !batch.locked && !batch.refused ) {
+		batch.locked  = levelEnter( batch.level );
+		batch.refused = !batch.locked;
+	}
+
+	if ( batch.curr == nullptr && !batch.exhausted ) {
+		batch.curr		= getCurrentPacket( batch.level );
+		batch.exhausted = ( batch.curr == nullptr );
+	}
+
+	if ( batch.curr == nullptr ) {
+		levels[ batch.level ].discarded++;
+		return;
+	}
+
+	if ( !batch.locked ) {
+		batch.curr->dropEvent();
+		return;
+	}
+
+	evt->setTimestamp( ts );
+	packetAdd( batch.curr, evt, batch.level );
+
+	if ( batch.curr->isPacketFull() ) {
+		batch.curr = nullptr;
+		sendPacket( batch.level );
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Leave the level still held at the end of a batch.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::batchEnd( batch_t &batch ) {
+	if ( batch.locked ) {
+		levelExit( batch.level );
+		batch.locked = false;
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Homogeneous batch with optional per event time offsets.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+template <IsEventType E, std::size_t Extent>
+void basicEventCollector<Platform, Config, Store>::pushEvents( std::span<E, Extent> evts,
+															   std::span<const uint32_t> deltas ) {
+	batch_t batch = {};
+	uint64_t ts	  = 0;
+
+	assert( deltas.empty() || deltas.size() == evts.size() );
+
+	shedMarkerFlush( nullptr );
+	ts = pltf.getTimestamp();
+
+	batch.level = execLevel();
+
+	for ( std::size_t i = 0; i < evts.size(); i++ ) {
+		batchAdd( batch, &evts[ i ], deltas.empty() ? ts : ts + deltas[ i ] );
+	}
+	batchEnd( batch );
+}
+
+/* --------------------------------------------------------------------
+ *  Load shedding controller.
+ *
+ *  One step per call: up when the ready queue or the pool reaches its
+ *  high watermark, down when both are at or below their low one.  Called
+ *  where the occupancy changes (packet queued, packet released), so the
+ *  level follows the drain without a timer.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::shedUpdate() {
+	if constexpr ( EventPacketStoreOccupancy<Store> ) {
+		std::size_t ready = 0;
+		std::size_t used  = 0;
+		uint8_t level	  = shedLevel.load( std::memory_order_relaxed );
+
+		if ( shedCfg.levelMax == 0 ) {
+			return;
+		}
+
+		ready = store.readyCount();
+		used  = store.usedCount();
+		if ( ( ready >= shedCfg.readyHigh || used >= shedCfg.usedHigh ) && level < shedCfg.levelMax ) {
+			shedSet( static_cast<uint8_t>( level + 1 ), ready, used );
+		} else if ( ready <= shedCfg.readyLow && used <= shedCfg.usedLow && level > 0 ) {
+			shedSet( static_cast<uint8_t>( level - 1 ), ready, used );
+		}
+	}
+}
+
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::shedSet( uint8_t level, std::size_t ready,
+															std::size_t used ) {
+	shedLast.level = level;
+	shedLast.ready = static_cast<uint32_t>( ready );
+	shedLast.used  = static_cast<uint32_t>( used );
+	shedLevel.store( level, std::memory_order_relaxed );
+	shedPending.store( true, std::memory_order_relaxed );
+}
+
+/* --------------------------------------------------------------------
+ *  Push the `evt_shed` marker of the last level change.  The marker is
+ *  claimed once; when it cannot be written (lock busy, pool exhausted)
+ *  it stays pending for the next event.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::shedMarkerFlush( const uint64_t *ts ) {
+	if ( !shedPending.load( std::memory_order_relaxed ) ||
+		 !shedPending.exchange( false, std::memory_order_relaxed ) ) {
+		return;
+	}
+
+	// A config with events smaller than the marker does not record it.
+	if constexpr ( EventHeaderBytes + sizeof( eventShedMarker ) <= Config::eventSizeMax ) {
+		Event<eventShedMarker> marker;
+
+		pltf.packetLock();
+		*marker.getParam() = shedLast;
+		pltf.packetUnlock();
+
+		if ( !sendEvent( &marker, ts ) ) {
+			shedPending.store( true, std::memory_order_relaxed );
+		}
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Configure the load shedding watermarks.  Lowering `levelMax` below
+ *  the current level applies at once, with its marker.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::setLoadShedding( const eventShedConfig &cfg ) {
+	static_assert( EventPacketStoreOccupancy<Store>, "load shedding needs a store reporting its occupancy" );
+
+	assert( cfg.levelMax <= eventShedLevelMax );
+	assert( cfg.levelMax == 0 || ( cfg.readyLow < cfg.readyHigh && cfg.usedLow < cfg.usedHigh ) );
+
+	pltf.packetLock();
+	shedCfg = cfg;
+	if ( shedLevel.load( std::memory_order_relaxed ) > cfg.levelMax ) {
+		shedSet( cfg.levelMax, store.readyCount(), store.usedCount() );
+	}
+	pltf.packetUnlock();
+}
+
+/* --------------------------------------------------------------------
+ *  Callback invoked when a previously sent packet has been processed.
+ *
+ *  The packet is returned to the pool so it can be reused.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::sendPacketCompleted() {
+	if ( sendPkt != nullptr ) {
+		pltf.packetLock();
+		store.release( sendPkt );
+		shedUpdate();
+		pltf.packetUnlock();
+
+		sendPkt = nullptr;
+	}
+
+	armNextPacket();
+}
+
+/* --------------------------------------------------------------------
+ *  If system stuck and not generating enough event to push packet for send.
+ *  In such scenario, call this API, this will force current packet to send
+ *  all collected event.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::forceSync( void ) {
+	std::size_t own = execLevel();
+	packet_t *curr	= levels[ own ].curr;
+
+	for ( std::size_t i = 0; i < execLevelMax; i++ ) {
+		if ( i != own ) {
+			flushLevel( i );
+		}
+	}
+
+	if ( curr == nullptr || curr->isEmpty() ) {
+		// No event to flush hence return early.
+		return;
+	}
+
+	sendPacket( own );
+}
+
+/* --------------------------------------------------------------------
+ *  Blocking drain.
+ *
+ *  The watermark and the parked flag are set under packetLock, where
+ *  every packet switch checks them, so a packet queued between the check
+ *  and the wait still wakes the drain (the hook keeps an early wake).
+ *  A spurious or stale wake only loops once more.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+std::size_t basicEventCollector<Platform, Config, Store>::waitForPackets( std::size_t minCount,
+																		  uint64_t timeoutTicks )
+	requires EventPlatformDrainWake<Platform> && EventPacketStoreOccupancy<Store>
+{
+	uint64_t start	  = pltf.getTimestamp();
+	uint64_t elapsed  = 0;
+	std::size_t ready = 0;
+
+	assert( minCount > 0 && minCount <= Config::packetCountMax );
+	assert( execLevel() == 0 );
+
+	for ( ;; ) {
+		pltf.packetLock();
+		ready		= store.readyCount();
+		drainMin	= minCount;
+		drainParked = ready < minCount;
+		pltf.packetUnlock();
+
+		if ( ready >= minCount ) {
+			return ready;
+		}
+
+		elapsed = pltf.getTimestamp() - start;
+		if ( timeoutTicks != 0 && elapsed >= timeoutTicks ) {
+			break;
+		}
+		pltf.drainWait( timeoutTicks != 0 ? timeoutTicks - elapsed : 0 );
+	}
+
+	// Flush timeout: hand over what the levels hold.
+	pltf.packetLock();
+	drainParked = false;
+	pltf.packetUnlock();
+
+	drainFlush();
+
+	pltf.packetLock();
+	ready = store.readyCount();
+	pltf.packetUnlock();
+	return ready;
+}
+
+/* --------------------------------------------------------------------
+ *  Wake decision of a packet switch.  Without the platform hook there is
+ *  never a parked drain and this folds away.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+bool basicEventCollector<Platform, Config, Store>::drainDue() {
+	if constexpr ( EventPlatformDrainWake<Platform> && EventPacketStoreOccupancy<Store> ) {
+		if ( !drainParked || store.readyCount() < drainMin ) {
+			return false;
+		}
+
+		drainParked = false;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::drainWake() {
+	if constexpr ( EventPlatformDrainWake<Platform> ) {
+		pltf.drainWake();
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Close the packets of every level from the drain thread.  Level 0 is
+ *  shared with the producer threads: its packet is only taken under the
+ *  event lock, otherwise it is left for the next wait.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::drainFlush() {
+	for ( std::size_t i = 1; i < execLevelMax; i++ ) {
+		flushLevel( i );
+	}
+
+	if ( pltf.eventTryLock() ) {
+		flushLevel( 0 );
+		pltf.eventUnlock();
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Context switch: an empty packet is simply re-stamped, otherwise it is
+ *  closed and the next packet starts with the new context.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::contextChanged( void ) {
+	if constexpr ( !std::is_empty_v<context_t> ) {
+		std::size_t level = execLevel();
+		packet_t *curr	  = levels[ level ].curr;
+
+		if ( curr == nullptr ) {
+			return;
+		}
+
+		if ( curr->isEmpty() ) {
+			stampContext( curr );
+			return;
+		}
+
+		sendPacket( level );
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Retrieve a ready‑to‑send packet for transmission.
+ *
+ *  If no packet is currently cached, pull one from the queue and
+ *  finalise it; the next packet is pre-armed on the way.  The
+ *  caller receives an optional byte span that points to the raw
+ *  packet buffer; if the queue was empty `std::nullopt` is returned.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+std::optional<std::span<const std::byte>> basicEventCollector<Platform, Config, Store>::getSendPacket() {
+	if ( sendPkt == nullptr ) {
+		armNextPacket();
+
+		pltf.packetLock();
+
+		auto *pkt = store.popReady();
+
+		pltf.packetUnlock();
+
+		if ( pkt == nullptr ) {
+			return std::nullopt;
+		}
+		pkt->buildPacketAtLastEvent();
+		sendPkt = pkt;
+	}
+
+	return std::optional<std::span<const std::byte>>( sendPkt->getPacketInRaw() );
+}
+
+/* --------------------------------------------------------------------
+ *  Register a consumer, nullopt when every slot is taken.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+std::optional<std::size_t> basicEventCollector<Platform, Config, Store>::addConsumer( uint32_t lagMax ) {
+	std::optional<std::size_t> id = std::nullopt;
+
+	pltf.packetLock();
+	// Packets queued so far belong to the consumers already there.
+	fanPump();
+	for ( std::size_t i = 0; i < consumerMax; i++ ) {
+		if ( !consumers[ i ].active ) {
+			consumers[ i ]		  = {};
+			consumers[ i ].cursor = fanHead;
+			consumers[ i ].lagMax = lagMax;
+			consumers[ i ].active = true;
+			id					  = i;
+			break;
+		}
+	}
+	pltf.packetUnlock();
+
+	return id;
+}
+
+/* --------------------------------------------------------------------
+ *  Drop a consumer with every packet it still references.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::removeConsumer( std::size_t id ) {
+	assert( id < consumerMax && consumers[ id ].active );
+
+	consumer_t &c = consumers[ id ];
+
+	pltf.packetLock();
+	if ( c.held != nullptr ) {
+		fanUnref( c.held );
+	}
+	for ( ; c.cursor != fanHead; c.cursor++ ) {
+		fanUnref( fanPkt[ c.cursor % Config::packetCountMax ] );
+	}
+	c = {};
+	pltf.packetUnlock();
+}
+
+/* --------------------------------------------------------------------
+ *  Next packet of one consumer.  The packet stays in the ring until the
+ *  consumer completes it, a retry returns the same one.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+std::optional<std::span<const std::byte>>
+basicEventCollector<Platform, Config, Store>::getSendPacket( std::size_t id ) {
+	assert( id < consumerMax && consumers[ id ].active );
+
+	consumer_t &c = consumers[ id ];
+	packet_t *pkt = nullptr;
+
+	armNextPacket();
+
+	pltf.packetLock();
+	if ( c.held == nullptr ) {
+		fanPump();
+		if ( c.cursor != fanHead ) {
+			c.held = fanPkt[ c.cursor % Config::packetCountMax ];
+			c.cursor++;
+		}
+	}
+	pkt = c.held;
+	pltf.packetUnlock();
+
+	if ( pkt == nullptr ) {
+		return std::nullopt;
+	}
+	return std::optional<std::span<const std::byte>>( pkt->getPacketInRaw() );
+}
+
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::sendPacketCompleted( std::size_t id ) {
+	assert( id < consumerMax && consumers[ id ].active );
+
+	consumer_t &c = consumers[ id ];
+
+	pltf.packetLock();
+	if ( c.held != nullptr ) {
+		fanUnref( c.held );
+		c.held = nullptr;
+	}
+	pltf.packetUnlock();
+
+	armNextPacket();
+}
+
+/* --------------------------------------------------------------------
+ *  Ready packets enter the ring finalised, referenced once per active
+ *  consumer.  The ring cannot overrun: the packets between the oldest
+ *  cursor and the head are all distinct pool packets.  A packet held by
+ *  a consumer skipped past it is out of that range, its slot may be
+ *  reused while its references are kept.  Without a consumer the
+ *  packets wait in the store for the first one.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::fanPump() {
+	uint8_t active = 0;
+
+	for ( const consumer_t &c : consumers ) {
+		active += c.active;
+	}
+	if ( active == 0 ) {
+		return;
+	}
+
+	for ( packet_t *pkt = store.popReady(); pkt != nullptr; pkt = store.popReady() ) {
+		std::size_t ref = 0;
+
+		// A pool packet is referenced at most once: a free entry is left.
+		while ( ref < Config::packetCountMax && fanRefs[ ref ] != 0 ) {
+			ref++;
+		}
+		assert( ref < Config::packetCountMax );
+
+		pkt->buildPacketAtLastEvent();
+		fanPkt[ fanHead % Config::packetCountMax ] = pkt;
+		fanRefPkt[ ref ]						   = pkt;
+		fanRefs[ ref ]							   = active;
+		fanHead++;
+	}
+
+	for ( consumer_t &c : consumers ) {
+		for ( ; c.active && c.lagMax != 0 && fanHead - c.cursor > c.lagMax; c.cursor++ ) {
+			fanUnref( fanPkt[ c.cursor % Config::packetCountMax ] );
+			c.lost++;
+		}
+	}
+}
+
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::fanUnref( packet_t *pkt ) {
+	std::size_t ref = 0;
+
+	while ( ref < Config::packetCountMax && ( fanRefs[ ref ] == 0 || fanRefPkt[ ref ] != pkt ) ) {
+		ref++;
+	}
+	assert( ref < Config::packetCountMax );
+
+	if ( --fanRefs[ ref ] == 0 ) {
+		store.release( pkt );
+		fanRefPkt[ ref ] = nullptr;
+		shedUpdate();
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Configure the stream identifier for packets.
+ *
+ *  The call must be idempotent – it is only legal to set the ID
+ *  once during initialization.  An assertion guards against misuse.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::setStreamId( uint32_t _streamId ) {
+	// either called 2 time or some error in init path.
+	assert( streamId == 0 );
+
+	streamId = _streamId;
+}
+
+/* --------------------------------------------------------------------
+ *  Attach the transport driver (push mode).
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::setTransport( eventTransport *_transport,
+																 uint64_t ackTimeoutTicks ) {
+	transport  = _transport;
+	ackTimeout = ackTimeoutTicks;
+
+	// Packets closed before the transport was attached.
+	transportPump();
+}
+
+/* --------------------------------------------------------------------
+ *  Fill free slots from the ready queue and offer pending packets.
+ *
+ *  The slot is marked submitted before the call, so a driver that
+ *  completes synchronously inside submit() finds it consistent.  The
+ *  lock is not held across submit() for the same reason.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::transportPump() {
+	if ( transport == nullptr ) {
+		return;
+	}
+
+	armNextPacket();
+
+	for ( std::size_t i = 0; i < inFlightMax; i++ ) {
+		inFlight_t &slot = inFlight[ i ];
+		packet_t *pkt	 = nullptr;
+		uint32_t token	 = 0;
+
+		pltf.packetLock();
+		if ( slot.pkt == nullptr ) {
+			slot.pkt = store.popReady();
+		}
+		if ( slot.pkt != nullptr && !slot.submitted ) {
+			pkt			   = slot.pkt;
+			token		   = ( slot.gen << 8 ) | static_cast<uint32_t>( i );
+			slot.submitted = true;
+			slot.submitTs  = pltf.getTimestamp();
+		}
+		pltf.packetUnlock();
+
+		if ( pkt == nullptr ) {
+			continue;
+		}
+
+		// Finalised here, off the event path (idempotent on a retry).
+		pkt->buildPacketAtLastEvent();
+		if ( !transport->submit( pkt->getPacketInRaw(), token ) ) {
+			// Driver busy: keep the packet in its slot, offered again later.
+			pltf.packetLock();
+			if ( slot.pkt == pkt && ( ( slot.gen << 8 ) | i ) == token ) {
+				slot.submitted = false;
+			}
+			pltf.packetUnlock();
+			break;
+		}
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Give the packet of a slot back to the pool.  Caller holds packetLock.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::transportFree( inFlight_t &slot ) {
+	store.release( slot.pkt );
+	slot.pkt	   = nullptr;
+	slot.submitted = false;
+	slot.gen++;
+	shedUpdate();
+}
+
+/* --------------------------------------------------------------------
+ *  Driver callback: the packet of `token` has been sent.
+ *
+ *  Stale tokens (packet already dropped on ack timeout) are ignored.
+ *  The freed slot takes the next ready packet.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::transportComplete( uint32_t token ) {
+	std::size_t idx = token & 0xFFU;
+
+	if ( idx >= inFlightMax ) {
+		return;
+	}
+
+	pltf.packetLock();
+	inFlight_t &slot = inFlight[ idx ];
+	if ( slot.pkt != nullptr && slot.submitted && ( slot.gen << 8 ) == ( token & ~0xFFU ) ) {
+		transportFree( slot );
+	}
+	pltf.packetUnlock();
+
+	transportPump();
+}
+
+/* --------------------------------------------------------------------
+ *  Periodic transport service.
+ *
+ *  Packets in flight for `ackTimeout` ticks or more are dropped: the
+ *  driver is told to cancel them and the buffer returns to the pool.
+ *  Then free slots are refilled and refused packets offered again.
+ * -------------------------------------------------------------------- */
+template <EventPlatformPolicy Platform, EventCollectorConfig Config, EventPacketStorePolicy Store>
+void basicEventCollector<Platform, Config, Store>::transportPoll( void ) {
+	if ( transport == nullptr ) {
+		return;
+	}
+
+	if ( ackTimeout != 0 ) {
+		for ( std::size_t i = 0; i < inFlightMax; i++ ) {
+			inFlight_t &slot = inFlight[ i ];
+			bool expired	 = false;
+			uint32_t token	 = 0;
+
+			pltf.packetLock();
+			// Clock read under the lock: never older than a submit time.
+			uint64_t now = pltf.getTimestamp();
+			if ( slot.pkt != nullptr && slot.submitted && now - slot.submitTs >= ackTimeout ) {
+				token	= ( slot.gen << 8 ) | static_cast<uint32_t>( i );
+				expired = true;
+				// Retire the token; the slot keeps the packet until cancel() returns.
+				slot.gen++;
+				ackTimeoutCount++;
+			}
+			pltf.packetUnlock();
+
+			if ( expired ) {
+				// The driver stops reading the buffer before the pool reuses it.
+				transport->cancel( token );
+
+				pltf.packetLock();
+				transportFree( slot );
+				pltf.packetUnlock();
+			}
+		}
+	}
+
+	transportPump();
+}
@@ -15,14 +15,20 @@
  * -------------------------------------------------------------------------- */
 #include <config.hpp>
 #include <event.hpp>
+#include <eventConfig.hpp>
+#include <eventEncoding.hpp>
 
 /* --------------------------------------------------------------------------
  *  Raw packet buffer layout
  *
- *  The struct is marked `packed` so that the memory representation matches
- *  what will be transmitted over the wire (no padding bytes).
+ *  The struct follows the event layout (see event.hpp): packed, or with
+ *  `timestamp_begin` on its 8 byte boundary and the payload on the event
+ *  boundary.  Either way the memory representation is what goes over the
+ *  wire.  The stream context fields follow `packet_seq_count`; without
+ *  context they take no space.
  * -------------------------------------------------------------------------- */
-typedef struct {
+template <std::size_t PayloadBytes, typename Context = eventNoContext>
+struct EVENT_LAYOUT_PACKED packetBuffer {
 	uint32_t stream_id;		   // ID of the originating stream
 	uint64_t timestamp_begin;  // Begining timestamp
 	uint64_t timestamp_end;	   // End timestamp
@@ -31,38 +37,121 @@ typedef struct {
 	uint32_t content_size;	   // size of the event payload only
 	uint32_t packet_seq_count; // sequence number for ordering packets
 
+	/* Platform context of every event in the packet (cpu, task, boot id...). */
+	[[no_unique_address]] Context context;
+
 	/* Fixed‑size buffer that will hold the concatenated raw bytes of all events. */
-	std::array<uint8_t, EVENT_MAX_PAYLOAD_IN_BYTES> eventPayload;
-} __attribute__( ( packed ) ) packet_buffer_t;
+	alignas( EventAlignment ) std::array<uint8_t, PayloadBytes> eventPayload;
+};
+
+/* --------------------------------------------------------------------------
+ *  Payload bytes of a packet of `Config`.  `eventSizeMax` bounds a whole
+ *  event, header included; aligned events also take the padding up to
+ *  the next event boundary.
+ * -------------------------------------------------------------------------- */
+template <EventCollectorConfig Config>
+inline constexpr std::size_t eventPacketPayloadBytes =
+	Config::eventMaxPerPacket * eventAlignUp( Config::eventSizeMax );
+
+/* Packet layout of the default configuration. */
+typedef packetBuffer<eventPacketPayloadBytes<eventDefaultConfig>> packet_buffer_t;
 
 /* --------------------------------------------------------------------------
- *  EventPacket – a small helper class that builds a packet from Events
+ *  basicEventPacket – a small helper class that builds a packet from Events
  *
+ *  The payload capacity comes from the collector configuration policy.
  *  It does not expose any public data members; everything is encapsulated.
  * -------------------------------------------------------------------------- */
-class eventPacket {
+template <EventCollectorConfig Config> class basicEventPacket {
+public:
+	/* Packet context fields of the stream. */
+	typedef typename eventConfigContext<Config>::type context_t;
+
+	/* Wire layout of this packet. */
+	typedef packetBuffer<eventPacketPayloadBytes<Config>, context_t> buffer_t;
+
+private:
 	/* Current offset inside the payload array where the next event will be copied. */
 	std::size_t currOffset;
 
 	/* Number of events already added to this packet. */
 	std::size_t eventCount;
 
+	/* Events copied as is, each counts as one of eventMaxPerPacket. */
+	std::size_t slotCount;
+
+	/* Timestamp of the newest event (packet begin time while empty). */
+	uint64_t lastTs;
+
+	/* Execution level (thread, IRQ...) that built the packet. */
+	uint32_t execLevel;
+
+	/* Bumped by init(): tells encoder state of a previous use apart. */
+	uint32_t generation;
+
 	/* The raw memory buffer that represents the packet. */
-	packet_buffer_t buffer;
+	buffer_t buffer;
 
 public:
-	eventPacket() = default;
-	~eventPacket();
+	basicEventPacket() = default;
+	~basicEventPacket();
 
 	/* Initialise a new packet with a stream identifier and a sequence number. */
 	void init( uint32_t streamId, uint32_t seqNo, uint64_t ts );
 
-	/* Return true if adding another event would overflow the payload array. */
+	/* Header fields of a packet initialised ahead of use (pre-armed). */
+	void start( uint32_t streamId, uint32_t seqNo, uint64_t ts ) {
+		buffer.stream_id		= streamId;
+		buffer.packet_seq_count = seqNo;
+		buffer.timestamp_begin	= ts;
+		lastTs					= ts;
+	}
+
+	/* Execution level owning the packet, 0 unless the platform nests levels. */
+	void setExecLevel( uint32_t level ) { execLevel = level; }
+	uint32_t getExecLevel() const { return execLevel; }
+
+	/* Context fields, written once per packet. */
+	void setContext( const context_t &ctx ) { buffer.context = ctx; }
+	const context_t &getContext() const { return buffer.context; }
+
+	/* True while no event has been added. */
+	bool isEmpty() const { return eventCount == 0; }
+
+	/* Timestamp of the newest event, packet begin time while empty. */
+	uint64_t getLastTimestamp() const { return lastTs; }
+
+	/* Begin time written in the header. */
+	uint64_t getBeginTimestamp() const { return buffer.timestamp_begin; }
+
+	/* Return true when eventMaxPerPacket events were copied, or when an
+	 * event of eventSizeMax would overflow the payload array. */
 	bool isPacketFull();
 
 	/* Add an Event to the packet; returns false if the packet is already full. */
 	bool addEvent( EventIntf *eventPtr );
 
+	/* Same as above for a concrete event type; the raw view is not a virtual call. */
+	template <IsEventType E> bool addEvent( E *eventPtr ) {
+		if ( !addEventRaw( eventPtr->getEventInRaw() ) ) {
+			return false;
+		}
+		// Scope events carry their exit time, keep the newest.
+		if ( eventPtr->getTimestamp() > lastTs ) {
+			lastTs = eventPtr->getTimestamp();
+		}
+		return true;
+	}
+
+	/* Same as above for an encoded payload (see eventEncoding.hpp); `state`
+	 * holds the previous values and starts over in a new packet. */
+	template <IsEventType E>
+		requires EventEncoded<typename E::param_t>
+	bool addEvent( E *eventPtr, eventEncodeState<typename E::param_t> &state );
+
+	/* Copy an already serialised event; returns false if the packet is already full. */
+	bool addEventRaw( std::span<const std::byte> eventPayload );
+
 	/* Increment the counter of dropped events (used when a packet overflows). */
 	void dropEvent() { buffer.events_discarded++; }
 
@@ -71,9 +160,22 @@ public:
 
 	/* Finalise the packet: compute sizes, set sequence numbers, etc. */
 	void buildPacket( uint64_t ts );
+
+	/* Bookkeeping sanity check, for a packet found in memory kept over a reset. */
+	bool isIntact() const;
+
+	/* Finalise a packet interrupted by a reset, ending at its newest event. */
+	void buildPacketAtLastEvent() { buildPacket( lastTs ); }
 };
 
 /* --------------------------------------------------------------------------
- *  Convenience typedef for an eventPacket pointer
+ *  Packet of the default configuration and convenience pointer typedef
  * -------------------------------------------------------------------------- */
+typedef basicEventPacket<eventDefaultConfig> eventPacket;
 typedef eventPacket *eventPacket_ptr_t;
+
+// include template implementation
+#include <internal/eventPacket.tpp>
+
+/* Default packet is instantiated once in the library. */
+extern template class basicEventPacket<eventDefaultConfig>;
@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <cstring>
+
+/* --------------------------------------------------------------------
+ * Destructor: Zero out the packet buffer when an eventPacket is destroyed.
+ * This helps avoid leaking sensitive information or leaving stale data in memory.
+ * -------------------------------------------------------------------- */
+template <EventCollectorConfig Config> basicEventPacket<Config>::~basicEventPacket() {
+	std::memset( &buffer, 0, sizeof( buffer ) );
+}
+
+/* --------------------------------------------------------------------
+ * Initialise a new packet with a stream identifier and sequence number.
+ * The internal offset counters are reset and the header fields are
+ * populated.  The payload area is cleared to ensure no leftover data
+ * from a previous use contaminates the new packet.
+ * -------------------------------------------------------------------- */
+template <EventCollectorConfig Config>
+void basicEventPacket<Config>::init( uint32_t streamId, uint32_t seqNo, uint64_t ts ) {
+	currOffset = 0;
+	eventCount = 0;
+	slotCount  = 0;
+	lastTs	   = ts;
+	generation++;
+
+	std::memset( &buffer, 0, sizeof( buffer ) );
+	buffer.stream_id		= streamId;
+	buffer.packet_seq_count = seqNo;
+	buffer.timestamp_begin	= ts;
+}
+
+/* --------------------------------------------------------------------
+ * Check whether the packet has reached its maximum number of events.
+ * Copied events take a slot each, so a packet of them holds
+ * eventMaxPerPacket events.  Encoded events take their bytes only: the
+ * packet is full when an event of eventSizeMax no longer fits.
+ * Returns true when no more events can be added; otherwise false.
+ * -------------------------------------------------------------------- */
+template <EventCollectorConfig Config> bool basicEventPacket<Config>::isPacketFull() {
+	if ( slotCount < Config::eventMaxPerPacket &&
+		 eventAlignUp( currOffset ) + Config::eventSizeMax <= buffer.eventPayload.size() ) {
+		return false;
+	}
+
+	return true;
+}
+
+/* --------------------------------------------------------------------
+ * Append a single event to the packet payload.
+ * The caller must have verified that the packet is not full.
+ * Returns true on success, false if the packet was already full.
+ * -------------------------------------------------------------------- */
+template <EventCollectorConfig Config>
+bool basicEventPacket<Config>::addEvent( EventIntf *eventPtr ) {
+	// Retrieve the raw, byte‑wise representation of the event.
+	return addEventRaw( eventPtr->getEventInRaw() );
+}
+
+/* --------------------------------------------------------------------
+ * Copies the raw byte representation of the event into the buffer
+ * and updates the offset/size counters accordingly.  In the aligned
+ * layout the event starts on the next event boundary, the skipped
+ * padding stays zero from init().
+ * -------------------------------------------------------------------- */
+template <EventCollectorConfig Config>
+bool basicEventPacket<Config>::addEventRaw( std::span<const std::byte> eventPayload ) {
+	std::size_t offset = eventAlignUp( currOffset );
+
+	// Prevent overflow: do not add when capacity is exhausted.
+	if ( isPacketFull() || offset + eventPayload.size() > buffer.eventPayload.size() ) {
+		return false;
+	}
+
+	// Copy the payload into the packet buffer at the current offset; the
+	// compiler may use aligned word stores when the boundary is known.
+	void *dst = &buffer.eventPayload[ offset ];
+	if constexpr ( EventAlignment > 1 ) {
+		dst = __builtin_assume_aligned( dst, EventAlignment );
+	}
+	std::memcpy( dst, eventPayload.data(), eventPayload.size() );
+
+	// Update bookkeeping values for next insertion.
+	currOffset = offset + eventPayload.size();
+	eventCount++;
+	slotCount++;
+
+	return true;
+}
+
+/* --------------------------------------------------------------------
+ * Serialise an event of an encoded payload: the header as is, then the
+ * fields written by the generated encoder.  The previous values are
+ * reset when `state` was last used by another packet, or by this one
+ * before its last init().
+ * -------------------------------------------------------------------- */
+template <EventCollectorConfig Config>
+template <IsEventType E>
+	requires EventEncoded<typename E::param_t>
+bool basicEventPacket<Config>::addEvent( E *eventPtr, eventEncodeState<typename E::param_t> &state ) {
+	typedef typename E::param_t param_t;
+
+	static_assert( EventHeaderBytes + EventEncoding<param_t>::bytesMax <= Config::eventSizeMax,
+				   "encoded event does not fit eventSizeMax" );
+
+	std::size_t offset = eventAlignUp( currOffset );
+	std::byte *dst	   = nullptr;
+	std::byte *end	   = nullptr;
+
+	if ( isPacketFull() ) {
+		return false;
+	}
+
+	if ( state.packet != this || state.generation != generation ) {
+		state.packet	 = this;
+		state.generation = generation;
+		state.prev		 = {};
+	}
+
+	dst = reinterpret_cast<std::byte *>( &buffer.eventPayload[ offset ] );
+	std::memcpy( dst, eventPtr->getEventInRaw().data(), EventHeaderBytes );
+	end = EventEncoding<param_t>::encode( *eventPtr->getParam(), state.prev, dst + EventHeaderBytes );
+
+	currOffset = static_cast<std::size_t>( end - reinterpret_cast<std::byte *>( buffer.eventPayload.data() ) );
+	eventCount++;
+
+	if ( eventPtr->getTimestamp() > lastTs ) {
+		lastTs = eventPtr->getTimestamp();
+	}
+	return true;
+}
+
+/* --------------------------------------------------------------------
+ * Finalise the packet by computing its size fields.
+ * The packet header is updated with total packet size (in bits)
+ * and the content size (header + payload, in bits).
+ * -------------------------------------------------------------------- */
+template <EventCollectorConfig Config> void basicEventPacket<Config>::buildPacket( uint64_t ts ) {
+	std::size_t hdrSize = 0;
+
+	hdrSize				 = sizeof( buffer ) - buffer.eventPayload.size();
+	buffer.packet_size	 = sizeof( buffer ) * 8;		 // convert to bit
+	buffer.content_size	 = ( hdrSize + currOffset ) * 8; // convert to bit
+	buffer.timestamp_end = ts;
+}
+
+/* --------------------------------------------------------------------
+ * Check the bookkeeping of a packet that was not built by this run.
+ * Offsets out of range would make buildPacket report a wrong size.
+ * -------------------------------------------------------------------- */
+template <EventCollectorConfig Config> bool basicEventPacket<Config>::isIntact() const {
+	return currOffset <= buffer.eventPayload.size() && slotCount <= eventCount &&
+		   slotCount <= Config::eventMaxPerPacket &&
+		   lastTs >= buffer.timestamp_begin;
+}
+
+/* --------------------------------------------------------------------
+ * Return the entire packet as a byte span.
+ * The caller can then transmit or otherwise process the raw data.
+ * -------------------------------------------------------------------- */
+template <EventCollectorConfig Config>
+std::span<const std::byte> basicEventPacket<Config>::getPacketInRaw() {
+	return std::as_bytes( std::span( &buffer, 1 ) );
+}
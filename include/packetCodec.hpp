@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+/* --------------------------------------------------------------------------
+ *  Packet compression stage
+ *
+ *  Optional step between `getSendPacket()` and the transport for
+ *  bandwidth limited links.  Every packet is wrapped in a frame; the frame
+ *  header tells the host whether the body is the plain CTF packet or the
+ *  compressed one (`tools/packet_decompress.py` restores plain packets for
+ *  babeltrace2).
+ *
+ *  Codec (`packetCodecLz`): LZ77 with varint lengths, close to LZ4 in cost.
+ *  A block is a list of sequences:
+ *
+ *      varint literalLen, literal bytes,
+ *      varint m            – 0 ends the block, else matchLen = m + 3
+ *      varint offset       – distance back in the output (overlap allowed)
+ *
+ *  Zero padding and repeated timestamp / id bytes of a CTF packet turn
+ *  into short matches.  No heap: the hash table and output live in the
+ *  caller provided scratch.
+ * -------------------------------------------------------------------------- */
+
+/* Frame magic, little endian on wire. */
+inline constexpr uint16_t PacketFrameMagic = 0xC7F1;
+
+/* Frame body encoding. */
+enum packetCodec : uint8_t {
+	packetCodecRaw = 0, // body is the plain CTF packet
+	packetCodecLz  = 1, // body is the compressed block
+};
+
+/* --------------------------------------------------------------------------
+ *  Frame header in front of every packet on wire.
+ * -------------------------------------------------------------------------- */
+typedef struct {
+	uint16_t magic;	   // PacketFrameMagic
+	uint8_t codec;	   // packetCodec
+	uint8_t reserved;  // zero
+	uint32_t bodySize; // bytes following the header
+	uint32_t rawSize;  // size of the plain CTF packet
+} __attribute__( ( packed ) ) packet_frame_t;
+
+/* Hash table entries used while compressing (scratch of the compressor). */
+inline constexpr std::size_t PacketCodecHashSize = 256;
+
+/* Largest packet the codec accepts, match positions are 16 bits. */
+inline constexpr std::size_t PacketCodecInputMax = 0xFFFF;
+
+/* --------------------------------------------------------------------
+ *  Compress `in` into `out`.
+ *  Returns the compressed size, or 0 when it does not fit in `out` (the
+ *  caller then sends the packet raw).
+ * -------------------------------------------------------------------- */
+std::size_t packetCodecCompress( std::span<const std::byte> in, std::span<std::byte> out,
+								 std::span<uint16_t, PacketCodecHashSize> hashTable );
+
+/* --------------------------------------------------------------------
+ *  Decompress a block into `out`.
+ *  Returns the decompressed size, or 0 on a corrupted block.
+ * -------------------------------------------------------------------- */
+std::size_t packetCodecDecompress( std::span<const std::byte> in, std::span<std::byte> out );
+
+/* --------------------------------------------------------------------------
+ *  packetCompressor – frames (and compresses) packets of up to
+ *  `MaxPacketBytes` in a bounded scratch buffer owned by the object.
+ *
+ *  The returned span is valid until the next `encode()` call.
+ * -------------------------------------------------------------------------- */
+template <std::size_t MaxPacketBytes> class packetCompressor {
+	static_assert( MaxPacketBytes <= PacketCodecInputMax, "packet too large for the codec" );
+
+	std::array<uint16_t, PacketCodecHashSize> hashTable;
+	std::array<std::byte, sizeof( packet_frame_t ) + MaxPacketBytes> scratch;
+
+public:
+	/* Frame one packet; compressed only when it is smaller than raw. */
+	std::span<const std::byte> encode( std::span<const std::byte> pkt ) {
+		packet_frame_t hdr		  = {};
+		std::span<std::byte> body = std::span( scratch ).subspan( sizeof( packet_frame_t ) );
+		std::size_t size		  = 0;
+
+		if ( pkt.size() > MaxPacketBytes ) {
+			return {};
+		}
+
+		// Leave one byte of gain at least, otherwise raw is cheaper to decode.
+		size = packetCodecCompress( pkt, body.first( pkt.size() - ( pkt.empty() ? 0 : 1 ) ),
+									hashTable );
+
+		hdr.magic = PacketFrameMagic;
+		if ( size == 0 ) {
+			hdr.codec = packetCodecRaw;
+			std::memcpy( body.data(), pkt.data(), pkt.size() );
+			size = pkt.size();
+		} else {
+			hdr.codec = packetCodecLz;
+		}
+		hdr.bodySize = static_cast<uint32_t>( size );
+		hdr.rawSize	 = static_cast<uint32_t>( pkt.size() );
+
+		std::memcpy( scratch.data(), &hdr, sizeof( hdr ) );
+
+		return std::span<const std::byte>( scratch.data(), sizeof( hdr ) + size );
+	}
+};
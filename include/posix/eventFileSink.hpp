@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <string>
+#include <vector>
+
+/* --------------------------------------------------------------------------
+ *  Rotating CTF trace directory sink (Linux / POSIX)
+ *
+ *  Writes drained packets as a CTF trace directory readable by babeltrace2:
+ *
+ *      <directory>/metadata            copy of the generated metadata
+ *      <directory>/stream<id>_<n>      segments of stream <id>
+ *      <directory>/stream<id>_l<l>_<n> segments of its exec level <l> > 0
+ *
+ *  The packets of each exec level have their own sequence numbers and
+ *  time range, so every (stream, level) pair gets its own file set.
+ *  Packets are copied into a per file set batch buffer and written with one
+ *  write() per batch.  A segment is preallocated (fallocate, file size
+ *  unchanged) and trimmed when closed.  A new segment starts when the
+ *  current one would exceed `segmentBytes` or is older than `segmentNs`.
+ *  Only the newest `retainSegments` segments of a file set are kept.
+ *  A failed write leaves the file at its last whole packet and keeps the
+ *  batch for the next write or flush.
+ *  Numbering resumes after the segments already in the directory.
+ *
+ *      eventFileSink sink;
+ *      sink.open( { .directory = "/var/trace", .metadataPath = "gen/metadata" } );
+ *      while ( running ) {
+ *          sink.drain( collector );
+ *      }
+ *      sink.close();
+ * -------------------------------------------------------------------------- */
+
+/* --------------------------------------------------------------------------
+ *  Sink configuration.
+ * -------------------------------------------------------------------------- */
+typedef struct {
+	const char *directory	 = nullptr;	   // created when missing
+	const char *metadataPath = nullptr;	   // generated CTF metadata, copied once
+	uint64_t segmentBytes	 = 64 << 20;   // rotation size, also preallocated
+	uint64_t segmentNs		 = 0;		   // rotation age, 0: size only
+	uint32_t retainSegments	 = 0;		   // segments kept per file set, 0: all
+	uint32_t batchBytes		 = 256 << 10;  // buffered bytes per write()
+	uint64_t syncBytes		 = 0;		   // fdatasync period, 0: on rotate and close
+} eventFileSinkConfig;
+
+/* --------------------------------------------------------------------------
+ *  eventFileSink – packets to rotating segment files, one set per stream
+ *  and exec level.
+ * -------------------------------------------------------------------------- */
+class eventFileSink {
+	typedef struct {
+		uint32_t streamId;
+		uint32_t level;
+		int fd;
+		uint64_t segment;		   // number of the open segment
+		uint64_t nextSegment;	   // number of the next segment
+		uint64_t written;		   // bytes in the open segment, batch included
+		uint64_t unsynced;		   // bytes written since the last fdatasync
+		uint64_t openedNs;		   // open time of the segment
+		std::deque<uint64_t> kept; // closed segments still on disk, oldest first
+		std::vector<std::byte> batch;
+	} stream_t;
+
+	eventFileSinkConfig cfg;
+	std::string dir;
+	std::vector<stream_t> streams;
+	bool opened		= false;
+	bool syncFailed = false; // a periodic fdatasync failed, reported by flush() / close()
+
+	stream_t *findStream( uint32_t streamId, uint32_t level );
+	std::string segmentName( const stream_t &s ) const;
+	std::string segmentPath( const stream_t &s, uint64_t segment ) const;
+	bool openSegment( stream_t &s );
+	bool closeSegment( stream_t &s, bool force );
+	bool writeBatch( stream_t &s );
+	bool writeAll( stream_t &s, const std::byte *data, std::size_t bytes );
+	void syncDue( stream_t &s );
+	void scanSegments( stream_t &s );
+
+public:
+	eventFileSink() = default;
+	~eventFileSink();
+
+	eventFileSink( const eventFileSink & )			  = delete;
+	eventFileSink &operator=( const eventFileSink & ) = delete;
+
+	/* Create the directory and copy the metadata. */
+	bool open( const eventFileSinkConfig &config );
+
+	/* Append one packet to the segment of its stream (header stream_id) and
+	 * exec level (see basicEventCollector::getSendPacketLevel()). */
+	bool write( std::span<const std::byte> pkt, uint32_t level = 0 );
+
+	/* Write the pending batches and fdatasync the open segments. */
+	bool flush();
+
+	/* Flush, trim and close every segment.  Returns false when a batch
+	 * could not be written; its packets are lost. */
+	bool close();
+
+	/* Move every ready packet of `collector` to the sink; a packet the sink
+	 * could not take stays with the collector.  Returns the packets moved. */
+	template <typename Collector> std::size_t drain( Collector &collector ) {
+		std::size_t count = 0;
+
+		for ( auto pkt = collector.getSendPacket(); pkt.has_value(); pkt = collector.getSendPacket() ) {
+			if ( !write( pkt.value(), static_cast<uint32_t>( collector.getSendPacketLevel() ) ) ) {
+				break;
+			}
+			collector.sendPacketCompleted();
+			count++;
+		}
+
+		return count;
+	}
+
+	/* Same as above for one consumer of a fan-out collector. */
+	template <typename Collector> std::size_t drain( Collector &collector, std::size_t consumer ) {
+		std::size_t count = 0;
+
+		for ( auto pkt = collector.getSendPacket( consumer ); pkt.has_value();
+			  pkt	   = collector.getSendPacket( consumer ) ) {
+			if ( !write( pkt.value(), static_cast<uint32_t>( collector.getSendPacketLevel( consumer ) ) ) ) {
+				break;
+			}
+			collector.sendPacketCompleted( consumer );
+			count++;
+		}
+
+		return count;
+	}
+};
@@ -0,0 +1,293 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <span>
+
+#include <pthread.h>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <basicEventCollector.hpp>
+#include <eventConfig.hpp>
+#include <eventPacketStore.hpp>
+
+/* --------------------------------------------------------------------------
+ *  Shared memory packet store (Linux / POSIX)
+ *
+ *  The packet pool and the ready queue of a collector are placed in a
+ *  POSIX shared memory object.  The traced process only builds packets;
+ *  a separate daemon maps the same object and drains ready packets with
+ *  zero copy (`eventShmReader`).  Packets already in the ready queue stay
+ *  in the object when the traced process crashes; the packet being built
+ *  at that moment is lost.
+ *
+ *  Layout of the object:
+ *
+ *      eventShmHeader          magic, geometry, process shared locks
+ *      eventPacketStore<Cfg>   pool + ready queue (indices only)
+ *
+ *  Locks are robust process shared mutexes, so a lock held by a crashed
+ *  process is recovered by the next locker.  A process dying under the
+ *  packet lock may leave the ready queue half updated: the next locker
+ *  marks the store damaged and the store is repaired before its next use
+ *  (eventPacketStore::repair()).
+ * -------------------------------------------------------------------------- */
+
+/* "EVSH", little endian. */
+inline constexpr uint32_t EventShmMagic	  = 0x48535645;
+inline constexpr uint32_t EventShmVersion = 2;
+
+/* --------------------------------------------------------------------------
+ *  Header at offset 0 of the shared object.
+ * -------------------------------------------------------------------------- */
+typedef struct {
+	uint32_t magic;			// EventShmMagic, written last on create
+	uint32_t version;		// EventShmVersion
+	uint32_t packetBytes;	// sizeof one packet object
+	uint32_t packetCount;	// packets in the pool
+	uint64_t storeBytes;	// sizeof the packet store following the header
+	uint32_t storeDamaged;	// packetMutex owner died, store not repaired yet
+	pthread_mutex_t packetMutex; // guards pool and ready queue
+	pthread_mutex_t eventMutex;	 // guards the packet being built
+} eventShmHeader;
+
+/* --------------------------------------------------------------------------
+ *  eventShmMapping – owns one mapping of a shared memory object.
+ * -------------------------------------------------------------------------- */
+class eventShmMapping {
+	void *base		 = nullptr;
+	std::size_t size = 0;
+
+public:
+	eventShmMapping() = default;
+	~eventShmMapping();
+
+	eventShmMapping( const eventShmMapping & )			  = delete;
+	eventShmMapping &operator=( const eventShmMapping & ) = delete;
+
+	/* Create (or reset) object `name` of `bytes` bytes and map it. */
+	bool create( const char *name, std::size_t bytes );
+
+	/* Map an existing object, false when missing or smaller than `minBytes`. */
+	bool open( const char *name, std::size_t minBytes );
+
+	void close();
+
+	/* Remove the object name, existing mappings stay valid. */
+	static void unlink( const char *name );
+
+	void *data() const noexcept { return base; }
+	std::size_t bytes() const noexcept { return size; }
+
+	/* Robust, process shared mutex helpers.  mutexLock() returns true
+	 * when the previous owner died holding the lock. */
+	static void mutexInit( pthread_mutex_t *mtx );
+	static bool mutexLock( pthread_mutex_t *mtx );
+	static bool mutexTryLock( pthread_mutex_t *mtx );
+	static void mutexUnlock( pthread_mutex_t *mtx );
+};
+
+/* --------------------------------------------------------------------------
+ *  eventShmPlatform – collector platform policy on the shared locks.
+ *
+ *  Clock is CLOCK_MONOTONIC in nanoseconds so that the daemon and the
+ *  traced process agree on the time base.
+ * -------------------------------------------------------------------------- */
+class eventShmPlatform {
+	eventShmHeader *hdr = nullptr;
+
+public:
+	eventShmPlatform() = default;
+	explicit eventShmPlatform( eventShmHeader *_hdr ) : hdr( _hdr ) {}
+
+	uint64_t getTimestamp();
+	bool eventTryLock() { return eventShmMapping::mutexTryLock( &hdr->eventMutex ); }
+	void eventUnlock() { eventShmMapping::mutexUnlock( &hdr->eventMutex ); }
+	void packetLock() {
+		if ( eventShmMapping::mutexLock( &hdr->packetMutex ) ) {
+			hdr->storeDamaged = 1;
+		}
+	}
+	void packetUnlock() { eventShmMapping::mutexUnlock( &hdr->packetMutex ); }
+};
+
+/* --------------------------------------------------------------------------
+ *  Repair the store when a process died under the packet lock.  Caller
+ *  holds packetMutex.
+ * -------------------------------------------------------------------------- */
+template <EventCollectorConfig Config>
+inline void eventShmRepair( eventShmHeader *hdr, eventPacketStore<Config> *store ) {
+	if ( hdr->storeDamaged != 0 ) {
+		store->repair();
+		hdr->storeDamaged = 0;
+	}
+}
+
+/* --------------------------------------------------------------------------
+ *  eventShmStore – collector store policy forwarding to the shared store.
+ * -------------------------------------------------------------------------- */
+template <EventCollectorConfig Config> class eventShmStore {
+public:
+	typedef basicEventPacket<Config> packet_t;
+
+private:
+	eventShmHeader *hdr				= nullptr;
+	eventPacketStore<Config> *store = nullptr;
+
+public:
+	eventShmStore() = default;
+	eventShmStore( eventShmHeader *_hdr, eventPacketStore<Config> *_store ) : hdr( _hdr ), store( _store ) {}
+
+	packet_t *allocate() {
+		eventShmRepair( hdr, store );
+		return store->allocate();
+	}
+	void release( packet_t *pkt ) {
+		eventShmRepair( hdr, store );
+		store->release( pkt );
+	}
+	bool pushReady( packet_t *pkt ) {
+		eventShmRepair( hdr, store );
+		return store->pushReady( pkt );
+	}
+	packet_t *popReady() {
+		eventShmRepair( hdr, store );
+		return store->popReady();
+	}
+
+	/* Occupancy of the shared store, both processes included. */
+	std::size_t readyCount() const { return store->readyCount(); }
+	std::size_t usedCount() { return store->usedCount(); }
+};
+
+/* --------------------------------------------------------------------------
+ *  eventShmRegion – typed view of the shared object.
+ *
+ *  Producer:
+ *
+ *      eventShmRegion<cfg> region;
+ *      region.create( "/evt_main" );
+ *      eventShmCollector<cfg> collector( region.platform(), region.packetStore() );
+ *
+ *  Daemon: `eventShmReader<cfg>` below.
+ * -------------------------------------------------------------------------- */
+template <EventCollectorConfig Config> class eventShmRegion {
+	typedef struct {
+		eventShmHeader hdr;
+		eventPacketStore<Config> store;
+	} layout_t;
+
+	eventShmMapping map;
+	layout_t *layout = nullptr;
+
+public:
+	/* Create the object and build an empty store in it. */
+	bool create( const char *name ) {
+		if ( !map.create( name, sizeof( layout_t ) ) ) {
+			return false;
+		}
+
+		layout = static_cast<layout_t *>( map.data() );
+		new ( &layout->store ) eventPacketStore<Config>();
+
+		layout->hdr.version		= EventShmVersion;
+		layout->hdr.packetBytes = sizeof( typename eventPacketStore<Config>::packet_t );
+		layout->hdr.packetCount = Config::packetCountMax;
+		layout->hdr.storeBytes	= sizeof( eventPacketStore<Config> );
+		eventShmMapping::mutexInit( &layout->hdr.packetMutex );
+		eventShmMapping::mutexInit( &layout->hdr.eventMutex );
+
+		__atomic_store_n( &layout->hdr.magic, EventShmMagic, __ATOMIC_RELEASE );
+		return true;
+	}
+
+	/* Map an object created with the same configuration. */
+	bool open( const char *name ) {
+		if ( !map.open( name, sizeof( layout_t ) ) ) {
+			return false;
+		}
+
+		layout = static_cast<layout_t *>( map.data() );
+		if ( __atomic_load_n( &layout->hdr.magic, __ATOMIC_ACQUIRE ) != EventShmMagic ||
+			 layout->hdr.version != EventShmVersion ||
+			 layout->hdr.packetBytes != sizeof( typename eventPacketStore<Config>::packet_t ) ||
+			 layout->hdr.packetCount != Config::packetCountMax ||
+			 layout->hdr.storeBytes != sizeof( eventPacketStore<Config> ) ) {
+			// Created by another configuration or still being created.
+			layout = nullptr;
+			map.close();
+			return false;
+		}
+
+		return true;
+	}
+
+	eventShmHeader *header() const noexcept { return &layout->hdr; }
+	eventPacketStore<Config> *store() const noexcept { return &layout->store; }
+
+	eventShmPlatform platform() const { return eventShmPlatform( header() ); }
+	eventShmStore<Config> packetStore() const { return eventShmStore<Config>( header(), store() ); }
+};
+
+/* Collector building its packets in a shared region. */
+template <EventCollectorConfig Config>
+using eventShmCollector = basicEventCollector<eventShmPlatform, Config, eventShmStore<Config>>;
+
+/* --------------------------------------------------------------------------
+ *  eventShmReader – daemon side, drains ready packets of a region.
+ *
+ *  Same contract as the collector: `getSendPacket()` returns a span into
+ *  the shared object (no copy) that stays valid until
+ *  `sendPacketCompleted()` gives the packet back to the producer.
+ * -------------------------------------------------------------------------- */
+template <EventCollectorConfig Config> class eventShmReader {
+	typedef typename eventPacketStore<Config>::packet_t packet_t;
+
+	eventShmRegion<Config> region;
+	packet_t *sendPkt = nullptr;
+
+	void lock() {
+		region.platform().packetLock();
+		eventShmRepair( region.header(), region.store() );
+	}
+
+public:
+	bool open( const char *name ) { return region.open( name ); }
+
+	std::optional<std::span<const std::byte>> getSendPacket() {
+		if ( sendPkt == nullptr ) {
+			lock();
+			sendPkt = region.store()->popReady();
+			eventShmMapping::mutexUnlock( &region.header()->packetMutex );
+
+			if ( sendPkt == nullptr ) {
+				return std::nullopt;
+			}
+			sendPkt->buildPacketAtLastEvent();
+		}
+
+		return std::optional<std::span<const std::byte>>( sendPkt->getPacketInRaw() );
+	}
+
+	void sendPacketCompleted() {
+		if ( sendPkt != nullptr ) {
+			lock();
+			region.store()->release( sendPkt );
+			eventShmMapping::mutexUnlock( &region.header()->packetMutex );
+
+			sendPkt = nullptr;
+		}
+	}
+
+	/* Packets waiting in the region. */
+	std::size_t readyCount() const { return region.store()->readyCount(); }
+};
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <cstdint>
+
+/* --------------------------------------------------------------------------
+ *  Drain wake hook on an eventfd (Linux)
+ *
+ *  Backs the optional drainWait() / drainWake() of a platform policy (see
+ *  EventPlatformDrainWake in basicEventCollector.hpp).  The eventfd
+ *  counts, so a wake given before the wait is kept; a wait consumes every
+ *  pending wake.  Timeouts are in nanoseconds, a platform with another
+ *  clock converts its ticks:
+ *
+ *      struct myPlatform {
+ *          eventWakeFd *wake;
+ *          ...
+ *          void drainWait( uint64_t ticks ) { wake->wait( ticks ); }
+ *          void drainWake() { wake->wake(); }
+ *      };
+ * -------------------------------------------------------------------------- */
+class eventWakeFd {
+	int fd = -1;
+
+public:
+	eventWakeFd();
+	~eventWakeFd();
+
+	eventWakeFd( const eventWakeFd & )			  = delete;
+	eventWakeFd &operator=( const eventWakeFd & ) = delete;
+
+	/* False when the eventfd could not be created. */
+	bool valid() const { return fd >= 0; }
+
+	/* Park until a wake or `timeoutNs` (0 = no timeout); true when woken. */
+	bool wait( uint64_t timeoutNs );
+
+	/* Wake the waiter, or the next wait; async signal safe. */
+	void wake();
+};
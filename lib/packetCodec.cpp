@@ -0,0 +1,198 @@
+/*********************************************************************
+ *  Packet codec implementation
+ *
+ *  Small LZ77 codec for CTF packets (see packetCodec.hpp for the
+ *  block format).  Greedy matching with a 4 byte hash, no heap; the
+ *  hash table is provided by the caller.
+ *********************************************************************/
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <cstring>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <packetCodec.hpp>
+
+using namespace std;
+
+/* Shortest match worth encoding. */
+static constexpr size_t matchMin = 4;
+
+/* --------------------------------------------------------------------
+ *  Hash of the 4 bytes at `p` into the table index range.
+ * -------------------------------------------------------------------- */
+static inline size_t hash4( const byte *p ) {
+	uint32_t v = 0;
+
+	memcpy( &v, p, sizeof( v ) );
+	return ( v * 2654435761u ) >> 24; // 8 bit index
+}
+
+static_assert( PacketCodecHashSize == 256, "hash4 produces an 8 bit index" );
+
+/* --------------------------------------------------------------------
+ *  Append a varint (7 bits per byte, LSB first).
+ *  Returns false when `out` is full.
+ * -------------------------------------------------------------------- */
+static bool putVarint( span<byte> out, size_t &pos, size_t value ) {
+	do {
+		uint8_t b = value & 0x7F;
+
+		value >>= 7;
+		if ( value != 0 ) {
+			b |= 0x80;
+		}
+
+		if ( pos >= out.size() ) {
+			return false;
+		}
+		out[ pos++ ] = static_cast<byte>( b );
+	} while ( value != 0 );
+
+	return true;
+}
+
+/* --------------------------------------------------------------------
+ *  Read a varint.  Returns false on truncated input.
+ * -------------------------------------------------------------------- */
+static bool getVarint( span<const byte> in, size_t &pos, size_t &value ) {
+	size_t shift = 0;
+
+	value = 0;
+	while ( pos < in.size() && shift < ( sizeof( size_t ) * 8 ) ) {
+		uint8_t b = static_cast<uint8_t>( in[ pos++ ] );
+
+		value |= static_cast<size_t>( b & 0x7F ) << shift;
+		if ( ( b & 0x80 ) == 0 ) {
+			return true;
+		}
+		shift += 7;
+	}
+
+	return false;
+}
+
+/* --------------------------------------------------------------------
+ *  Emit one sequence: literals, then the match (m == 0 ends block).
+ * -------------------------------------------------------------------- */
+static bool putSequence( span<byte> out, size_t &pos, span<const byte> literal, size_t matchLen,
+						 size_t offset ) {
+	if ( !putVarint( out, pos, literal.size() ) ) {
+		return false;
+	}
+
+	if ( ( out.size() - pos ) < literal.size() ) {
+		return false;
+	}
+	memcpy( out.data() + pos, literal.data(), literal.size() );
+	pos += literal.size();
+
+	if ( matchLen == 0 ) {
+		return putVarint( out, pos, 0 );
+	}
+
+	return putVarint( out, pos, matchLen - ( matchMin - 1 ) ) && putVarint( out, pos, offset );
+}
+
+/* --------------------------------------------------------------------
+ *  Compress a packet.
+ *
+ *  Greedy: at each position look up the last position with the same
+ *  4 byte hash, extend the match as far as it goes, otherwise keep
+ *  the byte as literal.
+ * -------------------------------------------------------------------- */
+size_t packetCodecCompress( span<const byte> in, span<byte> out,
+							span<uint16_t, PacketCodecHashSize> hashTable ) {
+	size_t ip	  = 0; // input position
+	size_t anchor = 0; // first pending literal
+	size_t op	  = 0; // output position
+
+	if ( in.size() > PacketCodecInputMax ) {
+		return 0;
+	}
+
+	// 0xFFFF marks an empty slot, it can never be a match start.
+	for ( auto &slot : hashTable ) {
+		slot = 0xFFFF;
+	}
+
+	while ( ( ip + matchMin ) <= in.size() ) {
+		size_t h		 = hash4( in.data() + ip );
+		size_t candidate = hashTable[ h ];
+		size_t len		 = 0;
+
+		hashTable[ h ] = static_cast<uint16_t>( ip );
+
+		if ( candidate == 0xFFFF || memcmp( in.data() + candidate, in.data() + ip, matchMin ) != 0 ) {
+			ip++;
+			continue;
+		}
+
+		len = matchMin;
+		while ( ( ip + len ) < in.size() && in[ candidate + len ] == in[ ip + len ] ) {
+			len++;
+		}
+
+		if ( !putSequence( out, op, in.subspan( anchor, ip - anchor ), len, ip - candidate ) ) {
+			return 0;
+		}
+
+		ip += len;
+		anchor = ip;
+	}
+
+	// Trailing literals and end of block.
+	if ( !putSequence( out, op, in.subspan( anchor ), 0, 0 ) ) {
+		return 0;
+	}
+
+	return op;
+}
+
+/* --------------------------------------------------------------------
+ *  Decompress a block, bounds checked against both spans.
+ * -------------------------------------------------------------------- */
+size_t packetCodecDecompress( span<const byte> in, span<byte> out ) {
+	size_t ip = 0;
+	size_t op = 0;
+
+	while ( true ) {
+		size_t litLen = 0;
+		size_t m	  = 0;
+		size_t offset = 0;
+
+		if ( !getVarint( in, ip, litLen ) ) {
+			return 0;
+		}
+		if ( litLen > ( in.size() - ip ) || litLen > ( out.size() - op ) ) {
+			return 0;
+		}
+		memcpy( out.data() + op, in.data() + ip, litLen );
+		ip += litLen;
+		op += litLen;
+
+		if ( !getVarint( in, ip, m ) ) {
+			return 0;
+		}
+		if ( m == 0 ) {
+			return op;
+		}
+
+		if ( !getVarint( in, ip, offset ) ) {
+			return 0;
+		}
+
+		size_t len = m + ( matchMin - 1 );
+		if ( offset == 0 || offset > op || len > ( out.size() - op ) ) {
+			return 0;
+		}
+
+		// Byte copy: overlapping matches repeat the last `offset` bytes.
+		for ( size_t i = 0; i < len; i++, op++ ) {
+			out[ op ] = out[ op - offset ];
+		}
+	}
+}
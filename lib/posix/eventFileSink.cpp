@@ -0,0 +1,363 @@
+/*********************************************************************
+ *  Rotating CTF trace directory sink – segment files on POSIX
+ *
+ *  Batching, rotation and retention of the per stream and level segment files
+ *  written by `eventFileSink`.
+ *********************************************************************/
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <posix/eventFileSink.hpp>
+
+/* Monotonic clock in nanoseconds, segment age. */
+static uint64_t sinkNow() {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+
+	return static_cast<uint64_t>( ts.tv_sec ) * 1000000000ULL + static_cast<uint64_t>( ts.tv_nsec );
+}
+
+/* mkdir -p. */
+static bool sinkMakeDir( const std::string &path ) {
+	for ( std::size_t pos = path.find( '/', 1 ); ; pos = path.find( '/', pos + 1 ) ) {
+		std::string part = path.substr( 0, pos );
+
+		if ( mkdir( part.c_str(), 0755 ) != 0 && errno != EEXIST ) {
+			return false;
+		}
+		if ( pos == std::string::npos ) {
+			return true;
+		}
+	}
+}
+
+/* Whole file copy through a temporary name, readers never see half of it. */
+static bool sinkCopyFile( const char *from, const std::string &to ) {
+	std::string tmp = to + ".tmp";
+	FILE *in		= fopen( from, "rb" );
+	FILE *out		= nullptr;
+	char buf[ 4096 ];
+	std::size_t len = 0;
+	bool ok			= true;
+
+	if ( in == nullptr ) {
+		return false;
+	}
+
+	out = fopen( tmp.c_str(), "wb" );
+	if ( out == nullptr ) {
+		fclose( in );
+		return false;
+	}
+
+	while ( ok && ( len = fread( buf, 1, sizeof( buf ), in ) ) > 0 ) {
+		ok = fwrite( buf, 1, len, out ) == len;
+	}
+
+	ok = ok && !ferror( in );
+	fclose( in );
+	ok = ( fclose( out ) == 0 ) && ok;
+
+	return ok && rename( tmp.c_str(), to.c_str() ) == 0;
+}
+
+eventFileSink::~eventFileSink() { close(); }
+
+/* --------------------------------------------------------------------
+ *  Create the trace directory and place the metadata in it.
+ * -------------------------------------------------------------------- */
+bool eventFileSink::open( const eventFileSinkConfig &config ) {
+	close();
+
+	if ( config.directory == nullptr || config.segmentBytes == 0 ) {
+		return false;
+	}
+
+	cfg = config;
+	dir = config.directory;
+
+	if ( !sinkMakeDir( dir ) ) {
+		return false;
+	}
+
+	if ( cfg.metadataPath != nullptr && !sinkCopyFile( cfg.metadataPath, dir + "/metadata" ) ) {
+		return false;
+	}
+
+	opened = true;
+	return true;
+}
+
+/* --------------------------------------------------------------------
+ *  File set of `streamId` and exec `level`, added on its first packet.
+ * -------------------------------------------------------------------- */
+eventFileSink::stream_t *eventFileSink::findStream( uint32_t streamId, uint32_t level ) {
+	for ( stream_t &s : streams ) {
+		if ( s.streamId == streamId && s.level == level ) {
+			return &s;
+		}
+	}
+
+	stream_t &s	   = streams.emplace_back();
+	s.streamId	   = streamId;
+	s.level		   = level;
+	s.fd		   = -1;
+	s.segment	   = 0;
+	s.nextSegment  = 0;
+	s.written	   = 0;
+	s.unsynced	   = 0;
+	s.openedNs	   = 0;
+	s.batch.reserve( cfg.batchBytes );
+	scanSegments( s );
+
+	return &s;
+}
+
+/* Segment name prefix: `stream<id>_`, `stream<id>_l<level>_` above level 0. */
+std::string eventFileSink::segmentName( const stream_t &s ) const {
+	char name[ 40 ];
+
+	if ( s.level == 0 ) {
+		snprintf( name, sizeof( name ), "stream%u_", s.streamId );
+	} else {
+		snprintf( name, sizeof( name ), "stream%u_l%u_", s.streamId, s.level );
+	}
+	return name;
+}
+
+std::string eventFileSink::segmentPath( const stream_t &s, uint64_t segment ) const {
+	char num[ 24 ];
+
+	snprintf( num, sizeof( num ), "%06llu", static_cast<unsigned long long>( segment ) );
+	return dir + "/" + segmentName( s ) + num;
+}
+
+/* --------------------------------------------------------------------
+ *  Segments a previous run left for the stream: they count against the
+ *  retention and numbering continues after the last one.
+ * -------------------------------------------------------------------- */
+void eventFileSink::scanSegments( stream_t &s ) {
+	std::string prefix = segmentName( s );
+	DIR *d			   = opendir( dir.c_str() );
+	struct dirent *ent;
+
+	if ( d == nullptr ) {
+		return;
+	}
+
+	while ( ( ent = readdir( d ) ) != nullptr ) {
+		char *end = nullptr;
+
+		if ( strncmp( ent->d_name, prefix.c_str(), prefix.size() ) != 0 || ent->d_name[ prefix.size() ] == '\0' ) {
+			continue;
+		}
+
+		// Digits only: `stream1_` does not take the `stream1_l1_` segments.
+		unsigned long long n = strtoull( ent->d_name + prefix.size(), &end, 10 );
+		if ( *end == '\0' && isdigit( static_cast<unsigned char>( ent->d_name[ prefix.size() ] ) ) ) {
+			s.kept.push_back( n );
+		}
+	}
+	closedir( d );
+
+	std::sort( s.kept.begin(), s.kept.end() );
+	s.nextSegment = s.kept.empty() ? 0 : s.kept.back() + 1;
+}
+
+/* --------------------------------------------------------------------
+ *  Open the next segment, preallocated without changing the file size
+ *  (a crash leaves only whole packets), and apply the retention.
+ * -------------------------------------------------------------------- */
+bool eventFileSink::openSegment( stream_t &s ) {
+	std::string path = segmentPath( s, s.nextSegment );
+
+	s.fd = ::open( path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+	if ( s.fd < 0 ) {
+		return false;
+	}
+
+	// Best effort: tmpfs and some file systems do not support it.
+	( void ) fallocate( s.fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>( cfg.segmentBytes ) );
+
+	s.segment  = s.nextSegment++;
+	s.written  = 0;
+	s.unsynced = 0;
+	s.openedNs = sinkNow();
+
+	while ( cfg.retainSegments != 0 && s.kept.size() + 1 > cfg.retainSegments ) {
+		unlink( segmentPath( s, s.kept.front() ).c_str() );
+		s.kept.pop_front();
+	}
+
+	return true;
+}
+
+/* --------------------------------------------------------------------
+ *  Write the batch, release the unused preallocation and sync.  When
+ *  the batch cannot be written the segment stays open for a retry,
+ *  unless `force`: then the batch is dropped.
+ * -------------------------------------------------------------------- */
+bool eventFileSink::closeSegment( stream_t &s, bool force ) {
+	bool ok = writeBatch( s );
+
+	if ( !ok && !force ) {
+		return false;
+	}
+
+	s.written -= s.batch.size();
+	s.batch.clear();
+
+	ok = ( ftruncate( s.fd, static_cast<off_t>( s.written ) ) == 0 ) && ok;
+	ok = ( fdatasync( s.fd ) == 0 ) && ok;
+	ok = ( ::close( s.fd ) == 0 ) && ok;
+
+	s.kept.push_back( s.segment );
+	s.fd = -1;
+	return ok;
+}
+
+/* --------------------------------------------------------------------
+ *  Write `bytes` after the packets already in the segment (`written`
+ *  less the batch).  On failure the part written is cut off, so the
+ *  file ends on a whole packet, and the caller keeps the data: a retry
+ *  writes it at the same place.
+ * -------------------------------------------------------------------- */
+bool eventFileSink::writeAll( stream_t &s, const std::byte *data, std::size_t bytes ) {
+	off_t end		 = static_cast<off_t>( s.written - s.batch.size() );
+	std::size_t done = 0;
+
+	while ( done < bytes ) {
+		ssize_t ret = pwrite( s.fd, data + done, bytes - done, end + static_cast<off_t>( done ) );
+
+		if ( ret < 0 ) {
+			if ( errno == EINTR ) {
+				continue;
+			}
+			( void ) ftruncate( s.fd, end );
+			return false;
+		}
+
+		done += static_cast<std::size_t>( ret );
+	}
+
+	s.unsynced += bytes;
+	return true;
+}
+
+/* fdatasync once `syncBytes` were written since the last one.  The
+ * packet is taken either way, a failure is reported by flush() or close(). */
+void eventFileSink::syncDue( stream_t &s ) {
+	if ( cfg.syncBytes == 0 || s.unsynced < cfg.syncBytes ) {
+		return;
+	}
+
+	s.unsynced = 0;
+	syncFailed = ( fdatasync( s.fd ) != 0 ) || syncFailed;
+}
+
+/* Write the batch; kept when it could not be written. */
+bool eventFileSink::writeBatch( stream_t &s ) {
+	if ( s.batch.empty() ) {
+		return true;
+	}
+
+	if ( !writeAll( s, s.batch.data(), s.batch.size() ) ) {
+		return false;
+	}
+
+	s.batch.clear();
+	return true;
+}
+
+/* --------------------------------------------------------------------
+ *  Append a packet: rotate first when the segment is full or too old,
+ *  so a segment always holds whole packets.  On failure the packet is
+ *  not taken.
+ * -------------------------------------------------------------------- */
+bool eventFileSink::write( std::span<const std::byte> pkt, uint32_t level ) {
+	uint32_t streamId = 0;
+	stream_t *s		  = nullptr;
+
+	if ( !opened || pkt.size() < sizeof( streamId ) ) {
+		return false;
+	}
+
+	memcpy( &streamId, pkt.data(), sizeof( streamId ) );
+	s = findStream( streamId, level );
+
+	if ( s->fd >= 0 && s->written != 0 &&
+		 ( s->written + pkt.size() > cfg.segmentBytes ||
+		   ( cfg.segmentNs != 0 && sinkNow() - s->openedNs >= cfg.segmentNs ) ) ) {
+		if ( !closeSegment( *s, false ) ) {
+			return false;
+		}
+	}
+
+	if ( s->fd < 0 && !openSegment( *s ) ) {
+		return false;
+	}
+
+	if ( s->batch.size() + pkt.size() > cfg.batchBytes && !writeBatch( *s ) ) {
+		return false;
+	}
+
+	if ( pkt.size() >= cfg.batchBytes ) {
+		if ( !writeAll( *s, pkt.data(), pkt.size() ) ) {
+			return false;
+		}
+	} else {
+		s->batch.insert( s->batch.end(), pkt.begin(), pkt.end() );
+	}
+
+	s->written += pkt.size();
+	syncDue( *s );
+	return true;
+}
+
+bool eventFileSink::flush() {
+	bool ok = !syncFailed;
+
+	for ( stream_t &s : streams ) {
+		if ( s.fd >= 0 ) {
+			ok = writeBatch( s ) && ok;
+			ok = ( fdatasync( s.fd ) == 0 ) && ok;
+			s.unsynced = 0;
+		}
+	}
+
+	syncFailed = false;
+	return ok;
+}
+
+bool eventFileSink::close() {
+	bool ok = !syncFailed;
+
+	for ( stream_t &s : streams ) {
+		if ( s.fd >= 0 ) {
+			ok = closeSegment( s, true ) && ok;
+		}
+	}
+
+	streams.clear();
+	opened	   = false;
+	syncFailed = false;
+	return ok;
+}
@@ -0,0 +1,153 @@
+/*********************************************************************
+ *  Shared memory packet store – POSIX mapping and robust locks
+ *
+ *  Only the non template parts live here: shm_open / mmap handling,
+ *  process shared mutexes and the monotonic clock.
+ *********************************************************************/
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <posix/eventShm.hpp>
+
+eventShmMapping::~eventShmMapping() { close(); }
+
+/* --------------------------------------------------------------------
+ *  Create the object, size it and map it.  An existing object with the
+ *  same name is reset (its ready packets must have been drained).
+ * -------------------------------------------------------------------- */
+bool eventShmMapping::create( const char *name, std::size_t bytes ) {
+	int fd	  = -1;
+	void *ptr = MAP_FAILED;
+
+	close();
+
+	fd = shm_open( name, O_CREAT | O_RDWR | O_TRUNC, 0600 );
+	if ( fd < 0 ) {
+		return false;
+	}
+
+	if ( ftruncate( fd, static_cast<off_t>( bytes ) ) != 0 ) {
+		::close( fd );
+		return false;
+	}
+
+	ptr = mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	::close( fd );
+	if ( ptr == MAP_FAILED ) {
+		return false;
+	}
+
+	// ftruncate zero fills, header magic stays 0 until the creator is done.
+	base = ptr;
+	size = bytes;
+	return true;
+}
+
+/* --------------------------------------------------------------------
+ *  Map an existing object read/write (the reader releases packets).
+ * -------------------------------------------------------------------- */
+bool eventShmMapping::open( const char *name, std::size_t minBytes ) {
+	int fd		= -1;
+	void *ptr	= MAP_FAILED;
+	struct stat st;
+
+	close();
+
+	fd = shm_open( name, O_RDWR, 0 );
+	if ( fd < 0 ) {
+		return false;
+	}
+
+	if ( fstat( fd, &st ) != 0 || static_cast<std::size_t>( st.st_size ) < minBytes ) {
+		::close( fd );
+		return false;
+	}
+
+	ptr = mmap( nullptr, static_cast<std::size_t>( st.st_size ), PROT_READ | PROT_WRITE,
+				MAP_SHARED, fd, 0 );
+	::close( fd );
+	if ( ptr == MAP_FAILED ) {
+		return false;
+	}
+
+	base = ptr;
+	size = static_cast<std::size_t>( st.st_size );
+	return true;
+}
+
+void eventShmMapping::close() {
+	if ( base != nullptr ) {
+		munmap( base, size );
+		base = nullptr;
+		size = 0;
+	}
+}
+
+void eventShmMapping::unlink( const char *name ) { shm_unlink( name ); }
+
+/* --------------------------------------------------------------------
+ *  Process shared, robust mutex.
+ * -------------------------------------------------------------------- */
+void eventShmMapping::mutexInit( pthread_mutex_t *mtx ) {
+	pthread_mutexattr_t attr;
+
+	pthread_mutexattr_init( &attr );
+	pthread_mutexattr_setpshared( &attr, PTHREAD_PROCESS_SHARED );
+	pthread_mutexattr_setrobust( &attr, PTHREAD_MUTEX_ROBUST );
+	pthread_mutex_init( mtx, &attr );
+	pthread_mutexattr_destroy( &attr );
+}
+
+/* --------------------------------------------------------------------
+ *  The owner died holding the lock: the lock is made usable again and
+ *  the caller told, the data it guards may be half updated.
+ * -------------------------------------------------------------------- */
+bool eventShmMapping::mutexLock( pthread_mutex_t *mtx ) {
+	if ( pthread_mutex_lock( mtx ) == EOWNERDEAD ) {
+		pthread_mutex_consistent( mtx );
+		return true;
+	}
+
+	return false;
+}
+
+/* --------------------------------------------------------------------
+ *  Event lock: it guards the packet being built by its owner, nothing
+ *  another process reads, so a dead owner only leaves the lock.
+ * -------------------------------------------------------------------- */
+bool eventShmMapping::mutexTryLock( pthread_mutex_t *mtx ) {
+	int ret = pthread_mutex_trylock( mtx );
+
+	if ( ret == EOWNERDEAD ) {
+		pthread_mutex_consistent( mtx );
+		ret = 0;
+	}
+
+	return ret == 0;
+}
+
+void eventShmMapping::mutexUnlock( pthread_mutex_t *mtx ) { pthread_mutex_unlock( mtx ); }
+
+/* --------------------------------------------------------------------
+ *  Monotonic clock in nanoseconds, shared by every process of the host.
+ * -------------------------------------------------------------------- */
+uint64_t eventShmPlatform::getTimestamp() {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+
+	return static_cast<uint64_t>( ts.tv_sec ) * 1000000000ULL + static_cast<uint64_t>( ts.tv_nsec );
+}
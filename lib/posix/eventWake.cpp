@@ -0,0 +1,54 @@
+/*********************************************************************
+ *  Drain wake hook – eventfd wait and wake
+ *
+ *  The producer side is one write(); the drain side parks in ppoll()
+ *  with the remaining timeout.
+ *********************************************************************/
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <ctime>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+/* --------------------------------------------------------------------------
+ *  Project headers
+ * -------------------------------------------------------------------------- */
+#include <posix/eventWake.hpp>
+
+eventWakeFd::eventWakeFd() { fd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK ); }
+
+eventWakeFd::~eventWakeFd() {
+	if ( fd >= 0 ) {
+		::close( fd );
+	}
+}
+
+/* --------------------------------------------------------------------
+ *  Wait for the counter to become non zero, then reset it.  EINTR
+ *  returns early, which the caller treats as a spurious wake.
+ * -------------------------------------------------------------------- */
+bool eventWakeFd::wait( uint64_t timeoutNs ) {
+	struct pollfd pfd = { .fd = fd, .events = POLLIN, .revents = 0 };
+	struct timespec limit;
+	uint64_t count = 0;
+
+	limit.tv_sec  = static_cast<time_t>( timeoutNs / 1000000000ULL );
+	limit.tv_nsec = static_cast<long>( timeoutNs % 1000000000ULL );
+
+	if ( ppoll( &pfd, 1, timeoutNs != 0 ? &limit : nullptr, nullptr ) <= 0 ) {
+		return false;
+	}
+
+	return read( fd, &count, sizeof( count ) ) == sizeof( count );
+}
+
+void eventWakeFd::wake() {
+	uint64_t one = 1;
+
+	// Only fails when the counter would overflow: a wake is pending anyway.
+	[[maybe_unused]] ssize_t n = write( fd, &one, sizeof( one ) );
+}
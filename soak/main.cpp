@@ -0,0 +1,499 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <basicEventCollector.hpp>
+#include <event_registry.hpp>
+#include <event_streams.hpp>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * Capacity planning soak harness.
+ *
+ * Producer threads replay the events of one stream of the YAML catalog at
+ * a fixed rate into a collector sized by the library configuration
+ * (MAX_EVENT_SIZE, MAX_EVENT_PER_PACKET, MAX_PACKETS).  A drain thread
+ * stands in for the transport: every packet costs a fixed latency plus
+ * its size over the bandwidth.  At the end the harness reports the drop
+ * rate, the ready queue occupancy over time and push latency percentiles.
+ *
+ *   soak --threads 4 --rate 20000 --duration 10 --bandwidth 115200 --latency 200
+ */
+
+/* --------------------------------------------------------------------------
+ *  Options
+ * -------------------------------------------------------------------------- */
+typedef struct {
+	unsigned threads  = 2;
+	double rate		  = 10000;	 // events per second and thread
+	double duration	  = 5;		 // seconds of load
+	double bandwidth  = 1000000; // transport bytes per second
+	double latency	  = 100;	 // transport microseconds per packet
+	unsigned sampleMs = 10;		 // queue occupancy sampling period
+	uint32_t streamId = EVENT_STREAM_ID;
+	const char *csv	  = nullptr; // occupancy timeline output
+	bool json		  = false;	 // one line summary for soak_sweep.py
+} soakOptions;
+
+/* --------------------------------------------------------------------------
+ *  Platform: monotonic clock, mutex locks shared by every thread.
+ * -------------------------------------------------------------------------- */
+struct soakPlatform {
+	static inline mutex eventMutex;
+	static inline mutex packetMutex;
+
+	uint64_t getTimestamp() {
+		return static_cast<uint64_t>(
+			duration_cast<nanoseconds>( steady_clock::now().time_since_epoch() ).count() );
+	}
+	bool eventTryLock() { return eventMutex.try_lock(); }
+	void eventUnlock() { eventMutex.unlock(); }
+	void packetLock() { packetMutex.lock(); }
+	void packetUnlock() { packetMutex.unlock(); }
+};
+
+/* --------------------------------------------------------------------------
+ *  Store policy counting packets in use and waiting in the ready queue.
+ *  Called under packetLock; the sampler reads the counters lock free.
+ * -------------------------------------------------------------------------- */
+template <EventCollectorConfig Config> class soakStore {
+public:
+	typedef basicEventPacket<Config> packet_t;
+
+	static inline atomic<uint32_t> used  = 0;
+	static inline atomic<uint32_t> ready = 0;
+
+private:
+	eventPacketStore<Config> store;
+
+public:
+	packet_t *allocate() {
+		packet_t *pkt = store.allocate();
+
+		if ( pkt != nullptr ) {
+			used.fetch_add( 1, memory_order_relaxed );
+		}
+		return pkt;
+	}
+
+	void release( packet_t *pkt ) {
+		store.release( pkt );
+		used.fetch_sub( 1, memory_order_relaxed );
+	}
+
+	bool pushReady( packet_t *pkt ) {
+		ready.fetch_add( 1, memory_order_relaxed );
+		return store.pushReady( pkt );
+	}
+
+	packet_t *popReady() {
+		packet_t *pkt = store.popReady();
+
+		if ( pkt != nullptr ) {
+			ready.fetch_sub( 1, memory_order_relaxed );
+		}
+		return pkt;
+	}
+};
+
+typedef soakStore<eventDefaultConfig> soakStore_t;
+typedef basicEventCollector<soakPlatform, eventDefaultConfig, soakStore_t> soakCollector;
+typedef soakCollector::packet_t::buffer_t soakBuffer_t;
+
+/* --------------------------------------------------------------------------
+ *  Catalog events: a payload of the registry size for every entry, so the
+ *  load has the sizes and ids of the real events.
+ * -------------------------------------------------------------------------- */
+template <std::size_t I> struct soakPayload {
+	array<uint8_t, eventRegistry::events[ I ].size> raw;
+};
+
+template <std::size_t I> struct EventId<soakPayload<I>> {
+	static constexpr uint32_t value = eventRegistry::events[ I ].id;
+};
+
+template <std::size_t I> void pushCatalogEvent( soakCollector &collector, uint8_t fill ) {
+	Event<soakPayload<I>> evt;
+
+	memset( evt.getParam(), fill, sizeof( soakPayload<I> ) );
+	collector.pushEvent( &evt );
+}
+
+typedef void ( *pushFn_t )( soakCollector &, uint8_t );
+
+template <std::size_t... I> constexpr array<pushFn_t, sizeof...( I )> pushTable( index_sequence<I...> ) {
+	return { &pushCatalogEvent<I>... };
+}
+
+template <std::size_t... I>
+constexpr array<std::size_t, sizeof...( I )> wireSizeTable( index_sequence<I...> ) {
+	return { sizeof( soakPayload<I> )... };
+}
+
+static constexpr auto g_push	 = pushTable( make_index_sequence<eventRegistry::count>() );
+static constexpr auto g_wireSize = wireSizeTable( make_index_sequence<eventRegistry::count>() );
+
+/* --------------------------------------------------------------------------
+ *  Log-linear latency histogram: 8 buckets per power of two, about 12 %
+ *  resolution, fixed memory whatever the soak duration.
+ * -------------------------------------------------------------------------- */
+class latencyHistogram {
+	static constexpr unsigned subBits = 3;
+	static constexpr uint64_t subMask = ( 1U << subBits ) - 1;
+
+	array<uint64_t, 64 << subBits> buckets = {};
+	uint64_t total						   = 0;
+	uint64_t maxNs						   = 0;
+
+	static unsigned bucketOf( uint64_t ns ) {
+		if ( ns <= subMask ) {
+			return static_cast<unsigned>( ns );
+		}
+
+		unsigned msb = 63 - static_cast<unsigned>( __builtin_clzll( ns ) );
+		return ( ( msb - subBits + 1 ) << subBits ) + static_cast<unsigned>( ( ns >> ( msb - subBits ) ) & subMask );
+	}
+
+	static uint64_t lowerBound( unsigned bucket ) {
+		if ( bucket <= subMask ) {
+			return bucket;
+		}
+
+		unsigned msb = ( bucket >> subBits ) + subBits - 1;
+		return ( 1ULL << msb ) | ( ( bucket & subMask ) << ( msb - subBits ) );
+	}
+
+public:
+	void record( uint64_t ns ) {
+		buckets[ bucketOf( ns ) ]++;
+		total++;
+		maxNs = std::max( maxNs, ns );
+	}
+
+	void merge( const latencyHistogram &other ) {
+		for ( std::size_t i = 0; i < buckets.size(); i++ ) {
+			buckets[ i ] += other.buckets[ i ];
+		}
+		total += other.total;
+		maxNs = std::max( maxNs, other.maxNs );
+	}
+
+	/* Lower bound of the bucket holding quantile `q` (0..1). */
+	uint64_t percentile( double q ) const {
+		uint64_t rank = static_cast<uint64_t>( q * static_cast<double>( total ) );
+		uint64_t seen = 0;
+
+		for ( unsigned i = 0; i < buckets.size(); i++ ) {
+			seen += buckets[ i ];
+			if ( seen > rank ) {
+				return lowerBound( i );
+			}
+		}
+		return maxNs;
+	}
+
+	uint64_t max() const { return maxNs; }
+};
+
+/* --------------------------------------------------------------------------
+ *  Results of the threads.
+ * -------------------------------------------------------------------------- */
+typedef struct {
+	uint64_t pushed = 0;
+	latencyHistogram latency;
+} producerStats;
+
+typedef struct {
+	uint64_t packets   = 0;
+	uint64_t events	   = 0; // events found in the drained packets
+	uint64_t lockBusy  = 0; // events_discarded reported by the packets
+	uint64_t bytes	   = 0;
+	uint64_t malformed = 0; // packets with an unknown event id
+} drainStats;
+
+typedef struct {
+	uint32_t ms;
+	uint32_t ready;
+	uint32_t used;
+} occupancySample;
+
+/* --------------------------------------------------------------------------
+ *  Producer: paced replay of the catalog events of the stream.
+ * -------------------------------------------------------------------------- */
+static void producer( soakCollector &collector, const soakOptions &opts,
+					  const vector<std::size_t> &mix, unsigned seed, producerStats &stats ) {
+	mt19937 rng( seed );
+	uniform_int_distribution<std::size_t> pick( 0, mix.size() - 1 );
+	nanoseconds interval( static_cast<int64_t>( 1e9 / opts.rate ) );
+	auto start = steady_clock::now();
+	auto end   = start + nanoseconds( static_cast<int64_t>( opts.duration * 1e9 ) );
+	auto next  = start;
+
+	while ( true ) {
+		auto t0 = steady_clock::now();
+
+		if ( t0 >= end ) {
+			break;
+		}
+
+		g_push[ mix[ pick( rng ) ] ]( collector, static_cast<uint8_t>( stats.pushed ) );
+
+		auto t1 = steady_clock::now();
+		stats.latency.record( static_cast<uint64_t>( duration_cast<nanoseconds>( t1 - t0 ).count() ) );
+		stats.pushed++;
+
+		// Sleep only when ahead by more than the timer granularity.
+		next += interval;
+		if ( next - t1 > microseconds( 50 ) ) {
+			this_thread::sleep_until( next );
+		}
+	}
+}
+
+/* --------------------------------------------------------------------------
+ *  Count the events of a drained packet with the registry sizes.
+ * -------------------------------------------------------------------------- */
+static void countPacket( std::span<const std::byte> raw, drainStats &stats ) {
+	const soakBuffer_t *buf = reinterpret_cast<const soakBuffer_t *>( raw.data() );
+	std::size_t offset		= sizeof( soakBuffer_t ) - buf->eventPayload.size();
+	std::size_t end			= buf->content_size / 8;
+
+	while ( offset + EventHeaderBytes <= end ) {
+		uint32_t id		= 0;
+		std::size_t idx = 0;
+
+		memcpy( &id, raw.data() + offset, sizeof( id ) );
+		idx = eventRegistry::indexOf( buf->stream_id, id );
+		if ( idx == eventRegistry::count ) {
+			stats.malformed++;
+			break;
+		}
+
+		// The payload starts on the event boundary, so does every event.
+		offset = eventAlignUp( offset + EventHeaderBytes + g_wireSize[ idx ] );
+		stats.events++;
+	}
+
+	stats.lockBusy += buf->events_discarded;
+	stats.bytes += raw.size();
+	stats.packets++;
+}
+
+/* --------------------------------------------------------------------------
+ *  Drain: throttled stand-in transport, one packet at a time.
+ * -------------------------------------------------------------------------- */
+static void drain( soakCollector &collector, const soakOptions &opts, const atomic<bool> &producing,
+				   drainStats &stats ) {
+	bool flushed = false;
+
+	while ( true ) {
+		auto pkt = collector.getSendPacket();
+
+		if ( !pkt.has_value() ) {
+			if ( !producing.load() ) {
+				if ( flushed ) {
+					break;
+				}
+				// Producers are done: close the partial packet once.
+				collector.forceSync();
+				flushed = true;
+				continue;
+			}
+			this_thread::sleep_for( microseconds( 100 ) );
+			continue;
+		}
+
+		countPacket( pkt.value(), stats );
+
+		double transferUs = opts.latency + static_cast<double>( pkt.value().size() ) * 1e6 / opts.bandwidth;
+		this_thread::sleep_for( nanoseconds( static_cast<int64_t>( transferUs * 1000 ) ) );
+
+		collector.sendPacketCompleted();
+	}
+}
+
+/* --------------------------------------------------------------------------
+ *  Command line.
+ * -------------------------------------------------------------------------- */
+static bool parseOptions( int argc, char **argv, soakOptions &opts ) {
+	for ( int i = 1; i < argc; i++ ) {
+		string_view arg = argv[ i ];
+		const char *val = ( i + 1 < argc ) ? argv[ i + 1 ] : nullptr;
+
+		if ( arg == "--json" ) {
+			opts.json = true;
+			continue;
+		}
+		if ( val == nullptr ) {
+			return false;
+		}
+
+		if ( arg == "--threads" ) {
+			opts.threads = static_cast<unsigned>( strtoul( val, nullptr, 0 ) );
+		} else if ( arg == "--rate" ) {
+			opts.rate = strtod( val, nullptr );
+		} else if ( arg == "--duration" ) {
+			opts.duration = strtod( val, nullptr );
+		} else if ( arg == "--bandwidth" ) {
+			opts.bandwidth = strtod( val, nullptr );
+		} else if ( arg == "--latency" ) {
+			opts.latency = strtod( val, nullptr );
+		} else if ( arg == "--sample-ms" ) {
+			opts.sampleMs = static_cast<unsigned>( strtoul( val, nullptr, 0 ) );
+		} else if ( arg == "--stream" ) {
+			opts.streamId = static_cast<uint32_t>( strtoul( val, nullptr, 0 ) );
+		} else if ( arg == "--csv" ) {
+			opts.csv = val;
+		} else {
+			return false;
+		}
+		i++;
+	}
+
+	return opts.threads > 0 && opts.rate > 0 && opts.duration > 0 && opts.bandwidth > 0 &&
+		   opts.sampleMs > 0;
+}
+
+static soakCollector g_collector;
+
+int main( int argc, char **argv ) {
+	soakOptions opts;
+	vector<std::size_t> mix;
+	vector<producerStats> producers;
+	vector<thread> threads;
+	vector<occupancySample> timeline;
+	drainStats drained;
+	latencyHistogram latency;
+	atomic<bool> producing = true;
+	uint64_t pushed		   = 0;
+
+	if ( !parseOptions( argc, argv, opts ) ) {
+		fprintf( stderr,
+				 "Usage: %s [--threads N] [--rate events/s] [--duration s] [--bandwidth bytes/s]\n"
+				 "          [--latency us] [--sample-ms ms] [--stream id] [--csv file] [--json]\n",
+				 argv[ 0 ] );
+		return 1;
+	}
+
+	for ( std::size_t i = 0; i < eventRegistry::count; i++ ) {
+		if ( eventRegistry::events[ i ].streamId == opts.streamId ) {
+			mix.push_back( i );
+		}
+	}
+	if ( mix.empty() ) {
+		fprintf( stderr, "stream %u has no event in the catalog\n", opts.streamId );
+		return 1;
+	}
+
+	g_collector.setStreamId( opts.streamId );
+
+	thread drainer( drain, ref( g_collector ), cref( opts ), cref( producing ), ref( drained ) );
+
+	producers.resize( opts.threads );
+	for ( unsigned t = 0; t < opts.threads; t++ ) {
+		threads.emplace_back( producer, ref( g_collector ), cref( opts ), cref( mix ), t + 1,
+							  ref( producers[ t ] ) );
+	}
+
+	// Queue occupancy over the load period.
+	auto start = steady_clock::now();
+	auto end   = start + nanoseconds( static_cast<int64_t>( opts.duration * 1e9 ) );
+	for ( auto now = start; now < end; now = steady_clock::now() ) {
+		timeline.push_back( { static_cast<uint32_t>( duration_cast<milliseconds>( now - start ).count() ),
+							  soakStore_t::ready.load( memory_order_relaxed ),
+							  soakStore_t::used.load( memory_order_relaxed ) } );
+		this_thread::sleep_for( milliseconds( opts.sampleMs ) );
+	}
+
+	for ( thread &t : threads ) {
+		t.join();
+	}
+	producing = false;
+	drainer.join();
+
+	for ( const producerStats &p : producers ) {
+		pushed += p.pushed;
+		latency.merge( p.latency );
+	}
+
+	uint64_t dropped	= pushed - min( pushed, drained.events );
+	uint64_t exhausted	= dropped - min( dropped, drained.lockBusy );
+	uint32_t readyMax	= 0;
+	uint64_t readySum	= 0;
+	uint64_t poolFull	= 0;
+	double dropRate		= pushed ? 100.0 * static_cast<double>( dropped ) / static_cast<double>( pushed ) : 0;
+
+	for ( const occupancySample &s : timeline ) {
+		readyMax = max( readyMax, s.ready );
+		readySum += s.ready;
+		poolFull += ( s.used >= eventDefaultConfig::packetCountMax ) ? 1 : 0;
+	}
+
+	double readyAvg = timeline.empty() ? 0 : static_cast<double>( readySum ) / static_cast<double>( timeline.size() );
+	double fullPct	= timeline.empty() ? 0 : 100.0 * static_cast<double>( poolFull ) / static_cast<double>( timeline.size() );
+
+	if ( opts.csv != nullptr ) {
+		FILE *f = fopen( opts.csv, "w" );
+
+		if ( f != nullptr ) {
+			fprintf( f, "ms,ready,used\n" );
+			for ( const occupancySample &s : timeline ) {
+				fprintf( f, "%u,%u,%u\n", s.ms, s.ready, s.used );
+			}
+			fclose( f );
+		}
+	}
+
+	if ( opts.json ) {
+		printf( "{\"event_size\": %zu, \"events_per_packet\": %zu, \"packets\": %zu, "
+				"\"pushed\": %llu, \"received\": %llu, \"dropped\": %llu, \"drop_pct\": %.3f, "
+				"\"lock_busy\": %llu, \"pool_exhausted\": %llu, \"ready_max\": %u, \"ready_avg\": %.2f, "
+				"\"pool_full_pct\": %.1f, \"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, "
+				"\"max_ns\": %llu}\n",
+				eventDefaultConfig::eventSizeMax, eventDefaultConfig::eventMaxPerPacket,
+				eventDefaultConfig::packetCountMax, ( unsigned long long ) pushed,
+				( unsigned long long ) drained.events, ( unsigned long long ) dropped, dropRate,
+				( unsigned long long ) drained.lockBusy, ( unsigned long long ) exhausted, readyMax,
+				readyAvg, fullPct, ( unsigned long long ) latency.percentile( 0.5 ),
+				( unsigned long long ) latency.percentile( 0.99 ),
+				( unsigned long long ) latency.percentile( 0.999 ), ( unsigned long long ) latency.max() );
+		return 0;
+	}
+
+	printf( "config    : %zu byte events, %zu events/packet, %zu packets (%zu bytes each)\n",
+			eventDefaultConfig::eventSizeMax, eventDefaultConfig::eventMaxPerPacket,
+			eventDefaultConfig::packetCountMax, sizeof( soakBuffer_t ) );
+	printf( "load      : %u threads x %.0f events/s for %.1f s, %zu catalog events of stream %u\n",
+			opts.threads, opts.rate, opts.duration, mix.size(), opts.streamId );
+	printf( "transport : %.0f bytes/s, %.0f us per packet\n", opts.bandwidth, opts.latency );
+	printf( "events    : %llu pushed, %llu received, %llu dropped (%.3f %%)\n",
+			( unsigned long long ) pushed, ( unsigned long long ) drained.events,
+			( unsigned long long ) dropped, dropRate );
+	printf( "drops     : %llu event lock busy, %llu no free packet\n",
+			( unsigned long long ) drained.lockBusy, ( unsigned long long ) exhausted );
+	printf( "queue     : ready max %u avg %.2f, pool full %.1f %% of samples\n", readyMax, readyAvg,
+			fullPct );
+	printf( "push (ns) : p50 %llu p90 %llu p99 %llu p99.9 %llu max %llu\n",
+			( unsigned long long ) latency.percentile( 0.5 ),
+			( unsigned long long ) latency.percentile( 0.9 ),
+			( unsigned long long ) latency.percentile( 0.99 ),
+			( unsigned long long ) latency.percentile( 0.999 ), ( unsigned long long ) latency.max() );
+	if ( drained.malformed != 0 ) {
+		printf( "warning   : %llu packets with unknown event ids\n", ( unsigned long long ) drained.malformed );
+	}
+
+	return 0;
+}
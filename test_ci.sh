@@ -38,6 +38,27 @@ function library_ut_test()
     cd $EXEC_DIR
 }
 
+function library_aligned_test()
+{
+    # naturally aligned event layout (-DEVENT_ALIGNED_LAYOUT=ON)
+    rm -rf ${BUILD_DIR}_aligned
+    mkdir ${BUILD_DIR}_aligned
+    cd ${BUILD_DIR}_aligned
+
+    # config space
+    cmake ${REPO_PATH} -DCMAKE_BUILD_TYPE=Debug -DEVENT_ALIGNED_LAYOUT=ON
+
+    # build cmake
+    cmake --build . -- -j$(nproc)
+
+    # Run test
+    cd tests/
+    ctest --output-on-failure
+    cd -
+
+    cd $EXEC_DIR
+}
+
 function example_build()
 {
     rm -rf ${BUILD_DIR}/example
@@ -56,10 +77,10 @@ function example_build()
     # create trace analysis directory
     mkdir -p traces
     cp generated/metadata traces/
-    cp stream.bin traces/
+    cp stream.bin driver.bin traces/
 
-    # Analyse traces
-    babeltrace2 traces
+    # Analyse traces, expand EVT_LOG messages
+    babeltrace2 traces | python3 ${REPO_PATH}/tools/event_log_strings.py expand generated/log_strings.yml
 
     cd $EXEC_DIR
 }
@@ -95,6 +116,7 @@ if [ "$EXAMPLE_BUILD" = "true" ]; then
     example_build
 else
     library_ut_test
+    library_aligned_test
 fi
 
 echo "done"
@@ -0,0 +1,501 @@
+#include <gtest/gtest.h>
+
+#include <basicEventCollector.hpp>
+#include <event.hpp>
+
+#include <cstring>
+
+#include "counterPlatform.hpp"
+
+using namespace std;
+
+// Mock event for the policy based collector.
+typedef struct {
+	uint32_t value;
+} __attribute__( ( packed ) ) policy_event_t;
+
+template <> struct EventId<policy_event_t> {
+	static constexpr uint32_t value = 5;
+};
+
+// Two packets of two events of at most 32 bytes.
+typedef eventConfig<32, 2, 2> smallConfig;
+typedef basicEventCollector<CounterPlatform, smallConfig> smallCollector;
+
+static_assert( EventPlatformPolicy<CounterPlatform> );
+static_assert( EventCollectorConfig<smallConfig> );
+
+// Content bytes of a packet of `Collector` holding `events` policy events,
+// each starting on the event boundary of the layout.
+template <typename Collector> static size_t contentBytes( size_t events ) {
+	constexpr size_t each = EventHeaderBytes + sizeof( policy_event_t );
+	size_t bytes		  = offsetof( typename Collector::packet_t::buffer_t, eventPayload );
+
+	if ( events > 0 ) {
+		bytes += eventAlignUp( each ) * ( events - 1 ) + each;
+	}
+	return bytes;
+}
+
+TEST( BasicEventCollectorTest, PacketSizedByConfig ) {
+	smallCollector collector;
+	Event<policy_event_t> evt;
+	const smallCollector::packet_t::buffer_t *pktBuf = nullptr;
+
+	collector.setStreamId( 7 );
+
+	for ( uint32_t i = 0; i < smallConfig::eventMaxPerPacket; i++ ) {
+		evt.getParam()->value = i;
+		collector.pushEvent( &evt );
+	}
+
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	EXPECT_EQ( pkt.value().size(), sizeof( smallCollector::packet_t::buffer_t ) );
+
+	pktBuf = reinterpret_cast<const smallCollector::packet_t::buffer_t *>( pkt.value().data() );
+	EXPECT_EQ( pktBuf->stream_id, 7 );
+	EXPECT_EQ( pktBuf->packet_seq_count, 0 );
+	// eventSizeMax bounds a whole event, header included.
+	EXPECT_EQ( pktBuf->eventPayload.size(), 64 );
+
+	collector.sendPacketCompleted();
+}
+
+TEST( BasicEventCollectorTest, PoolExhaustedDropsEvent ) {
+	smallCollector collector;
+	Event<policy_event_t> evt;
+
+	// Fill every packet of the pool without draining.
+	for ( size_t i = 0; i < smallConfig::eventMaxPerPacket * smallConfig::packetCountMax; i++ ) {
+		collector.pushEvent( &evt );
+	}
+
+	// No packet left: must not crash, the event is discarded.
+	collector.pushEvent( &evt );
+
+	for ( size_t i = 0; i < smallConfig::packetCountMax; i++ ) {
+		EXPECT_TRUE( collector.getSendPacket().has_value() );
+		collector.sendPacketCompleted();
+	}
+
+	EXPECT_FALSE( collector.getSendPacket().has_value() );
+}
+
+TEST( BasicEventCollectorTest, IndependentInstances ) {
+	smallCollector first;
+	smallCollector second;
+	Event<policy_event_t> evt;
+
+	for ( size_t i = 0; i < smallConfig::eventMaxPerPacket; i++ ) {
+		first.pushEvent( &evt );
+	}
+
+	EXPECT_TRUE( first.getSendPacket().has_value() );
+	EXPECT_FALSE( second.getSendPacket().has_value() );
+}
+
+TEST( BasicEventCollectorTest, DifferentConfigPerInstance ) {
+	typedef eventConfig<EventHeaderBytes + sizeof( policy_event_t ), 1, 1> controlConfig;
+	typedef eventConfig<32, 4, 3> driverConfig;
+	typedef basicEventCollector<CounterPlatform, controlConfig> controlCollector;
+	typedef basicEventCollector<CounterPlatform, driverConfig> driverCollector;
+
+	controlCollector control;
+	driverCollector driver;
+	Event<policy_event_t> evt;
+
+	control.setStreamId( 1 );
+	driver.setStreamId( 2 );
+
+	// One event closes a control packet, the driver stream keeps building.
+	control.pushEvent( &evt );
+	driver.pushEvent( &evt );
+
+	auto ctrlPkt = control.getSendPacket();
+	ASSERT_TRUE( ctrlPkt.has_value() );
+	EXPECT_EQ( ctrlPkt.value().size(), contentBytes<controlCollector>( 0 ) + eventPacketPayloadBytes<controlConfig> );
+	EXPECT_FALSE( driver.getSendPacket().has_value() );
+
+	driver.forceSync();
+	auto drvPkt = driver.getSendPacket();
+	ASSERT_TRUE( drvPkt.has_value() );
+	EXPECT_EQ( drvPkt.value().size(), contentBytes<driverCollector>( 0 ) + eventPacketPayloadBytes<driverConfig> );
+	EXPECT_EQ( reinterpret_cast<const uint32_t *>( drvPkt.value().data() )[ 0 ], 2 );
+}
+
+// Event filling eventSizeMax with its header.
+typedef struct {
+	uint8_t bytes[ 20 ];
+} __attribute__( ( packed ) ) full_event_t;
+
+template <> struct EventId<full_event_t> {
+	static constexpr uint32_t value = 6;
+};
+
+TEST( BasicEventCollectorTest, EventOfSizeMaxFits ) {
+	typedef eventConfig<EventHeaderBytes + sizeof( full_event_t ), 2, 2> fullConfig;
+	typedef basicEventCollector<CounterPlatform, fullConfig> fullCollector;
+	typedef fullCollector::packet_t::buffer_t fullBuffer_t;
+
+	fullCollector collector;
+	Event<full_event_t> evt;
+	constexpr size_t each = EventHeaderBytes + sizeof( full_event_t );
+
+	for ( uint8_t i = 0; i < fullConfig::eventMaxPerPacket; i++ ) {
+		memset( evt.getParam()->bytes, 0xA0 + i, sizeof( full_event_t ) );
+		collector.pushEvent( &evt );
+	}
+
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	const auto *buf = reinterpret_cast<const fullBuffer_t *>( pkt.value().data() );
+
+	EXPECT_EQ( buf->eventPayload.size(), 2 * eventAlignUp( each ) );
+	EXPECT_EQ( buf->content_size / 8, offsetof( fullBuffer_t, eventPayload ) + eventAlignUp( each ) + each );
+	// The last event ends on the last payload byte of its slot.
+	EXPECT_EQ( buf->eventPayload[ eventAlignUp( each ) + each - 1 ], 0xA1 );
+	EXPECT_EQ( buf->eventPayload[ eventAlignUp( each ) + EventHeaderBytes ], 0xA1 );
+	EXPECT_EQ( buf->eventPayload[ each - 1 ], 0xA0 );
+}
+
+// Transport recording the packets it is given.
+class MockTransport : public eventTransport {
+public:
+	vector<uint32_t> tokens;
+	vector<uint32_t> seqNo;
+	vector<uint32_t> cancelled;
+	size_t readyCount = 0;
+	bool busy		  = false;
+
+	bool submit( std::span<const std::byte> pkt, uint32_t token ) override {
+		if ( busy ) {
+			return false;
+		}
+		tokens.push_back( token );
+		seqNo.push_back(
+			reinterpret_cast<const smallCollector::packet_t::buffer_t *>( pkt.data() )->packet_seq_count );
+		return true;
+	}
+
+	void cancel( uint32_t token ) override { cancelled.push_back( token ); }
+	void ready() override { readyCount++; }
+};
+
+// Four packets of two events, two in flight.
+typedef eventConfig<32, 2, 4, 2> pushConfig;
+typedef basicEventCollector<CounterPlatform, pushConfig> pushCollector;
+
+static_assert( pushCollector::inFlightMax == 2 );
+static_assert( smallCollector::inFlightMax == 1 );
+
+TEST( BasicEventCollectorTest, TransportInFlightBound ) {
+	pushCollector collector;
+	MockTransport transport;
+	Event<policy_event_t> evt;
+
+	collector.setTransport( &transport );
+
+	for ( size_t i = 0; i < pushConfig::eventMaxPerPacket * pushConfig::packetCountMax; i++ ) {
+		collector.pushEvent( &evt );
+	}
+
+	// The producers only signal the driver, which submits from its poll.
+	EXPECT_TRUE( transport.tokens.empty() );
+	EXPECT_EQ( transport.readyCount, pushConfig::packetCountMax );
+	collector.transportPoll();
+
+	// Only two packets handed out, in order.
+	ASSERT_EQ( transport.tokens.size(), 2 );
+	EXPECT_EQ( transport.seqNo, ( vector<uint32_t>{ 0, 1 } ) );
+
+	// Each completion chains the next ready packet.
+	collector.transportComplete( transport.tokens[ 0 ] );
+	collector.transportComplete( transport.tokens[ 1 ] );
+	ASSERT_EQ( transport.tokens.size(), 4 );
+	EXPECT_EQ( transport.seqNo, ( vector<uint32_t>{ 0, 1, 2, 3 } ) );
+
+	collector.transportComplete( transport.tokens[ 2 ] );
+	collector.transportComplete( transport.tokens[ 3 ] );
+	EXPECT_EQ( transport.tokens.size(), 4 );
+}
+
+TEST( BasicEventCollectorTest, TransportAckTimeout ) {
+	pushCollector collector;
+	MockTransport transport;
+	Event<policy_event_t> evt;
+
+	collector.setTransport( &transport, 100 );
+
+	for ( size_t i = 0; i < pushConfig::eventMaxPerPacket; i++ ) {
+		collector.pushEvent( &evt );
+	}
+	collector.transportPoll();
+	ASSERT_EQ( transport.tokens.size(), 1 );
+
+	// Clock advances 10 per read: no ack for long enough drops the packet.
+	for ( int i = 0; i < 20; i++ ) {
+		collector.transportPoll();
+	}
+	EXPECT_EQ( collector.getAckTimeoutCount(), 1 );
+	EXPECT_EQ( transport.cancelled, ( vector<uint32_t>{ transport.tokens[ 0 ] } ) );
+
+	// Late completion is ignored, the whole pool is usable again.
+	collector.transportComplete( transport.tokens[ 0 ] );
+	transport.busy = true;
+	for ( size_t i = 0; i < pushConfig::eventMaxPerPacket * pushConfig::packetCountMax; i++ ) {
+		collector.pushEvent( &evt );
+	}
+	transport.busy = false;
+	collector.transportPoll();
+	EXPECT_EQ( transport.seqNo, ( vector<uint32_t>{ 0, 1, 2 } ) );
+}
+
+// Transport whose cancel() races the event path: the pool is filled
+// while the driver may still read the cancelled buffer.
+class CancelRaceTransport : public eventTransport {
+public:
+	pushCollector *collector = nullptr;
+	span<const std::byte> sent;
+	uint32_t seqAtCancel = UINT32_MAX;
+
+	bool submit( std::span<const std::byte> pkt, uint32_t token ) override {
+		( void ) token;
+		if ( sent.empty() ) {
+			sent = pkt;
+		}
+		return true;
+	}
+
+	void cancel( uint32_t token ) override {
+		Event<policy_event_t> evt;
+
+		( void ) token;
+		for ( size_t i = 0; i < pushConfig::eventMaxPerPacket * pushConfig::packetCountMax; i++ ) {
+			collector->pushEvent( &evt );
+		}
+		seqAtCancel = reinterpret_cast<const pushCollector::packet_t::buffer_t *>( sent.data() )->packet_seq_count;
+	}
+};
+
+TEST( BasicEventCollectorTest, TransportCancelBeforeReuse ) {
+	pushCollector collector;
+	CancelRaceTransport transport;
+	Event<policy_event_t> evt;
+
+	transport.collector = &collector;
+	collector.setTransport( &transport, 100 );
+
+	for ( size_t i = 0; i < pushConfig::eventMaxPerPacket; i++ ) {
+		collector.pushEvent( &evt );
+	}
+	collector.transportPoll();
+	ASSERT_FALSE( transport.sent.empty() );
+
+	for ( int i = 0; i < 20 && collector.getAckTimeoutCount() == 0; i++ ) {
+		collector.transportPoll();
+	}
+	EXPECT_EQ( collector.getAckTimeoutCount(), 1 );
+	// Still the cancelled packet while the driver stops.
+	EXPECT_EQ( transport.seqAtCancel, 0 );
+}
+
+TEST( BasicEventCollectorTest, TransportBusyRetried ) {
+	pushCollector collector;
+	MockTransport transport;
+	Event<policy_event_t> evt;
+
+	transport.busy = true;
+	collector.setTransport( &transport );
+
+	for ( size_t i = 0; i < pushConfig::eventMaxPerPacket; i++ ) {
+		collector.pushEvent( &evt );
+	}
+	collector.transportPoll();
+	EXPECT_TRUE( transport.tokens.empty() );
+
+	transport.busy = false;
+	collector.transportPoll();
+	EXPECT_EQ( transport.seqNo, ( vector<uint32_t>{ 0 } ) );
+}
+
+TEST( BasicEventCollectorTest, PreArmedPacketSwitchedIn ) {
+	pushCollector collector;
+	Event<policy_event_t> evt;
+	uint64_t clockReads = 0;
+	uint64_t lastTs		= 0;
+
+	collector.pushEvent( &evt );
+
+	// Drain side polls: the next packet is armed meanwhile.
+	EXPECT_FALSE( collector.getSendPacket().has_value() );
+
+	// The event closing the packet reads the clock once, like any other.
+	clockReads = collector.getTimestamp();
+	collector.pushEvent( &evt );
+	lastTs = evt.getTimestamp();
+	EXPECT_EQ( collector.getTimestamp() - clockReads, 2 * 10 );
+
+	auto first = collector.getSendPacket();
+	ASSERT_TRUE( first.has_value() );
+	const auto *buf = reinterpret_cast<const smallCollector::packet_t::buffer_t *>( first.value().data() );
+
+	// Finalised on the drain side, closed at its last event.
+	EXPECT_EQ( buf->timestamp_end, lastTs );
+	EXPECT_EQ( buf->content_size, contentBytes<pushCollector>( 2 ) * 8 );
+	collector.sendPacketCompleted();
+
+	// The armed packet continues the sequence and the time range.
+	collector.pushEvent( &evt );
+	collector.forceSync();
+	auto second = collector.getSendPacket();
+	ASSERT_TRUE( second.has_value() );
+	buf = reinterpret_cast<const smallCollector::packet_t::buffer_t *>( second.value().data() );
+	EXPECT_EQ( buf->packet_seq_count, 1 );
+	EXPECT_EQ( buf->timestamp_begin, lastTs );
+	collector.sendPacketCompleted();
+
+	// Nothing left to flush in the next armed packet.
+	collector.forceSync();
+	EXPECT_FALSE( collector.getSendPacket().has_value() );
+}
+
+TEST( BasicEventCollectorTest, BatchOneClockRead ) {
+	pushCollector collector;
+	Event<policy_event_t> a;
+	Event<policy_event_t> b;
+	Event<policy_event_t> c;
+	uint64_t before = collector.getTimestamp();
+
+	// Three events across two packets: one clock read for the events, plus
+	// the two packets initialised inline as nothing is armed yet.
+	collector.pushEvents( &a, &b, &c );
+	EXPECT_EQ( collector.getTimestamp() - before, 4 * 10 );
+	EXPECT_EQ( a.getTimestamp(), before + 10 );
+	EXPECT_EQ( c.getTimestamp(), a.getTimestamp() );
+
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	const auto *buf = reinterpret_cast<const smallCollector::packet_t::buffer_t *>( pkt.value().data() );
+	EXPECT_EQ( buf->content_size, contentBytes<pushCollector>( 2 ) * 8 );
+	collector.sendPacketCompleted();
+
+	// The third event is in the following packet.
+	collector.forceSync();
+	pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	buf = reinterpret_cast<const smallCollector::packet_t::buffer_t *>( pkt.value().data() );
+	EXPECT_EQ( buf->packet_seq_count, 1 );
+	EXPECT_EQ( buf->content_size, contentBytes<pushCollector>( 1 ) * 8 );
+}
+
+TEST( BasicEventCollectorTest, BatchWithDeltas ) {
+	pushCollector collector;
+	array<Event<policy_event_t>, 3> evts;
+	const array<uint32_t, 3> deltas = { 0, 3, 7 };
+
+	collector.pushEvents( span( evts ), span( deltas ) );
+	EXPECT_EQ( evts[ 1 ].getTimestamp() - evts[ 0 ].getTimestamp(), 3 );
+	EXPECT_EQ( evts[ 2 ].getTimestamp() - evts[ 0 ].getTimestamp(), 7 );
+
+	// Temporaries are accepted too.
+	collector.pushEvents( Event<policy_event_t>(), Event<policy_event_t>() );
+	for ( int i = 0; i < 2; i++ ) {
+		EXPECT_TRUE( collector.getSendPacket().has_value() );
+		collector.sendPacketCompleted();
+	}
+}
+
+TEST( BasicEventCollectorTest, BatchPoolExhausted ) {
+	smallCollector collector;
+	array<Event<policy_event_t>, 6> evts;
+
+	// Two packets fill, the remaining events are discarded without crash.
+	collector.pushEvents( span( evts ) );
+	for ( size_t i = 0; i < smallConfig::packetCountMax; i++ ) {
+		EXPECT_TRUE( collector.getSendPacket().has_value() );
+		collector.sendPacketCompleted();
+	}
+	EXPECT_FALSE( collector.getSendPacket().has_value() );
+}
+
+// Packet context of a stream: written once per packet after the header.
+typedef struct {
+	uint16_t cpu_id;
+	uint32_t task_id;
+} __attribute__( ( packed ) ) test_context_t;
+
+struct ContextPlatform : CounterPlatform {
+	uint16_t cpu	 = 0;
+	uint32_t task	 = 0;
+	unsigned samples = 0;
+
+	void getPacketContext( test_context_t &ctx ) {
+		ctx.cpu_id	= cpu;
+		ctx.task_id = task;
+		samples++;
+	}
+};
+
+typedef eventConfig<32, 2, 4, 1, test_context_t> contextConfig;
+typedef basicEventCollector<ContextPlatform, contextConfig> contextCollector;
+
+#if !CONFIG_EVENT_ALIGNED
+static_assert( sizeof( smallCollector::packet_t::buffer_t ) == 36 + 64 );
+static_assert( sizeof( contextCollector::packet_t::buffer_t ) == 36 + sizeof( test_context_t ) + 64 );
+#endif
+
+TEST( BasicEventCollectorTest, PacketContextOncePerPacket ) {
+	ContextPlatform pltf;
+	Event<policy_event_t> evt;
+	const contextCollector::packet_t::buffer_t *pktBuf = nullptr;
+
+	pltf.cpu  = 3;
+	pltf.task = 42;
+	contextCollector collector( pltf );
+
+	collector.pushEvent( &evt );
+	collector.pushEvent( &evt );
+
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	EXPECT_EQ( pkt.value().size(), sizeof( contextCollector::packet_t::buffer_t ) );
+
+	pktBuf = reinterpret_cast<const contextCollector::packet_t::buffer_t *>( pkt.value().data() );
+	EXPECT_EQ( pktBuf->context.cpu_id, 3 );
+	EXPECT_EQ( pktBuf->context.task_id, 42 );
+	// content_size counts the context, in bits.
+	EXPECT_EQ( pktBuf->content_size, contentBytes<contextCollector>( 2 ) * 8 );
+
+	collector.sendPacketCompleted();
+}
+
+TEST( BasicEventCollectorTest, ContextChangeSwitchesPacket ) {
+	contextCollector collector;
+	Event<policy_event_t> evt;
+	const contextCollector::packet_t::buffer_t *pktBuf = nullptr;
+
+	collector.pushEvent( &evt );
+
+	// Context switch: the half filled packet is closed.
+	collector.contextChanged();
+	collector.pushEvent( &evt );
+	collector.forceSync();
+
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	pktBuf = reinterpret_cast<const contextCollector::packet_t::buffer_t *>( pkt.value().data() );
+	EXPECT_EQ( pktBuf->packet_seq_count, 0 );
+	EXPECT_EQ( pktBuf->content_size, contentBytes<contextCollector>( 1 ) * 8 );
+	collector.sendPacketCompleted();
+
+	pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	pktBuf = reinterpret_cast<const contextCollector::packet_t::buffer_t *>( pkt.value().data() );
+	EXPECT_EQ( pktBuf->packet_seq_count, 1 );
+	collector.sendPacketCompleted();
+
+	// An empty packet is re-stamped, not sent.
+	collector.contextChanged();
+	EXPECT_FALSE( collector.getSendPacket().has_value() );
+}
@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: MIT | Author: Rohit Patil
+
+#pragma once
+
+/* --------------------------------------------------------------------------
+ *  Standard library headers
+ * -------------------------------------------------------------------------- */
+#include <cstdint>
+
+/* --------------------------------------------------------------------------
+ *  CounterPlatform – compile time platform policy of the tests.
+ *
+ *  Plain counter clock advancing 10 per read, no locking.  Tests needing
+ *  nesting levels or a packet context derive from it.
+ * -------------------------------------------------------------------------- */
+struct CounterPlatform {
+	uint64_t ts = 0;
+
+	uint64_t getTimestamp() { return ts += 10; }
+	bool eventTryLock() { return true; }
+	void eventUnlock() {}
+	void packetLock() {}
+	void packetUnlock() {}
+};
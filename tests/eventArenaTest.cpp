@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <basicEventCollector.hpp>
+#include <event.hpp>
+#include <eventArena.hpp>
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "counterPlatform.hpp"
+
+using namespace std;
+
+// Mock event for the arena collectors.
+typedef struct {
+	uint32_t value;
+} __attribute__( ( packed ) ) arena_event_t;
+
+template <> struct EventId<arena_event_t> {
+	static constexpr uint32_t value = 10;
+};
+
+// Size classes: two event "latency" packets, eight event "throughput" packets.
+typedef eventConfig<32, 2, 16> latencyClass;
+typedef eventConfig<32, 8, 4> throughputClass;
+
+typedef eventArenaStore<latencyClass> latencyStore;
+typedef eventArenaStore<throughputClass> throughputStore;
+typedef basicEventCollector<CounterPlatform, latencyClass, latencyStore> latencyCollector;
+typedef basicEventCollector<CounterPlatform, throughputClass, throughputStore> throughputCollector;
+
+static_assert( EventPacketStorePolicy<latencyStore> );
+
+// Caller provided trace memory.
+alignas( 64 ) static std::byte g_traceRam[ 16384 ];
+
+// Push `count` events, then return the number of events of each drained packet.
+template <typename Collector> static vector<size_t> pushAndDrain( Collector &collector, uint32_t count ) {
+	typedef typename Collector::packet_t::buffer_t buffer_t;
+	constexpr size_t each = eventAlignUp( EventHeaderBytes + sizeof( arena_event_t ) );
+	Event<arena_event_t> evt;
+	vector<size_t> perPacket;
+
+	for ( uint32_t i = 0; i < count; i++ ) {
+		evt.getParam()->value = i;
+		collector.pushEvent( &evt );
+	}
+	collector.forceSync();
+
+	while ( auto pkt = collector.getSendPacket() ) {
+		const auto *buf = reinterpret_cast<const buffer_t *>( pkt.value().data() );
+		perPacket.push_back( ( buf->content_size / 8 - offsetof( buffer_t, eventPayload ) + each - 1 ) / each );
+		collector.sendPacketCompleted();
+	}
+
+	return perPacket;
+}
+
+TEST( EventArenaTest, CarvesPacketsFromBudget ) {
+	eventArena arena( g_traceRam );
+
+	latencyStore fast = latencyStore::create( arena, latencyStore::bytesFor( 5 ) );
+	ASSERT_TRUE( fast.valid() );
+	EXPECT_EQ( fast.packetCount(), 5 );
+	EXPECT_LE( arena.capacity() - arena.remaining(), latencyStore::bytesFor( 5 ) );
+
+	// The rest of the memory goes to the other class.
+	size_t rest			 = arena.remaining();
+	throughputStore bulk = throughputStore::create( arena, rest );
+	ASSERT_TRUE( bulk.valid() );
+	EXPECT_EQ( bulk.packetCount(), throughputStore::packetsFor( rest ) );
+	EXPECT_LE( rest - arena.remaining(), throughputStore::bytesFor( bulk.packetCount() ) );
+}
+
+TEST( EventArenaTest, CappedByPacketCountMax ) {
+	eventArena arena( g_traceRam );
+
+	// Far more memory than 4 throughput packets need.
+	throughputStore bulk = throughputStore::create( arena, sizeof( g_traceRam ) );
+	EXPECT_EQ( bulk.packetCount(), throughputClass::packetCountMax );
+	EXPECT_EQ( throughputStore::packetsFor( sizeof( g_traceRam ) ), throughputClass::packetCountMax );
+}
+
+TEST( EventArenaTest, TooSmallLeavesArenaUntouched ) {
+	eventArena arena( span<std::byte>( g_traceRam ).first( latencyStore::bytesFor( 1 ) - 1 ) );
+
+	latencyStore fast = latencyStore::create( arena, arena.remaining() );
+	EXPECT_FALSE( fast.valid() );
+	EXPECT_EQ( fast.packetCount(), 0 );
+	EXPECT_EQ( arena.remaining(), arena.capacity() );
+}
+
+TEST( EventArenaTest, InvalidStoreDropsEvents ) {
+	eventArena arena( span<std::byte>( g_traceRam ).first( latencyStore::bytesFor( 1 ) - 1 ) );
+	latencyStore none = latencyStore::create( arena, arena.remaining() );
+
+	ASSERT_FALSE( none.valid() );
+	latencyCollector collector( CounterPlatform(), none );
+
+	// No packet to build in: the events are lost, nothing is sent.
+	EXPECT_EQ( pushAndDrain( collector, 4 ), vector<size_t>() );
+	EXPECT_EQ( none.usedCount(), 0 );
+	EXPECT_EQ( none.readyCount(), 0 );
+}
+
+TEST( EventArenaTest, SizeClassesShareArena ) {
+	eventArena arena( g_traceRam );
+	latencyStore fast	 = latencyStore::create( arena, latencyStore::bytesFor( 4 ) );
+	throughputStore bulk = throughputStore::create( arena, throughputStore::bytesFor( 2 ) );
+
+	ASSERT_EQ( fast.packetCount(), 4 );
+	ASSERT_EQ( bulk.packetCount(), 2 );
+
+	latencyCollector control( CounterPlatform(), fast );
+	throughputCollector data( CounterPlatform(), bulk );
+
+	// Small packets close every two events, large ones every eight.
+	EXPECT_EQ( pushAndDrain( control, 6 ), ( vector<size_t>{ 2, 2, 2 } ) );
+	EXPECT_EQ( pushAndDrain( data, 12 ), ( vector<size_t>{ 8, 4 } ) );
+
+	// Packets went back to their own class, but the one armed for the next events.
+	EXPECT_EQ( fast.usedCount(), 1 );
+	EXPECT_EQ( bulk.usedCount(), 1 );
+}
+
+TEST( EventArenaTest, ExhaustedClassDropsLikeStaticPool ) {
+	eventArena arena( g_traceRam );
+	latencyStore fast = latencyStore::create( arena, latencyStore::bytesFor( 3 ) );
+	latencyCollector collector( CounterPlatform(), fast );
+	basicEventCollector<CounterPlatform, eventConfig<32, 2, 3>> reference;
+
+	// Same packets, byte for byte, as the build time pool of the same size.
+	for ( int round = 0; round < 2; round++ ) {
+		Event<arena_event_t> evt;
+
+		for ( uint32_t i = 0; i < 9; i++ ) {
+			evt.getParam()->value = i;
+			collector.pushEvent( &evt );
+			reference.pushEvent( &evt );
+		}
+
+		while ( true ) {
+			auto a = collector.getSendPacket();
+			auto b = reference.getSendPacket();
+
+			ASSERT_EQ( a.has_value(), b.has_value() );
+			if ( !a.has_value() ) {
+				break;
+			}
+			ASSERT_EQ( a.value().size(), b.value().size() );
+			EXPECT_EQ( memcmp( a.value().data(), b.value().data(), a.value().size() ), 0 );
+
+			collector.sendPacketCompleted();
+			reference.sendPacketCompleted();
+		}
+	}
+}
@@ -1,5 +1,6 @@
 #include <event.hpp>
 #include <eventCollector.hpp>
+#include <eventScope.hpp>
 #include <gtest/gtest.h>
 
 using namespace std;
@@ -13,6 +14,16 @@ template <> struct EventId<mock_event_t> {
 	static constexpr uint32_t value = 1;
 };
 
+// Mock scope event, `duration` is appended by the generator.
+typedef struct {
+	uint16_t value;
+	uint32_t duration;
+} __attribute__( ( packed ) ) mock_scope_event_t;
+
+template <> struct EventId<mock_scope_event_t> {
+	static constexpr uint32_t value = 2;
+};
+
 class TestPlatform : public eventPlatform {
 	uint64_t ts;
 
@@ -129,8 +140,98 @@ TEST_F( EventCollectorTest, SequentialPackets ) {
 	EXPECT_TRUE( span2.has_value() );
 	vector<byte> data2( span2.value().data(), span2.value().data() + span2.value().size() );
 
-	// Ensure spans are for different packet. Skip 20 byte header size.
-	for ( size_t i = 48; i < ( 48 + 10 ); i++ ) {
+	// Ensure spans are for different packet. Skip packet and event headers.
+	const size_t first = offsetof( packet_buffer_t, eventPayload ) + EventHeaderBytes;
+	for ( size_t i = first; i < ( first + 10 ); i++ ) {
 		EXPECT_NE( data1[ i ], data2[ i ] );
 	}
 }
+
+// Test: Scope guard emits one event with exit timestamp and duration
+TEST_F( EventCollectorTest, ScopeEventSingleRecord ) {
+	auto *collector = eventCollector::getInstance();
+	uint32_t id		= 0;
+	uint64_t ts		= 0;
+	uint16_t value	= 0;
+	uint32_t dur	= 0;
+
+	// Flush anything left by previous tests.
+	collector->forceSync();
+	for ( auto pkt = collector->getSendPacket(); pkt.has_value();
+		  pkt	   = collector->getSendPacket() ) {
+		collector->sendPacketCompleted();
+	}
+
+	{
+		EventScope<mock_scope_event_t> scope;
+		scope.getParam()->value = 0x1234;
+	}
+
+	collector->forceSync();
+	auto pkt = collector->getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+
+	// Skip packet header, read the only event: timestamp at the end of the
+	// event header, payload after it.
+	const std::byte *evt = pkt.value().data() + offsetof( packet_buffer_t, eventPayload );
+	memcpy( &id, evt, sizeof( id ) );
+	memcpy( &ts, evt + EventHeaderBytes - sizeof( ts ), sizeof( ts ) );
+	memcpy( &value, evt + EventHeaderBytes + offsetof( mock_scope_event_t, value ), sizeof( value ) );
+	memcpy( &dur, evt + EventHeaderBytes + offsetof( mock_scope_event_t, duration ), sizeof( dur ) );
+
+	EXPECT_EQ( id, 2 );
+	EXPECT_EQ( value, 0x1234 );
+	// Test clock advances by 100 on each read: the packet opened by the push
+	// reads it between entry and exit.
+	EXPECT_EQ( dur, 200 );
+	EXPECT_GE( ts, dur );
+
+	collector->sendPacketCompleted();
+}
+
+// Platform telling the clock reads made under the event lock apart.
+struct ScopeLockPlatform {
+	static inline uint64_t now			 = 0;
+	static inline bool locked			 = false;
+	static inline size_t unlockedReads	 = 0;
+
+	uint64_t getTimestamp() {
+		unlockedReads += !locked;
+		return now += 10;
+	}
+	bool eventTryLock() { return locked = true; }
+	void eventUnlock() { locked = false; }
+	void packetLock() {}
+	void packetUnlock() {}
+};
+
+// Test: the scope exit is stamped under the event lock
+TEST( EventScopeTest, ExitStampedUnderLock ) {
+	typedef basicEventCollector<ScopeLockPlatform, eventConfig<32, 2, 2>> scopeCollector;
+	typedef scopeCollector::packet_t::buffer_t scopeBuffer_t;
+
+	scopeCollector collector;
+	uint64_t ts	 = 0;
+	uint32_t dur = 0;
+
+	{
+		EventScope<mock_scope_event_t, scopeCollector> scope( &collector );
+	}
+
+	// Only the entry is read outside the lock.
+	EXPECT_EQ( ScopeLockPlatform::unlockedReads, 1 );
+
+	collector.forceSync();
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+
+	const std::byte *evt = pkt.value().data() + offsetof( scopeBuffer_t, eventPayload );
+	memcpy( &ts, evt + EventHeaderBytes - sizeof( ts ), sizeof( ts ) );
+	memcpy( &dur, evt + EventHeaderBytes + offsetof( mock_scope_event_t, duration ), sizeof( dur ) );
+	// Entry is the first read; the packet opened by the push reads the clock
+	// before the exit.
+	EXPECT_EQ( ts, ScopeLockPlatform::now );
+	EXPECT_EQ( dur, ts - 10 );
+	EXPECT_GE( ts, reinterpret_cast<const scopeBuffer_t *>( pkt.value().data() )->timestamp_begin );
+	collector.sendPacketCompleted();
+}
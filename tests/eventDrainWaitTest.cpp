@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include <basicEventCollector.hpp>
+#include <event.hpp>
+#include <posix/eventWake.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+// Mock event, two per packet.
+typedef struct {
+	uint32_t value;
+} __attribute__( ( packed ) ) wait_event_t;
+
+template <> struct EventId<wait_event_t> {
+	static constexpr uint32_t value = 23;
+};
+
+/* --------------------------------------------------------------------
+ *  Manual clock, no locking.  drainWait() runs the test hook standing in
+ *  for the producers, or lets the whole timeout pass.
+ * -------------------------------------------------------------------- */
+static uint64_t g_now = 0;
+static size_t g_waits = 0;
+static size_t g_wakes = 0;
+static function<void()> g_onWait;
+
+struct WaitPlatform {
+	uint64_t getTimestamp() { return g_now; }
+	bool eventTryLock() { return true; }
+	void eventUnlock() {}
+	void packetLock() {}
+	void packetUnlock() {}
+
+	void drainWait( uint64_t timeoutTicks ) {
+		g_waits++;
+		if ( g_onWait ) {
+			g_onWait();
+		} else {
+			g_now += timeoutTicks;
+		}
+	}
+	void drainWake() { g_wakes++; }
+};
+
+static_assert( EventPlatformDrainWake<WaitPlatform> );
+
+typedef eventConfig<32, 2, 8> waitConfig;
+typedef basicEventCollector<WaitPlatform, waitConfig> waitCollector;
+
+template <typename Collector> static void push( Collector &collector, uint32_t value ) {
+	Event<wait_event_t> evt;
+
+	evt.getParam()->value = value;
+	collector.pushEvent( &evt );
+}
+
+class EventDrainWaitTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		g_now	 = 1000;
+		g_waits	 = 0;
+		g_wakes	 = 0;
+		g_onWait = nullptr;
+	}
+	void TearDown() override { g_onWait = nullptr; }
+};
+
+TEST_F( EventDrainWaitTest, ReadyReturnsAtOnce ) {
+	waitCollector collector;
+
+	for ( uint32_t i = 0; i < 4; i++ ) {
+		push( collector, i );
+	}
+
+	EXPECT_EQ( collector.waitForPackets( 2, 100 ), 2 );
+	EXPECT_EQ( g_waits, 0 );
+	EXPECT_EQ( g_wakes, 0 );
+}
+
+TEST_F( EventDrainWaitTest, NoWakeWithoutWaiter ) {
+	waitCollector collector;
+
+	// Packet switches with nobody parked never call the hook.
+	for ( uint32_t i = 0; i < 12; i++ ) {
+		push( collector, i );
+	}
+	EXPECT_EQ( g_wakes, 0 );
+}
+
+TEST_F( EventDrainWaitTest, WakesOnceAtWatermark ) {
+	waitCollector collector;
+	uint32_t value = 0;
+
+	// Each wait sees one more packet queued.
+	g_onWait = [ & ] {
+		push( collector, value++ );
+		push( collector, value++ );
+	};
+
+	EXPECT_EQ( collector.waitForPackets( 3, 0 ), 3 );
+	EXPECT_EQ( g_waits, 3 );
+	EXPECT_EQ( g_wakes, 1 );
+
+	// Below the watermark the switches stayed silent, and still are.
+	g_onWait = nullptr;
+	push( collector, value++ );
+	push( collector, value++ );
+	EXPECT_EQ( g_wakes, 1 );
+}
+
+TEST_F( EventDrainWaitTest, TimeoutFlushes ) {
+	waitCollector collector;
+
+	push( collector, 7 );
+
+	// Nothing ready: the wait gets the whole timeout, then the partial
+	// packet is closed and handed over.
+	EXPECT_EQ( collector.waitForPackets( 4, 100 ), 1 );
+	EXPECT_EQ( g_waits, 1 );
+	EXPECT_EQ( g_now, 1100 );
+
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	collector.sendPacketCompleted();
+
+	// A quiet collector times out with nothing to hand over.
+	EXPECT_EQ( collector.waitForPackets( 1, 50 ), 0 );
+	EXPECT_FALSE( collector.getSendPacket().has_value() );
+}
+
+/* --------------------------------------------------------------------
+ *  eventfd hook with real threads.
+ * -------------------------------------------------------------------- */
+TEST( EventWakeFdTest, KeepsEarlyWake ) {
+	eventWakeFd wake;
+
+	ASSERT_TRUE( wake.valid() );
+	EXPECT_FALSE( wake.wait( 1000000 ) );
+
+	// Given before the wait, consumed by one wait.
+	wake.wake();
+	wake.wake();
+	EXPECT_TRUE( wake.wait( 1000000 ) );
+	EXPECT_FALSE( wake.wait( 1000000 ) );
+}
+
+static eventWakeFd *g_wakeFd = nullptr;
+static mutex g_eventMutex;
+static mutex g_packetMutex;
+
+struct ThreadPlatform {
+	uint64_t getTimestamp() {
+		struct timespec ts;
+
+		clock_gettime( CLOCK_MONOTONIC, &ts );
+		return static_cast<uint64_t>( ts.tv_sec ) * 1000000000ULL + static_cast<uint64_t>( ts.tv_nsec );
+	}
+	bool eventTryLock() {
+		g_eventMutex.lock();
+		return true;
+	}
+	void eventUnlock() { g_eventMutex.unlock(); }
+	void packetLock() { g_packetMutex.lock(); }
+	void packetUnlock() { g_packetMutex.unlock(); }
+
+	void drainWait( uint64_t timeoutTicks ) { g_wakeFd->wait( timeoutTicks ); }
+	void drainWake() { g_wakeFd->wake(); }
+};
+
+TEST( EventWakeFdTest, DrainThreadParks ) {
+	typedef basicEventCollector<ThreadPlatform, waitConfig> threadCollector;
+	typedef threadCollector::packet_t::buffer_t threadBuffer_t;
+
+	eventWakeFd wake;
+	threadCollector collector;
+	atomic<bool> done	  = false;
+	size_t events		  = 0;
+	constexpr size_t each = eventAlignUp( EventHeaderBytes + sizeof( wait_event_t ) );
+
+	auto drain = [ & ] {
+		for ( auto pkt = collector.getSendPacket(); pkt.has_value(); pkt = collector.getSendPacket() ) {
+			const auto *buf = reinterpret_cast<const threadBuffer_t *>( pkt.value().data() );
+
+			events += ( buf->content_size / 8 - offsetof( threadBuffer_t, eventPayload ) + each - 1 ) / each;
+			collector.sendPacketCompleted();
+		}
+	};
+
+	g_wakeFd = &wake;
+	thread producer( [ & ] {
+		for ( uint32_t i = 0; i < 24; i++ ) {
+			push( collector, i );
+			this_thread::sleep_for( chrono::microseconds( 200 ) );
+		}
+		done = true;
+	} );
+
+	while ( !done ) {
+		collector.waitForPackets( 3, 20000000 );
+		drain();
+	}
+	producer.join();
+
+	// The timeout hands over the tail.
+	collector.waitForPackets( 1, 1000000 );
+	drain();
+	g_wakeFd = nullptr;
+
+	EXPECT_EQ( events, 24 );
+}
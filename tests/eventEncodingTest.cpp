@@ -0,0 +1,297 @@
+#include <gtest/gtest.h>
+
+#include <basicEventCollector.hpp>
+#include <event.hpp>
+#include <eventEncoding.hpp>
+
+#include <cstring>
+#include <vector>
+
+#include "counterPlatform.hpp"
+
+using namespace std;
+
+// Mock event with encoded fields, same shape as the generated one for
+//   seq: uint32_t delta, level: int16_t zigzag, len: uint16_t varint, tag: uint8_t
+typedef struct {
+	uint32_t seq;
+	int16_t level;
+	uint16_t len;
+	uint8_t tag;
+} __attribute__( ( packed ) ) enc_event_t;
+
+template <> struct EventId<enc_event_t> {
+	static constexpr uint32_t value = 16;
+};
+
+template <> struct EventEncoding<enc_event_t> {
+	typedef struct {
+		uint32_t seq;
+	} state_t;
+
+	static constexpr std::size_t bytesMax = 12;
+
+	static std::byte *encode( const enc_event_t &e, state_t &prev, std::byte *out ) {
+		out = eventEncodeDelta( out, e.seq, prev.seq );
+		out = eventEncodeZigzag( out, e.level );
+		out = eventEncodeVarint( out, e.len );
+		out = eventEncodeBytes( out, &e.tag, sizeof( e.tag ) );
+		return out;
+	}
+};
+
+static_assert( EventEncoded<enc_event_t> );
+static_assert( !EventEncoded<uint32_t> );
+
+typedef eventConfig<32, 4, 2> encodingConfig;
+typedef basicEventCollector<CounterPlatform, encodingConfig> encodingCollector;
+typedef encodingCollector::packet_t::buffer_t encodingBuffer_t;
+
+// Decoded payload of one event.
+typedef struct {
+	uint32_t seq;
+	int16_t level;
+	uint16_t len;
+	uint8_t tag;
+} decoded_t;
+
+static int32_t readTagged( const uint8_t *&p, bool isSigned ) {
+	uint8_t width  = *p++;
+	uint32_t value = 0;
+
+	memcpy( &value, p, width );
+	p += width;
+	if ( isSigned && width > 0 && width < 4 && ( value >> ( width * 8 - 1 ) ) ) {
+		value |= ~0u << ( width * 8 );
+	}
+	return static_cast<int32_t>( value );
+}
+
+// Events of the next flushed packet, delta values rebuilt as a reader does.
+static vector<decoded_t> drain( encodingCollector &collector ) {
+	vector<decoded_t> out;
+	uint32_t seq = 0;
+
+	collector.forceSync();
+	auto pkt = collector.getSendPacket();
+	if ( !pkt.has_value() ) {
+		return out;
+	}
+
+	const auto *raw		= reinterpret_cast<const uint8_t *>( pkt.value().data() );
+	const auto *buf		= reinterpret_cast<const encodingBuffer_t *>( raw );
+	const uint8_t *payload = raw + offsetof( encodingBuffer_t, eventPayload );
+	size_t size			= buf->content_size / 8 - offsetof( encodingBuffer_t, eventPayload );
+	size_t pos			= 0;
+
+	while ( pos < size ) {
+		const uint8_t *p = payload + eventAlignUp( pos ) + EventHeaderBytes;
+		decoded_t d		 = {};
+
+		seq += static_cast<uint32_t>( readTagged( p, true ) );
+		d.seq	= seq;
+		d.level = static_cast<int16_t>( readTagged( p, true ) );
+		d.len	= static_cast<uint16_t>( readTagged( p, false ) );
+		d.tag	= *p++;
+		out.push_back( d );
+		pos = static_cast<size_t>( p - payload );
+	}
+
+	collector.sendPacketCompleted();
+	return out;
+}
+
+static Event<enc_event_t> makeEvent( uint32_t seq, int16_t level, uint16_t len ) {
+	Event<enc_event_t> evt;
+
+	evt.getParam()->seq	  = seq;
+	evt.getParam()->level = level;
+	evt.getParam()->len	  = len;
+	evt.getParam()->tag	  = 0x5A;
+	return evt;
+}
+
+TEST( EventEncodingTest, ValueWidths ) {
+	std::byte out[ 8 ];
+	uint8_t prev8 = 250;
+
+	EXPECT_EQ( eventEncodeVarint( out, uint32_t( 0 ) ) - out, 1 );
+	EXPECT_EQ( eventEncodeVarint( out, uint32_t( 200 ) ) - out, 2 );
+	EXPECT_EQ( eventEncodeVarint( out, uint32_t( 300 ) ) - out, 3 );
+	EXPECT_EQ( eventEncodeVarint( out, uint32_t( 70000 ) ) - out, 5 );
+	EXPECT_EQ( eventEncodeZigzag( out, int32_t( -1 ) ) - out, 2 );
+	EXPECT_EQ( eventEncodeZigzag( out, int32_t( -200 ) ) - out, 3 );
+	EXPECT_EQ( eventEncodeZigzag( out, int32_t( -70000 ) ) - out, 5 );
+
+	// Wraps modulo the field width: 250 -> 5 is +11.
+	EXPECT_EQ( eventEncodeDelta( out, uint8_t( 5 ), prev8 ) - out, 2 );
+	EXPECT_EQ( out[ 1 ], std::byte{ 11 } );
+	EXPECT_EQ( prev8, 5 );
+}
+
+TEST( EventEncodingTest, DeltasRebuildValues ) {
+	encodingCollector collector;
+	const uint32_t seqs[]	= { 100000, 100001, 100003, 99999 };
+	const int16_t levels[] = { 0, -5, 300, -32768 };
+
+	for ( size_t i = 0; i < 3; i++ ) {
+		auto evt = makeEvent( seqs[ i ], levels[ i ], static_cast<uint16_t>( i * 200 ) );
+		collector.pushEvent( &evt );
+	}
+
+	auto events = drain( collector );
+	ASSERT_EQ( events.size(), 3 );
+	for ( size_t i = 0; i < 3; i++ ) {
+		EXPECT_EQ( events[ i ].seq, seqs[ i ] );
+		EXPECT_EQ( events[ i ].level, levels[ i ] );
+		EXPECT_EQ( events[ i ].len, i * 200 );
+		EXPECT_EQ( events[ i ].tag, 0x5A );
+	}
+
+	// A negative delta and the smallest level.
+	auto evt = makeEvent( seqs[ 3 ], levels[ 3 ], 0 );
+	collector.pushEvent( &evt );
+	events = drain( collector );
+	ASSERT_EQ( events.size(), 1 );
+	EXPECT_EQ( events[ 0 ].seq, seqs[ 3 ] );
+	EXPECT_EQ( events[ 0 ].level, levels[ 3 ] );
+}
+
+TEST( EventEncodingTest, SmallerThanRawPayload ) {
+	encodingCollector collector;
+
+	for ( uint32_t i = 0; i < encodingConfig::eventMaxPerPacket; i++ ) {
+		auto evt = makeEvent( 500000 + i, 1, 2 );
+		collector.pushEvent( &evt );
+	}
+
+	collector.forceSync();
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	const auto *buf = reinterpret_cast<const encodingBuffer_t *>( pkt.value().data() );
+
+	// First event: 5 + 2 + 2 + 1 bytes, next ones 2 + 2 + 2 + 1.
+	size_t encoded = offsetof( encodingBuffer_t, eventPayload );
+	size_t raw	   = offsetof( encodingBuffer_t, eventPayload );
+	for ( uint32_t i = 0; i < encodingConfig::eventMaxPerPacket; i++ ) {
+		encoded = eventAlignUp( encoded ) + EventHeaderBytes + ( i == 0 ? 10 : 7 );
+		raw		= eventAlignUp( raw ) + EventHeaderBytes + sizeof( enc_event_t );
+	}
+	EXPECT_EQ( buf->content_size, encoded * 8 );
+	EXPECT_LT( encoded, raw );
+	collector.sendPacketCompleted();
+}
+
+TEST( EventEncodingTest, PacketFilledByBytes ) {
+	encodingCollector collector;
+	size_t events = 0;
+
+	// Encoded events take their bytes, not a slot of eventSizeMax.
+	while ( !collector.getSendPacket().has_value() ) {
+		auto evt = makeEvent( 1000 + static_cast<uint32_t>( events++ ), 0, 0 );
+		collector.pushEvent( &evt );
+	}
+
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	const auto *buf = reinterpret_cast<const encodingBuffer_t *>( pkt.value().data() );
+	size_t payload	= buf->content_size / 8 - offsetof( encodingBuffer_t, eventPayload );
+
+	EXPECT_GT( events, encodingConfig::eventMaxPerPacket );
+	// Closed once an event of eventSizeMax no longer fits.
+	EXPECT_GT( eventAlignUp( payload ) + encodingConfig::eventSizeMax, buf->eventPayload.size() );
+	collector.sendPacketCompleted();
+}
+
+TEST( EventEncodingTest, ResetAtPacketBoundary ) {
+	encodingCollector collector;
+
+	// Fills one packet, the next events open a new one.
+	for ( uint32_t i = 0; i < 3 * encodingConfig::eventMaxPerPacket; i++ ) {
+		auto evt = makeEvent( 1000 + i, 0, 0 );
+		collector.pushEvent( &evt );
+	}
+
+	auto first = drain( collector );
+	ASSERT_GT( first.size(), encodingConfig::eventMaxPerPacket );
+	EXPECT_EQ( first.back().seq, 1000 + first.size() - 1 );
+
+	// Decodes on its own: the delta starts from 0 again.
+	auto second = drain( collector );
+	ASSERT_FALSE( second.empty() );
+	EXPECT_EQ( second[ 0 ].seq, 1000 + first.size() );
+}
+
+TEST( EventEncodingTest, BatchEncoded ) {
+	encodingCollector collector;
+	vector<Event<enc_event_t>> burst;
+
+	for ( uint32_t i = 0; i < 3; i++ ) {
+		burst.push_back( makeEvent( 7 * i, static_cast<int16_t>( -i ), 1 ) );
+	}
+	collector.pushEvents( span( burst ) );
+
+	auto events = drain( collector );
+	ASSERT_EQ( events.size(), 3 );
+	for ( uint32_t i = 0; i < 3; i++ ) {
+		EXPECT_EQ( events[ i ].seq, 7 * i );
+		EXPECT_EQ( events[ i ].level, -static_cast<int16_t>( i ) );
+	}
+}
+
+TEST( EventEncodingTest, StatePerCollector ) {
+	encodingCollector first;
+	encodingCollector second;
+
+	// Alternate pushes do not see the previous values of the other collector.
+	for ( uint32_t i = 0; i < 3; i++ ) {
+		auto a = makeEvent( 1000 + i, 0, 0 );
+		auto b = makeEvent( 9000 - i, 0, 0 );
+		first.pushEvent( &a );
+		second.pushEvent( &b );
+	}
+
+	auto events = drain( first );
+	ASSERT_EQ( events.size(), 3 );
+	for ( uint32_t i = 0; i < 3; i++ ) {
+		EXPECT_EQ( events[ i ].seq, 1000 + i );
+	}
+
+	events = drain( second );
+	ASSERT_EQ( events.size(), 3 );
+	for ( uint32_t i = 0; i < 3; i++ ) {
+		EXPECT_EQ( events[ i ].seq, 9000 - i );
+	}
+}
+
+// Config keeping the state of no encoded type.
+struct noEncodingConfig : eventConfig<32, 4, 2> {
+	static constexpr std::size_t encodedTypesMax = 0;
+};
+
+// Payload copied as is.
+typedef struct {
+	uint32_t value;
+} __attribute__( ( packed ) ) plain_event_t;
+
+template <> struct EventId<plain_event_t> {
+	static constexpr uint32_t value = 17;
+};
+
+TEST( EventEncodingTest, DroppedWithoutSlot ) {
+	basicEventCollector<CounterPlatform, noEncodingConfig> collector;
+	auto evt = makeEvent( 1, 0, 0 );
+	Event<plain_event_t> plain;
+
+	collector.pushEvent( &evt );
+	collector.pushEvent( &plain );
+	collector.forceSync();
+
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	const auto *buf = reinterpret_cast<const encodingBuffer_t *>( pkt.value().data() );
+	EXPECT_EQ( buf->events_discarded, 1 );
+	EXPECT_EQ( buf->content_size / 8,
+			   offsetof( encodingBuffer_t, eventPayload ) + EventHeaderBytes + sizeof( plain_event_t ) );
+	collector.sendPacketCompleted();
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <basicEventCollector.hpp>
+#include <event.hpp>
+
+#include <vector>
+
+#include "counterPlatform.hpp"
+
+using namespace std;
+
+// Mock event, two per packet.
+typedef struct {
+	uint32_t value;
+} __attribute__( ( packed ) ) fan_event_t;
+
+template <> struct EventId<fan_event_t> {
+	static constexpr uint32_t value = 24;
+};
+
+typedef eventConfig<32, 2, 8> fanConfig;
+
+// Store counting the packets returned to the pool.
+static size_t g_released = 0;
+
+struct FanStore : eventPacketStore<fanConfig> {
+	void release( packet_t *pkt ) {
+		g_released++;
+		eventPacketStore<fanConfig>::release( pkt );
+	}
+};
+
+typedef basicEventCollector<CounterPlatform, fanConfig, FanStore> fanCollector;
+typedef fanCollector::packet_t::buffer_t fanBuffer_t;
+
+static void push( fanCollector &collector, uint32_t count ) {
+	for ( uint32_t i = 0; i < count; i++ ) {
+		Event<fan_event_t> evt;
+
+		evt.getParam()->value = i;
+		collector.pushEvent( &evt );
+	}
+}
+
+// Sequence numbers of the packets a consumer drains.
+static vector<uint32_t> drain( fanCollector &collector, size_t id ) {
+	vector<uint32_t> seqs;
+
+	for ( auto pkt = collector.getSendPacket( id ); pkt.has_value(); pkt = collector.getSendPacket( id ) ) {
+		seqs.push_back( reinterpret_cast<const fanBuffer_t *>( pkt.value().data() )->packet_seq_count );
+		collector.sendPacketCompleted( id );
+	}
+	return seqs;
+}
+
+class EventFanOutTest : public ::testing::Test {
+protected:
+	void SetUp() override { g_released = 0; }
+};
+
+TEST_F( EventFanOutTest, SharedWithoutCopy ) {
+	fanCollector collector;
+	auto a = collector.addConsumer();
+	auto b = collector.addConsumer();
+
+	ASSERT_TRUE( a.has_value() && b.has_value() );
+	EXPECT_FALSE( collector.addConsumer().has_value() );
+
+	push( collector, 2 );
+	auto pa = collector.getSendPacket( *a );
+	auto pb = collector.getSendPacket( *b );
+	ASSERT_TRUE( pa.has_value() && pb.has_value() );
+	EXPECT_EQ( pa->data(), pb->data() );
+
+	// Back to the pool with the last release only.
+	collector.sendPacketCompleted( *a );
+	EXPECT_EQ( g_released, 0 );
+	collector.sendPacketCompleted( *b );
+	EXPECT_EQ( g_released, 1 );
+}
+
+TEST_F( EventFanOutTest, IndependentCursors ) {
+	fanCollector collector;
+	auto a = collector.addConsumer();
+	auto b = collector.addConsumer();
+
+	push( collector, 6 );
+	EXPECT_EQ( drain( collector, *a ), vector<uint32_t>( { 0, 1, 2 } ) );
+
+	push( collector, 2 );
+	EXPECT_EQ( drain( collector, *b ), vector<uint32_t>( { 0, 1, 2, 3 } ) );
+	EXPECT_EQ( drain( collector, *a ), vector<uint32_t>( { 3 } ) );
+	EXPECT_EQ( g_released, 4 );
+
+	// A retry before completion returns the same packet.
+	push( collector, 2 );
+	auto first = collector.getSendPacket( *a );
+	auto again = collector.getSendPacket( *a );
+	ASSERT_TRUE( first.has_value() && again.has_value() );
+	EXPECT_EQ( first->data(), again->data() );
+}
+
+TEST_F( EventFanOutTest, LossyConsumerSkips ) {
+	fanCollector collector;
+	auto live = collector.addConsumer();
+	auto slow = collector.addConsumer( 1 );
+
+	// The slow consumer keeps one packet, the older ones are released
+	// as soon as the live one is done with them.
+	push( collector, 8 );
+	EXPECT_EQ( drain( collector, *live ), vector<uint32_t>( { 0, 1, 2, 3 } ) );
+	EXPECT_EQ( g_released, 3 );
+	EXPECT_EQ( collector.getConsumerLost( *slow ), 3 );
+	EXPECT_EQ( drain( collector, *slow ), vector<uint32_t>( { 3 } ) );
+	EXPECT_EQ( g_released, 4 );
+	EXPECT_EQ( collector.getConsumerLost( *live ), 0 );
+}
+
+TEST_F( EventFanOutTest, LaterConsumer ) {
+	fanCollector collector;
+
+	// Queued before any consumer: kept for the first one.
+	push( collector, 2 );
+	auto a = collector.addConsumer();
+	auto b = collector.addConsumer();
+	push( collector, 2 );
+
+	EXPECT_EQ( drain( collector, *a ), vector<uint32_t>( { 0, 1 } ) );
+	EXPECT_EQ( drain( collector, *b ), vector<uint32_t>( { 1 } ) );
+	EXPECT_EQ( g_released, 2 );
+}
+
+TEST_F( EventFanOutTest, RemoveReleases ) {
+	fanCollector collector;
+	auto a = collector.addConsumer();
+	auto b = collector.addConsumer();
+
+	push( collector, 6 );
+	drain( collector, *a );
+	ASSERT_TRUE( collector.getSendPacket( *b ).has_value() );
+	EXPECT_EQ( g_released, 0 );
+
+	// The held packet and the two unread ones.
+	collector.removeConsumer( *b );
+	EXPECT_EQ( g_released, 3 );
+
+	// The slot is free again.
+	EXPECT_EQ( collector.addConsumer(), b );
+}
+
+TEST_F( EventFanOutTest, HeldPacketOutlivesRing ) {
+	fanCollector collector;
+	auto slow = collector.addConsumer( 1 );
+	auto live = collector.addConsumer();
+
+	push( collector, 2 );
+	auto held = collector.getSendPacket( *slow );
+	ASSERT_TRUE( held.has_value() );
+
+	// The ring wraps twice past the packet the slow consumer holds.
+	for ( uint32_t round = 0; round < 2 * fanConfig::packetCountMax; round++ ) {
+		push( collector, 2 );
+		EXPECT_EQ( drain( collector, *live ).size(), round == 0 ? 2 : 1 );
+	}
+	EXPECT_EQ( reinterpret_cast<const fanBuffer_t *>( held->data() )->packet_seq_count, 0 );
+	EXPECT_EQ( g_released, 15 );
+
+	collector.sendPacketCompleted( *slow );
+	EXPECT_EQ( g_released, 16 );
+	EXPECT_EQ( drain( collector, *slow ), vector<uint32_t>( { 16 } ) );
+	EXPECT_EQ( g_released, 17 );
+	EXPECT_EQ( collector.getConsumerLost( *slow ), 15 );
+}
@@ -0,0 +1,271 @@
+#include <gtest/gtest.h>
+
+#include <basicEventCollector.hpp>
+#include <event.hpp>
+#include <posix/eventFileSink.hpp>
+
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+
+#include <sys/resource.h>
+
+#include "counterPlatform.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Mock event written through the sink.
+typedef struct {
+	uint32_t value;
+} __attribute__( ( packed ) ) sink_event_t;
+
+template <> struct EventId<sink_event_t> {
+	static constexpr uint32_t value = 8;
+};
+
+// Two events per packet, eight packets.
+typedef eventConfig<32, 2, 8> sinkConfig;
+typedef basicEventCollector<CounterPlatform, sinkConfig> sinkCollector;
+typedef sinkCollector::packet_t::buffer_t sinkBuffer_t;
+
+static string readFile( const fs::path &path ) {
+	ifstream in( path, ios::binary );
+	return string( istreambuf_iterator<char>( in ), istreambuf_iterator<char>() );
+}
+
+class EventFileSinkTest : public ::testing::Test {
+protected:
+	fs::path root;
+	fs::path traceDir;
+	fs::path metadata;
+
+	void SetUp() override {
+		char tmpl[] = "/tmp/evt_sink_XXXXXX";
+
+		ASSERT_NE( mkdtemp( tmpl ), nullptr );
+		root	 = tmpl;
+		traceDir = root / "trace" / "run";
+		metadata = root / "metadata";
+		ofstream( metadata ) << "/* CTF 1.8 */\n";
+	}
+
+	void TearDown() override { fs::remove_all( root ); }
+
+	// Fill `packets` full packets into `collector`.
+	static void fill( sinkCollector &collector, uint32_t packets ) {
+		Event<sink_event_t> evt;
+
+		for ( uint32_t i = 0; i < packets * sinkConfig::eventMaxPerPacket; i++ ) {
+			evt.getParam()->value = i;
+			collector.pushEvent( &evt );
+		}
+	}
+
+	set<string> files() const {
+		set<string> names;
+
+		for ( const auto &ent : fs::directory_iterator( traceDir ) ) {
+			names.insert( ent.path().filename().string() );
+		}
+		return names;
+	}
+};
+
+TEST_F( EventFileSinkTest, WritesTraceDirectory ) {
+	eventFileSink sink;
+	sinkCollector mainStream;
+	sinkCollector driverStream;
+
+	ASSERT_TRUE( sink.open( { .directory = traceDir.c_str(), .metadataPath = metadata.c_str() } ) );
+
+	mainStream.setStreamId( 3 );
+	driverStream.setStreamId( 5 );
+	fill( mainStream, 2 );
+	fill( driverStream, 1 );
+	EXPECT_EQ( sink.drain( mainStream ), 2 );
+	EXPECT_EQ( sink.drain( driverStream ), 1 );
+	ASSERT_TRUE( sink.close() );
+
+	EXPECT_EQ( files(), ( set<string>{ "metadata", "stream3_000000", "stream5_000000" } ) );
+	EXPECT_EQ( readFile( traceDir / "metadata" ), readFile( metadata ) );
+
+	// Whole packets, in order, file size trimmed to the data.
+	string data = readFile( traceDir / "stream3_000000" );
+	ASSERT_EQ( data.size(), 2 * sizeof( sinkBuffer_t ) );
+	for ( uint32_t seq = 0; seq < 2; seq++ ) {
+		const auto *buf = reinterpret_cast<const sinkBuffer_t *>( data.data() + seq * sizeof( sinkBuffer_t ) );
+		EXPECT_EQ( buf->stream_id, 3 );
+		EXPECT_EQ( buf->packet_seq_count, seq );
+	}
+	EXPECT_EQ( fs::file_size( traceDir / "stream5_000000" ), sizeof( sinkBuffer_t ) );
+}
+
+TEST_F( EventFileSinkTest, RotatesBySizeWithRetention ) {
+	eventFileSink sink;
+	sinkCollector collector;
+	eventFileSinkConfig cfg;
+
+	cfg.directory	   = traceDir.c_str();
+	cfg.segmentBytes   = 2 * sizeof( sinkBuffer_t );
+	cfg.retainSegments = 2;
+	cfg.batchBytes	   = 64;
+	ASSERT_TRUE( sink.open( cfg ) );
+
+	collector.setStreamId( 1 );
+	fill( collector, 7 );
+	EXPECT_EQ( sink.drain( collector ), 7 );
+	ASSERT_TRUE( sink.close() );
+
+	// Segments 0 and 1 dropped, 2 holds packets 4-5 and 3 packet 6.
+	EXPECT_EQ( files(), ( set<string>{ "stream1_000002", "stream1_000003" } ) );
+	EXPECT_EQ( fs::file_size( traceDir / "stream1_000002" ), 2 * sizeof( sinkBuffer_t ) );
+
+	string last = readFile( traceDir / "stream1_000003" );
+	ASSERT_EQ( last.size(), sizeof( sinkBuffer_t ) );
+	EXPECT_EQ( reinterpret_cast<const sinkBuffer_t *>( last.data() )->packet_seq_count, 6 );
+}
+
+TEST_F( EventFileSinkTest, RotatesByAge ) {
+	eventFileSink sink;
+	sinkCollector collector;
+	eventFileSinkConfig cfg;
+
+	// Every segment is already old when the next packet arrives.
+	cfg.directory = traceDir.c_str();
+	cfg.segmentNs = 1;
+	cfg.syncBytes = 1;
+	ASSERT_TRUE( sink.open( cfg ) );
+
+	collector.setStreamId( 2 );
+	fill( collector, 3 );
+	EXPECT_EQ( sink.drain( collector ), 3 );
+	ASSERT_TRUE( sink.close() );
+
+	EXPECT_EQ( files(), ( set<string>{ "stream2_000000", "stream2_000001", "stream2_000002" } ) );
+}
+
+TEST_F( EventFileSinkTest, ResumesNumberingAfterRestart ) {
+	eventFileSinkConfig cfg;
+	sinkCollector collector;
+
+	cfg.directory	   = traceDir.c_str();
+	cfg.retainSegments = 2;
+	collector.setStreamId( 4 );
+
+	for ( int run = 0; run < 3; run++ ) {
+		eventFileSink sink;
+
+		ASSERT_TRUE( sink.open( cfg ) );
+		fill( collector, 1 );
+		EXPECT_EQ( sink.drain( collector ), 1 );
+		EXPECT_TRUE( sink.flush() );
+	}
+
+	// Third run continues at 2 and keeps the newest two segments.
+	EXPECT_EQ( files(), ( set<string>{ "stream4_000001", "stream4_000002" } ) );
+}
+
+// Thread and interrupt level, chosen by the test.
+static size_t g_sinkLevel = 0;
+
+struct LevelSinkPlatform : CounterPlatform {
+	static constexpr size_t execLevelCount = 2;
+
+	size_t getExecLevel() { return g_sinkLevel; }
+};
+
+TEST_F( EventFileSinkTest, FileSetPerExecLevel ) {
+	basicEventCollector<LevelSinkPlatform, sinkConfig> collector;
+	Event<sink_event_t> evt;
+	eventFileSinkConfig cfg;
+
+	cfg.directory = traceDir.c_str();
+	collector.setStreamId( 1 );
+
+	// Level 0, level 1, level 0 again: one full packet each.
+	for ( size_t level : { 0, 1, 0 } ) {
+		g_sinkLevel = level;
+		for ( uint32_t i = 0; i < sinkConfig::eventMaxPerPacket; i++ ) {
+			collector.pushEvent( &evt );
+		}
+	}
+	g_sinkLevel = 0;
+
+	{
+		eventFileSink sink;
+
+		ASSERT_TRUE( sink.open( cfg ) );
+		EXPECT_EQ( sink.drain( collector ), 3 );
+		ASSERT_TRUE( sink.close() );
+	}
+	EXPECT_EQ( files(), ( set<string>{ "stream1_000000", "stream1_l1_000000" } ) );
+
+	// Each file holds the sequence of its level alone.
+	string data = readFile( traceDir / "stream1_000000" );
+	ASSERT_EQ( data.size(), 2 * sizeof( sinkBuffer_t ) );
+	for ( uint32_t seq = 0; seq < 2; seq++ ) {
+		const auto *buf = reinterpret_cast<const sinkBuffer_t *>( data.data() + seq * sizeof( sinkBuffer_t ) );
+		EXPECT_EQ( buf->packet_seq_count, seq );
+	}
+	data = readFile( traceDir / "stream1_l1_000000" );
+	ASSERT_EQ( data.size(), sizeof( sinkBuffer_t ) );
+	EXPECT_EQ( reinterpret_cast<const sinkBuffer_t *>( data.data() )->packet_seq_count, 0 );
+
+	// Numbering of level 0 resumes on its own segments only.
+	{
+		eventFileSink sink;
+
+		ASSERT_TRUE( sink.open( cfg ) );
+		for ( uint32_t i = 0; i < sinkConfig::eventMaxPerPacket; i++ ) {
+			collector.pushEvent( &evt );
+		}
+		EXPECT_EQ( sink.drain( collector ), 1 );
+		ASSERT_TRUE( sink.close() );
+	}
+	EXPECT_EQ( files(), ( set<string>{ "stream1_000000", "stream1_000001", "stream1_l1_000000" } ) );
+}
+
+TEST_F( EventFileSinkTest, FailedWriteKeepsBatch ) {
+	eventFileSink sink;
+	sinkCollector collector;
+	eventFileSinkConfig cfg;
+	struct rlimit prev;
+	struct rlimit limit;
+
+	cfg.directory	 = traceDir.c_str();
+	cfg.segmentBytes = 8 * sizeof( sinkBuffer_t );
+	ASSERT_TRUE( sink.open( cfg ) );
+
+	collector.setStreamId( 1 );
+	fill( collector, 3 );
+	EXPECT_EQ( sink.drain( collector ), 3 );
+
+	// Room for one packet and a half: the batch write fails part way.
+	ASSERT_EQ( getrlimit( RLIMIT_FSIZE, &prev ), 0 );
+	limit		   = prev;
+	limit.rlim_cur = sizeof( sinkBuffer_t ) * 3 / 2;
+	signal( SIGXFSZ, SIG_IGN );
+	ASSERT_EQ( setrlimit( RLIMIT_FSIZE, &limit ), 0 );
+
+	EXPECT_FALSE( sink.flush() );
+
+	setrlimit( RLIMIT_FSIZE, &prev );
+	signal( SIGXFSZ, SIG_DFL );
+
+	// Cut back to no packet, then the kept batch goes out whole.
+	EXPECT_EQ( fs::file_size( traceDir / "stream1_000000" ), 0 );
+	EXPECT_TRUE( sink.flush() );
+	ASSERT_TRUE( sink.close() );
+
+	string data = readFile( traceDir / "stream1_000000" );
+	ASSERT_EQ( data.size(), 3 * sizeof( sinkBuffer_t ) );
+	for ( uint32_t seq = 0; seq < 3; seq++ ) {
+		const auto *buf = reinterpret_cast<const sinkBuffer_t *>( data.data() + seq * sizeof( sinkBuffer_t ) );
+		EXPECT_EQ( buf->packet_seq_count, seq );
+	}
+}
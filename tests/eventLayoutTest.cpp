@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <basicEventCollector.hpp>
+#include <event.hpp>
+#include <eventLog.hpp>
+
+#include <cstddef>
+#include <cstring>
+
+#include "counterPlatform.hpp"
+
+using namespace std;
+
+// Written against EventHeaderBytes / EventAlignment, holds for the packed
+// and the aligned (EVENT_ALIGNED_LAYOUT) build alike.
+
+// Odd sized payload: aligned events leave padding behind it.
+typedef struct {
+	uint32_t value;
+	uint8_t tag;
+} __attribute__( ( packed ) ) layout_event_t;
+
+// Raw event (header and payload) of the configuration's eventSizeMax.
+typedef struct {
+	uint8_t bytes[ 32 - EventHeaderBytes ];
+} layout_full_t;
+
+template <> struct EventId<layout_event_t> {
+	static constexpr uint32_t value = 12;
+};
+
+template <> struct EventId<layout_full_t> {
+	static constexpr uint32_t value = 13;
+};
+
+typedef eventConfig<32, 4, 2> layoutConfig;
+typedef basicEventCollector<CounterPlatform, layoutConfig> layoutCollector;
+typedef layoutCollector::packet_t::buffer_t layoutBuffer_t;
+
+static constexpr size_t payloadOffset = offsetof( layoutBuffer_t, eventPayload );
+
+static_assert( payloadOffset % EventAlignment == 0 );
+static_assert( offsetof( layoutBuffer_t, timestamp_begin ) == ( EventAlignment > 1 ? 8 : 4 ) );
+static_assert( offsetof( EventLogRecord<2>, args ) == ( EventAlignment > 1 ? 8 : 5 ) );
+
+TEST( EventLayoutTest, EventsStartOnEventBoundary ) {
+	layoutCollector collector;
+	Event<layout_event_t> evt;
+
+	for ( uint32_t i = 0; i < layoutConfig::eventMaxPerPacket; i++ ) {
+		evt.getParam()->value = 100 + i;
+		evt.getParam()->tag	  = static_cast<uint8_t>( i );
+		collector.pushEvent( &evt );
+	}
+
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	const auto *raw = reinterpret_cast<const uint8_t *>( pkt.value().data() );
+	const auto *buf = reinterpret_cast<const layoutBuffer_t *>( raw );
+
+	size_t offset = payloadOffset;
+	size_t end	  = 0;
+	for ( uint32_t i = 0; i < layoutConfig::eventMaxPerPacket; i++ ) {
+		uint32_t id	   = 0;
+		uint64_t ts	   = 0;
+		uint32_t value = 0;
+
+		EXPECT_EQ( offset % EventAlignment, 0 );
+		memcpy( &id, raw + offset, sizeof( id ) );
+		memcpy( &ts, raw + offset + EventHeaderBytes - sizeof( ts ), sizeof( ts ) );
+		memcpy( &value, raw + offset + EventHeaderBytes, sizeof( value ) );
+		EXPECT_EQ( id, 12 );
+		EXPECT_EQ( ts, 10 * ( i + 2 ) ); // first clock read opened the packet
+		EXPECT_EQ( value, 100 + i );
+		EXPECT_EQ( raw[ offset + EventHeaderBytes + 4 ], i );
+
+		end	   = offset + EventHeaderBytes + sizeof( layout_event_t );
+		offset = payloadOffset + eventAlignUp( end - payloadOffset );
+	}
+
+	// Content ends with the last event, not with its padding.
+	EXPECT_EQ( buf->content_size, end * 8 );
+	collector.sendPacketCompleted();
+}
+
+TEST( EventLayoutTest, PaddingIsZero ) {
+	layoutCollector collector;
+	Event<layout_event_t> evt;
+
+	evt.getParam()->value = 0xFFFFFFFF;
+	evt.getParam()->tag	  = 0xFF;
+	for ( uint32_t i = 0; i < layoutConfig::eventMaxPerPacket; i++ ) {
+		collector.pushEvent( &evt );
+	}
+
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	const auto *raw = reinterpret_cast<const uint8_t *>( pkt.value().data() );
+
+	// Between two events and inside the header, nothing but zeros.
+	size_t stride = eventAlignUp( EventHeaderBytes + sizeof( layout_event_t ) );
+	for ( size_t pad = EventHeaderBytes + sizeof( layout_event_t ); pad < stride; pad++ ) {
+		EXPECT_EQ( raw[ payloadOffset + pad ], 0 );
+	}
+	for ( size_t pad = sizeof( uint32_t ); pad < EventHeaderBytes - sizeof( uint64_t ); pad++ ) {
+		EXPECT_EQ( raw[ payloadOffset + pad ], 0 );
+	}
+	collector.sendPacketCompleted();
+}
+
+TEST( EventLayoutTest, FullSizeEventsFitPacket ) {
+	layoutCollector collector;
+	Event<layout_full_t> evt;
+
+	memset( evt.getParam()->bytes, 0xA5, sizeof( layout_full_t ) );
+	for ( uint32_t i = 0; i < layoutConfig::eventMaxPerPacket; i++ ) {
+		collector.pushEvent( &evt );
+	}
+
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+	const auto *raw = reinterpret_cast<const uint8_t *>( pkt.value().data() );
+	const auto *buf = reinterpret_cast<const layoutBuffer_t *>( raw );
+
+	size_t stride = eventAlignUp( EventHeaderBytes + sizeof( layout_full_t ) );
+	size_t last	  = payloadOffset + ( layoutConfig::eventMaxPerPacket - 1 ) * stride;
+	EXPECT_LE( buf->content_size, buf->packet_size );
+	EXPECT_EQ( buf->content_size, ( last + EventHeaderBytes + sizeof( layout_full_t ) ) * 8 );
+	EXPECT_EQ( raw[ last + EventHeaderBytes + sizeof( layout_full_t ) - 1 ], 0xA5 );
+	collector.sendPacketCompleted();
+}
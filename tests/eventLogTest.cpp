@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <basicEventCollector.hpp>
+#include <eventLog.hpp>
+#include <internal/eventPacket.hpp>
+
+#include <cstring>
+
+// Arguments of a record: after fmtId and argc, on 4 bytes when aligned.
+static constexpr size_t LogArgsOffset = CONFIG_EVENT_ALIGNED ? 8 : 5;
+
+enum class logState : uint16_t { idle = 3, busy = 7 };
+
+TEST( EventLogTest, FormatIdIsFnv1a ) {
+	// Reference value of FNV-1a 32 bit for "hello".
+	EXPECT_EQ( eventLogFmtId( "hello" ), 0x4F9F2CABu );
+	EXPECT_NE( eventLogFmtId( "val %u" ), eventLogFmtId( "val %d" ) );
+}
+
+TEST( EventLogTest, FormatArgCount ) {
+	EXPECT_EQ( eventLogArgCount( "no argument" ), 0 );
+	EXPECT_EQ( eventLogArgCount( "100%% done" ), 0 );
+	EXPECT_EQ( eventLogArgCount( "a %u b %d c %x" ), 3 );
+	EXPECT_EQ( eventLogArgCount( "%08x%%%u" ), 2 );
+	EXPECT_EQ( eventLogArgCount( "%-+5.3lld %hhu %.f %zx %p" ), 5 );
+
+	// No 32-bit slot for these: rejected by EVT_LOG.
+	EXPECT_EQ( eventLogArgCount( "%*d" ), EventLogFmtInvalid );
+	EXPECT_EQ( eventLogArgCount( "%.*f" ), EventLogFmtInvalid );
+	EXPECT_EQ( eventLogArgCount( "name %s" ), EventLogFmtInvalid );
+	EXPECT_EQ( eventLogArgCount( "%n" ), EventLogFmtInvalid );
+	EXPECT_EQ( eventLogArgCount( "100%" ), EventLogFmtInvalid );
+}
+
+TEST( EventLogTest, RecordLayout ) {
+	EXPECT_EQ( sizeof( EventLogRecord<0> ), LogArgsOffset );
+	EXPECT_EQ( sizeof( EventLogRecord<2> ), LogArgsOffset + 8 );
+	EXPECT_EQ( EventId<EventLogRecord<3>>::value, EventLogId );
+}
+
+TEST( EventLogTest, RecordInPacket ) {
+	constexpr uint32_t fmtId = eventLogFmtId( "state %u val %d" );
+	eventPacket packet;
+	const packet_buffer_t *pktBuf = nullptr;
+	uint32_t word				  = 0;
+
+	auto evt = eventLogMake<fmtId>( logState::busy, int8_t( -2 ) );
+
+	packet.init( 1, 0, 0ULL );
+	packet.addEvent( &evt );
+	packet.buildPacket( 0ULL );
+
+	auto raw = packet.getPacketInRaw();
+	pktBuf	 = reinterpret_cast<const packet_buffer_t *>( raw.data() );
+
+	const uint8_t *payload = pktBuf->eventPayload.data();
+
+	memcpy( &word, payload, sizeof( word ) );
+	EXPECT_EQ( word, EventLogId );
+
+	payload += EventHeaderBytes;
+	memcpy( &word, payload, sizeof( word ) );
+	EXPECT_EQ( word, fmtId );
+	EXPECT_EQ( payload[ 4 ], 2 );
+
+	memcpy( &word, payload + LogArgsOffset, sizeof( word ) );
+	EXPECT_EQ( word, 7u );
+	memcpy( &word, payload + LogArgsOffset + 4, sizeof( word ) );
+	EXPECT_EQ( word, 0xFFFFFFFEu );
+}
+
+// Clock and locks of a collector instance used by EVT_LOG_TO.
+struct LogTestPlatform {
+	uint64_t getTimestamp() { return 1; }
+	bool eventTryLock() { return true; }
+	void eventUnlock() {}
+	void packetLock() {}
+	void packetUnlock() {}
+};
+
+TEST( EventLogTest, LogToCollectorInstance ) {
+	typedef basicEventCollector<LogTestPlatform, eventConfig<32, 1, 1>> logCollector;
+
+	logCollector collector;
+	uint32_t word = 0;
+
+	EVT_LOG_TO( &collector, "instance %u", 42u );
+
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+
+	// Skip packet header and event header.
+	const std::byte *payload =
+		pkt.value().data() + offsetof( logCollector::packet_t::buffer_t, eventPayload ) + EventHeaderBytes;
+	memcpy( &word, payload, sizeof( word ) );
+	EXPECT_EQ( word, eventLogFmtId( "instance %u" ) );
+	memcpy( &word, payload + LogArgsOffset, sizeof( word ) );
+	EXPECT_EQ( word, 42u );
+}
@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+
+#include <basicEventCollector.hpp>
+#include <event.hpp>
+
+#include <array>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+
+#include <sys/time.h>
+
+using namespace std;
+
+// Mock event pushed from both levels.
+typedef struct {
+	uint32_t value;
+} __attribute__( ( packed ) ) nest_event_t;
+
+template <> struct EventId<nest_event_t> {
+	static constexpr uint32_t value = 9;
+};
+
+// Execution level of the running code: 1 inside the signal handler ("IRQ").
+static volatile sig_atomic_t g_level = 0;
+
+// Raise the "interrupt" from inside the next thread level push.
+static volatile sig_atomic_t g_preemptNext = 0;
+
+/* --------------------------------------------------------------------
+ *  Two nesting levels: the thread and a signal handler standing in for
+ *  an interrupt.  packetLock masks the signals like an interrupt mask.
+ * -------------------------------------------------------------------- */
+struct NestPlatform {
+	static constexpr std::size_t execLevelCount = 2;
+
+	bool locked = false;
+	sigset_t saved;
+
+	std::size_t getExecLevel() { return static_cast<std::size_t>( g_level ); }
+
+	uint64_t getTimestamp() {
+		struct timespec ts;
+
+		if ( g_level == 0 && g_preemptNext ) {
+			g_preemptNext = 0;
+			raise( SIGUSR1 );
+		}
+
+		clock_gettime( CLOCK_MONOTONIC, &ts );
+		return static_cast<uint64_t>( ts.tv_sec ) * 1000000000ULL + static_cast<uint64_t>( ts.tv_nsec );
+	}
+
+	bool eventTryLock() {
+		if ( locked ) {
+			return false;
+		}
+		locked = true;
+		return true;
+	}
+	void eventUnlock() { locked = false; }
+
+	void packetLock() {
+		sigset_t all;
+
+		sigfillset( &all );
+		pthread_sigmask( SIG_BLOCK, &all, &saved );
+	}
+	void packetUnlock() { pthread_sigmask( SIG_SETMASK, &saved, nullptr ); }
+};
+
+static_assert( eventPlatformExecLevels<NestPlatform> == 2 );
+
+// Eight events per packet, sixteen packets.
+typedef eventConfig<32, 8, 16> nestConfig;
+typedef basicEventCollector<NestPlatform, nestConfig> nestCollector;
+typedef nestCollector::packet_t::buffer_t nestBuffer_t;
+
+static nestCollector *g_collector = nullptr;
+static volatile sig_atomic_t g_isrPushed = 0;
+static volatile sig_atomic_t g_isrFlush	 = 0;
+
+static void irqHandler( int ) {
+	Event<nest_event_t> evt;
+
+	g_level				  = 1;
+	evt.getParam()->value = 1;
+	g_collector->pushEvent( &evt );
+	if ( g_isrFlush ) {
+		g_collector->forceSync();
+	}
+	g_isrPushed = g_isrPushed + 1;
+	g_level		= 0;
+}
+
+/* --------------------------------------------------------------------
+ *  Per level tally of the drained packets.
+ * -------------------------------------------------------------------- */
+struct LevelTally {
+	uint32_t events		= 0;
+	uint32_t discarded	= 0;
+	uint32_t packets	= 0;
+	uint64_t lastEnd	= 0;
+	bool ordered		= true;
+	bool wrongLevel		= false;
+};
+
+// Stride of an event in the payload; the last one has no padding after it.
+static constexpr size_t NestEventBytes = eventAlignUp( EventHeaderBytes + sizeof( nest_event_t ) );
+
+static void drain( nestCollector &collector, array<LevelTally, 2> &tally ) {
+	while ( true ) {
+		auto pkt = collector.getSendPacket();
+		if ( !pkt.has_value() ) {
+			break;
+		}
+
+		const nestBuffer_t *buf = reinterpret_cast<const nestBuffer_t *>( pkt.value().data() );
+		std::size_t level		= collector.getSendPacketLevel();
+		LevelTally &t			= tally[ level ];
+		uint32_t events =
+			( buf->content_size / 8 - offsetof( nestBuffer_t, eventPayload ) + NestEventBytes - 1 ) / NestEventBytes;
+
+		// Each level is its own sequence and time range.
+		t.ordered	 = t.ordered && buf->packet_seq_count == t.packets && buf->timestamp_begin >= t.lastEnd;
+		t.events	+= events;
+		t.discarded += buf->events_discarded;
+		t.lastEnd	 = buf->timestamp_end;
+		t.packets++;
+
+		// Events of the level carry its marker value.
+		for ( uint32_t i = 0; i < events; i++ ) {
+			uint32_t value = 0;
+
+			memcpy( &value, &buf->eventPayload[ i * NestEventBytes + EventHeaderBytes ], sizeof( value ) );
+			t.wrongLevel = t.wrongLevel || value != level;
+		}
+
+		collector.sendPacketCompleted();
+	}
+}
+
+class EventNestingTest : public ::testing::Test {
+protected:
+	nestCollector collector;
+	struct sigaction prevUsr1;
+	struct sigaction prevAlrm;
+
+	void SetUp() override {
+		struct sigaction sa = {};
+
+		sa.sa_handler = irqHandler;
+		sigemptyset( &sa.sa_mask );
+		sigaction( SIGUSR1, &sa, &prevUsr1 );
+		sigaction( SIGALRM, &sa, &prevAlrm );
+
+		g_collector	  = &collector;
+		g_isrPushed	  = 0;
+		g_isrFlush	  = 0;
+		g_preemptNext = 0;
+	}
+
+	void TearDown() override {
+		struct itimerval off = {};
+
+		setitimer( ITIMER_REAL, &off, nullptr );
+		sigaction( SIGUSR1, &prevUsr1, nullptr );
+		sigaction( SIGALRM, &prevAlrm, nullptr );
+		g_collector = nullptr;
+	}
+};
+
+TEST_F( EventNestingTest, InterruptInsidePushNotDropped ) {
+	Event<nest_event_t> evt;
+	array<LevelTally, 2> tally = {};
+
+	evt.getParam()->value = 0;
+	for ( int i = 0; i < 3; i++ ) {
+		// The handler runs while the thread level holds the event lock.
+		g_preemptNext = 1;
+		collector.pushEvent( &evt );
+	}
+	EXPECT_EQ( g_isrPushed, 3 );
+
+	collector.forceSync();
+	drain( collector, tally );
+
+	EXPECT_EQ( tally[ 0 ].events, 3 );
+	EXPECT_EQ( tally[ 1 ].events, 3 );
+	EXPECT_EQ( tally[ 0 ].discarded + tally[ 1 ].discarded, 0 );
+	EXPECT_FALSE( tally[ 0 ].wrongLevel || tally[ 1 ].wrongLevel );
+}
+
+TEST_F( EventNestingTest, FlushSkipsInterruptedLevel ) {
+	Event<nest_event_t> evt;
+	array<LevelTally, 2> tally = {};
+
+	// Interrupt level packet with one event, closed from the thread level.
+	raise( SIGUSR1 );
+	collector.forceSync();
+	drain( collector, tally );
+
+	EXPECT_EQ( tally[ 1 ].packets, 1 );
+	EXPECT_EQ( tally[ 1 ].events, 1 );
+	EXPECT_EQ( tally[ 0 ].packets, 0 );
+
+	// Interrupt level flushing: the thread level packet is mid push, kept.
+	evt.getParam()->value = 0;
+	collector.pushEvent( &evt );
+	g_isrFlush	  = 1;
+	g_preemptNext = 1;
+	collector.pushEvent( &evt );
+	drain( collector, tally );
+
+	EXPECT_EQ( tally[ 1 ].packets, 2 );
+	EXPECT_EQ( tally[ 0 ].packets, 0 );
+
+	collector.forceSync();
+	drain( collector, tally );
+
+	EXPECT_EQ( tally[ 0 ].packets, 1 );
+	EXPECT_EQ( tally[ 0 ].events, 2 );
+	EXPECT_TRUE( tally[ 0 ].ordered && tally[ 1 ].ordered );
+}
+
+TEST_F( EventNestingTest, RandomPreemptionSoak ) {
+	Event<nest_event_t> evt;
+	array<LevelTally, 2> tally = {};
+	struct itimerval tick	   = {};
+	uint32_t pushed			   = 0;
+	time_t deadline			   = time( nullptr ) + 5;
+
+	// Timer signal lands anywhere in the push or the drain.
+	tick.it_interval.tv_usec = 50;
+	tick.it_value.tv_usec	 = 50;
+	setitimer( ITIMER_REAL, &tick, nullptr );
+
+	evt.getParam()->value = 0;
+	while ( ( pushed < 100000 || g_isrPushed < 200 ) && time( nullptr ) < deadline ) {
+		collector.pushEvent( &evt );
+		pushed++;
+		drain( collector, tally );
+	}
+
+	tick = {};
+	setitimer( ITIMER_REAL, &tick, nullptr );
+
+	collector.forceSync();
+	drain( collector, tally );
+
+	EXPECT_GT( g_isrPushed, 0 );
+	EXPECT_EQ( tally[ 0 ].events, pushed );
+	EXPECT_EQ( tally[ 1 ].events, static_cast<uint32_t>( g_isrPushed ) );
+	EXPECT_EQ( tally[ 0 ].discarded + tally[ 1 ].discarded, 0 );
+	EXPECT_TRUE( tally[ 0 ].ordered && tally[ 1 ].ordered );
+	EXPECT_FALSE( tally[ 0 ].wrongLevel || tally[ 1 ].wrongLevel );
+}
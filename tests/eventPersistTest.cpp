@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+
+#include <basicEventCollector.hpp>
+#include <event.hpp>
+#include <eventPersist.hpp>
+
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "counterPlatform.hpp"
+
+using namespace std;
+
+// Mock event for the persistent store.
+typedef struct {
+	uint32_t value;
+} __attribute__( ( packed ) ) persist_event_t;
+
+template <> struct EventId<persist_event_t> {
+	static constexpr uint32_t value = 7;
+};
+
+// Two events per packet, four packets.
+typedef eventConfig<32, 2, 4> persistConfig;
+typedef basicEventCollector<CounterPlatform, persistConfig, eventPersistStore<persistConfig>>
+	persistCollector;
+typedef persistCollector::packet_t::buffer_t persistBuffer_t;
+
+/* --------------------------------------------------------------------
+ *  File backed stand-in for the `.noinit` RAM: a mapping of the same
+ *  file after "reset" sees what the previous run left.
+ * -------------------------------------------------------------------- */
+template <EventCollectorConfig Config = persistConfig> class PersistMemory {
+	int fd	  = -1;
+	void *mem = MAP_FAILED;
+
+public:
+	PersistMemory() {
+		char path[] = "/tmp/evt_persist_XXXXXX";
+
+		fd = mkstemp( path );
+		unlink( path );
+		EXPECT_EQ( ftruncate( fd, sizeof( eventPersistStorage<Config> ) ), 0 );
+	}
+
+	~PersistMemory() {
+		reset();
+		close( fd );
+	}
+
+	eventPersistStorage<Config> *map() {
+		mem = mmap( nullptr, sizeof( eventPersistStorage<Config> ), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+		EXPECT_NE( mem, MAP_FAILED );
+		return static_cast<eventPersistStorage<Config> *>( mem );
+	}
+
+	void reset() {
+		if ( mem != MAP_FAILED ) {
+			munmap( mem, sizeof( eventPersistStorage<Config> ) );
+			mem = MAP_FAILED;
+		}
+	}
+};
+
+TEST( EventPersistTest, PacketsOfPreviousRunRecovered ) {
+	PersistMemory ram;
+	Event<persist_event_t> evt;
+
+	{
+		eventPersistRegion<persistConfig> region;
+
+		// Power on: nothing to recover.
+		EXPECT_EQ( region.attach( ram.map() ), 0 );
+
+		persistCollector collector( CounterPlatform(), region.packetStore() );
+		collector.setStreamId( 2 );
+
+		// Three packets closed, the fourth holds one event.
+		for ( uint32_t i = 0; i < 7; i++ ) {
+			evt.getParam()->value = i;
+			collector.pushEvent( &evt );
+		}
+
+		// Reset while the first packet is being sent.
+		EXPECT_TRUE( collector.getSendPacket().has_value() );
+		ram.reset();
+	}
+
+	eventPersistRegion<persistConfig> region;
+	ASSERT_EQ( region.attach( ram.map() ), 4 );
+
+	persistCollector collector( CounterPlatform(), region.packetStore() );
+
+	for ( uint32_t seq = 0; seq < 4; seq++ ) {
+		auto pkt = collector.getSendPacket();
+		ASSERT_TRUE( pkt.has_value() );
+
+		const auto *buf = reinterpret_cast<const persistBuffer_t *>( pkt.value().data() );
+		EXPECT_EQ( buf->stream_id, 2 );
+		EXPECT_EQ( buf->packet_seq_count, seq );
+		EXPECT_GE( buf->timestamp_end, buf->timestamp_begin );
+
+		collector.sendPacketCompleted();
+	}
+
+	// Nothing else left from the previous run.
+	EXPECT_FALSE( collector.getSendPacket().has_value() );
+
+	// The new run has the whole pool.
+	for ( size_t i = 0; i < persistConfig::eventMaxPerPacket * persistConfig::packetCountMax; i++ ) {
+		collector.pushEvent( &evt );
+	}
+	for ( size_t i = 0; i < persistConfig::packetCountMax; i++ ) {
+		EXPECT_TRUE( collector.getSendPacket().has_value() );
+		collector.sendPacketCompleted();
+	}
+}
+
+TEST( EventPersistTest, PartialPacketClosedAtLastEvent ) {
+	PersistMemory ram;
+	Event<persist_event_t> evt;
+	uint64_t lastTs = 0;
+
+	{
+		eventPersistRegion<persistConfig> region;
+		region.attach( ram.map() );
+
+		persistCollector collector( CounterPlatform(), region.packetStore() );
+		collector.pushEvent( &evt );
+		lastTs = evt.getTimestamp();
+		ram.reset();
+	}
+
+	eventPersistRegion<persistConfig> region;
+	ASSERT_EQ( region.attach( ram.map() ), 1 );
+
+	persistCollector collector( CounterPlatform(), region.packetStore() );
+	auto pkt = collector.getSendPacket();
+	ASSERT_TRUE( pkt.has_value() );
+
+	const auto *buf = reinterpret_cast<const persistBuffer_t *>( pkt.value().data() );
+	EXPECT_EQ( buf->timestamp_end, lastTs );
+	EXPECT_EQ( buf->content_size,
+			   ( offsetof( persistBuffer_t, eventPayload ) + EventHeaderBytes + sizeof( persist_event_t ) ) * 8 );
+}
+
+TEST( EventPersistTest, DamagedMemoryStartsEmpty ) {
+	PersistMemory ram;
+	Event<persist_event_t> evt;
+
+	{
+		eventPersistRegion<persistConfig> region;
+		region.attach( ram.map() );
+
+		persistCollector collector( CounterPlatform(), region.packetStore() );
+		for ( size_t i = 0; i < persistConfig::eventMaxPerPacket; i++ ) {
+			collector.pushEvent( &evt );
+		}
+		ram.reset();
+	}
+
+	// Flip the integrity marker.
+	auto *mem = ram.map();
+	mem->raw[ 0 ] ^= std::byte{ 0xFF };
+	ram.reset();
+
+	eventPersistRegion<persistConfig> region;
+	EXPECT_EQ( region.attach( ram.map() ), 0 );
+
+	persistCollector collector( CounterPlatform(), region.packetStore() );
+	EXPECT_FALSE( collector.getSendPacket().has_value() );
+}
+
+// Two packets in flight on the transport.
+typedef eventConfig<32, 2, 4, 2> flightConfig;
+typedef basicEventCollector<CounterPlatform, flightConfig, eventPersistStore<flightConfig>> flightCollector;
+
+// Transport that never completes.
+class StalledTransport : public eventTransport {
+public:
+	size_t submitted = 0;
+
+	bool submit( std::span<const std::byte> pkt, uint32_t token ) override {
+		( void ) pkt;
+		( void ) token;
+		submitted++;
+		return true;
+	}
+};
+
+TEST( EventPersistTest, EveryPacketInFlightRecovered ) {
+	PersistMemory<flightConfig> ram;
+	Event<persist_event_t> evt;
+
+	{
+		eventPersistRegion<flightConfig> region;
+		StalledTransport transport;
+
+		region.attach( ram.map() );
+		flightCollector collector( CounterPlatform(), region.packetStore() );
+		collector.setTransport( &transport );
+
+		// Three packets closed, reset while the first two are being sent.
+		for ( size_t i = 0; i < 3 * flightConfig::eventMaxPerPacket; i++ ) {
+			collector.pushEvent( &evt );
+		}
+		collector.transportPoll();
+		EXPECT_EQ( transport.submitted, 2 );
+		ram.reset();
+	}
+
+	eventPersistRegion<flightConfig> region;
+	ASSERT_EQ( region.attach( ram.map() ), 3 );
+
+	flightCollector collector( CounterPlatform(), region.packetStore() );
+	for ( uint32_t seq = 0; seq < 3; seq++ ) {
+		auto pkt = collector.getSendPacket();
+		ASSERT_TRUE( pkt.has_value() );
+		EXPECT_EQ( reinterpret_cast<const typename flightCollector::packet_t::buffer_t *>( pkt.value().data() )
+					   ->packet_seq_count,
+				   seq );
+		collector.sendPacketCompleted();
+	}
+	EXPECT_FALSE( collector.getSendPacket().has_value() );
+}
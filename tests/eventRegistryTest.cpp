@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <eventRegistry.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+using namespace std;
+
+// Payloads described by the registry below.
+typedef struct {
+	uint8_t count;
+} __attribute__( ( packed ) ) reg_count_t;
+
+typedef struct {
+	uint16_t line;
+	uint8_t nums[ 3 ];
+	int32_t status;
+} __attribute__( ( packed ) ) reg_irq_t;
+
+// Same shape as the generated event_registry.hpp: stream 0 with ids 1 and
+// 4, stream 2 with id 0.
+struct testRegistry {
+	static constexpr std::size_t count = 3;
+
+	static constexpr std::array<eventFieldInfo, 4> fields = { {
+		{ "count", eventFieldType::u8, 0, 1, eventFieldEncoding::delta },
+		{ "line", eventFieldType::u16, 0, 1, eventFieldEncoding::none },
+		{ "nums", eventFieldType::u8, 2, 3, eventFieldEncoding::none },
+		{ "status", eventFieldType::i32, 5, 1, eventFieldEncoding::none },
+	} };
+
+	static constexpr std::array<eventInfo, 3> events = { {
+		{ 0, 1, "count", 1, 0, 1, false },
+		{ 0, 4, "irq", 9, 1, 3, false },
+		{ 2, 0, "count2", 1, 0, 1, false },
+	} };
+
+	static constexpr std::array<eventRegistryStream, 2> streams = { {
+		{ 0, 0, 5 },
+		{ 2, 5, 1 },
+	} };
+
+	static constexpr std::array<uint16_t, 6> slots = { {
+		eventRegistryNoSlot,
+		0,
+		eventRegistryNoSlot,
+		eventRegistryNoSlot,
+		1,
+		2,
+	} };
+
+	static constexpr std::size_t indexOf( uint32_t streamId, uint32_t id ) {
+		return eventRegistryLookup<testRegistry>( streamId, id );
+	}
+};
+
+static_assert( EventRegistry<testRegistry> );
+
+// Usable at compile time, e.g. to size or index a filter table.
+static_assert( testRegistry::indexOf( 0, 4 ) == 1 );
+static_assert( testRegistry::events[ testRegistry::indexOf( 0, 4 ) ].size == sizeof( reg_irq_t ) );
+
+TEST( EventRegistryTest, DenseIndex ) {
+	EXPECT_EQ( testRegistry::indexOf( 0, 1 ), 0 );
+	EXPECT_EQ( testRegistry::indexOf( 0, 4 ), 1 );
+	EXPECT_EQ( testRegistry::indexOf( 2, 0 ), 2 );
+
+	// Ids of another stream share numbers but not indexes.
+	EXPECT_STREQ( testRegistry::events[ testRegistry::indexOf( 2, 0 ) ].name, "count2" );
+}
+
+TEST( EventRegistryTest, UnknownEvent ) {
+	EXPECT_EQ( testRegistry::indexOf( 0, 0 ), testRegistry::count );	 // hole
+	EXPECT_EQ( testRegistry::indexOf( 0, 5 ), testRegistry::count );	 // past the table
+	EXPECT_EQ( testRegistry::indexOf( 1, 1 ), testRegistry::count );	 // no such stream
+	EXPECT_EQ( testRegistry::indexOf( 0, 0xFFFF ), testRegistry::count ); // EVT_LOG
+}
+
+TEST( EventRegistryTest, FieldLayoutMatchesPackedStruct ) {
+	const eventInfo &info = testRegistry::events[ testRegistry::indexOf( 0, 4 ) ];
+	reg_irq_t irq		  = { 0x1234, { 1, 2, 3 }, -5 };
+	int32_t status		  = 0;
+
+	ASSERT_EQ( info.fieldCount, 3 );
+	EXPECT_EQ( testRegistry::fields[ info.firstField + 0 ].offset, offsetof( reg_irq_t, line ) );
+	EXPECT_EQ( testRegistry::fields[ info.firstField + 1 ].offset, offsetof( reg_irq_t, nums ) );
+	EXPECT_EQ( testRegistry::fields[ info.firstField + 2 ].offset, offsetof( reg_irq_t, status ) );
+
+	// A decoder reading the raw payload through the table.
+	const eventFieldInfo &field = testRegistry::fields[ info.firstField + 2 ];
+	memcpy( &status, reinterpret_cast<const uint8_t *>( &irq ) + field.offset, sizeof( status ) );
+	EXPECT_EQ( status, -5 );
+}
+
+TEST( EventRegistryTest, PerEventCounters ) {
+	array<uint32_t, testRegistry::count> hits = {};
+	const uint32_t trace[][ 2 ]				  = { { 0, 1 }, { 0, 4 }, { 0, 4 }, { 2, 0 } };
+
+	for ( const auto &evt : trace ) {
+		hits[ testRegistry::indexOf( evt[ 0 ], evt[ 1 ] ) ]++;
+	}
+
+	EXPECT_EQ( hits[ 0 ], 1 );
+	EXPECT_EQ( hits[ 1 ], 2 );
+	EXPECT_EQ( hits[ 2 ], 1 );
+}
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <basicEventCollector.hpp>
+#include <event.hpp>
+#include <eventShed.hpp>
+
+#include <cstring>
+#include <vector>
+
+#include "counterPlatform.hpp"
+
+using namespace std;
+
+// Mock events of verbosity 0 (essential), 2 and 3, same shape as the
+// generated ones for `verbosity: N`.
+typedef struct {
+	uint32_t value;
+} __attribute__( ( packed ) ) shed_essential_t;
+
+typedef struct {
+	uint32_t value;
+} __attribute__( ( packed ) ) shed_normal_t;
+
+typedef struct {
+	uint32_t value;
+} __attribute__( ( packed ) ) shed_detail_t;
+
+template <> struct EventId<shed_essential_t> {
+	static constexpr uint32_t value = 20;
+};
+
+template <> struct EventId<shed_normal_t> {
+	static constexpr uint32_t value = 21;
+};
+
+template <> struct EventId<shed_detail_t> {
+	static constexpr uint32_t value = 22;
+};
+
+template <> struct EventVerbosity<shed_normal_t> {
+	static constexpr uint8_t value = 2;
+};
+
+template <> struct EventVerbosity<shed_detail_t> {
+	static constexpr uint8_t value = 3;
+};
+
+typedef eventConfig<32, 2, 6> shedConfig;
+typedef basicEventCollector<CounterPlatform, shedConfig> shedCollector;
+typedef shedCollector::packet_t::buffer_t shedBuffer_t;
+
+static_assert( EventPacketStoreOccupancy<eventPacketStore<shedConfig>> );
+
+// One captured event: id and first payload word (marker: its level).
+typedef struct {
+	uint32_t id;
+	uint32_t value;
+} captured_t;
+
+// Drains one ready packet, appending its events.  False when none is ready.
+static bool drainOne( shedCollector &collector, vector<captured_t> &out ) {
+	auto pkt = collector.getSendPacket();
+	if ( !pkt.has_value() ) {
+		return false;
+	}
+
+	const auto *raw		   = reinterpret_cast<const uint8_t *>( pkt.value().data() );
+	const auto *buf		   = reinterpret_cast<const shedBuffer_t *>( raw );
+	const uint8_t *payload = raw + offsetof( shedBuffer_t, eventPayload );
+	size_t size			   = buf->content_size / 8 - offsetof( shedBuffer_t, eventPayload );
+	size_t pos			   = 0;
+
+	while ( pos < size ) {
+		captured_t evt = {};
+
+		pos = eventAlignUp( pos );
+		memcpy( &evt.id, payload + pos, sizeof( evt.id ) );
+		memcpy( &evt.value, payload + pos + EventHeaderBytes, sizeof( evt.value ) );
+		out.push_back( evt );
+		pos += EventHeaderBytes + ( evt.id == EventId<eventShedMarker>::value ? sizeof( eventShedMarker ) : 4 );
+	}
+
+	collector.sendPacketCompleted();
+	return true;
+}
+
+template <typename T> static void push( shedCollector &collector, uint32_t value ) {
+	Event<T> evt;
+
+	evt.getParam()->value = value;
+	collector.pushEvent( &evt );
+}
+
+static size_t countId( const vector<captured_t> &events, uint32_t id ) {
+	size_t n = 0;
+
+	for ( const captured_t &evt : events ) {
+		n += ( evt.id == id );
+	}
+	return n;
+}
+
+static constexpr eventShedConfig watermarks = {
+	.levelMax = 3, .readyHigh = 2, .readyLow = 0, .usedHigh = 6, .usedLow = 2 };
+
+TEST( EventShedTest, OffByDefault ) {
+	shedCollector collector;
+	vector<captured_t> events;
+
+	// Pool full of ready packets: nothing shed, the rest is discarded.
+	for ( uint32_t i = 0; i < 12; i++ ) {
+		push<shed_detail_t>( collector, i );
+	}
+	EXPECT_EQ( collector.getShedLevel(), 0 );
+
+	while ( drainOne( collector, events ) ) {
+	}
+	EXPECT_EQ( countId( events, 22 ), 12 );
+	EXPECT_EQ( countId( events, EventId<eventShedMarker>::value ), 0 );
+}
+
+TEST( EventShedTest, RaisesOnBacklog ) {
+	shedCollector collector;
+	vector<captured_t> events;
+
+	collector.setLoadShedding( watermarks );
+
+	// Two packets waiting for the drain: level 1, detail is shed.
+	for ( uint32_t i = 0; i < 4; i++ ) {
+		push<shed_essential_t>( collector, i );
+	}
+	EXPECT_EQ( collector.getShedLevel(), 1 );
+	push<shed_detail_t>( collector, 100 );
+	push<shed_normal_t>( collector, 101 );
+
+	// Third packet queued: level 2, normal is shed too.
+	EXPECT_EQ( collector.getShedLevel(), 2 );
+	push<shed_normal_t>( collector, 102 );
+	push<shed_essential_t>( collector, 103 );
+
+	collector.forceSync();
+	while ( drainOne( collector, events ) ) {
+	}
+
+	// The marker of each change goes ahead of the next captured event.
+	ASSERT_GE( events.size(), 6 );
+	EXPECT_EQ( events[ 4 ].id, EventId<eventShedMarker>::value );
+	EXPECT_EQ( events[ 4 ].value, 1 );
+	EXPECT_EQ( events[ 5 ].id, 21 );
+	EXPECT_EQ( events[ 5 ].value, 101 );
+	EXPECT_EQ( events[ 6 ].id, EventId<eventShedMarker>::value );
+	EXPECT_EQ( events[ 6 ].value, 2 );
+	EXPECT_EQ( events[ 7 ].id, 20 );
+	EXPECT_EQ( events[ 7 ].value, 103 );
+	EXPECT_EQ( countId( events, 22 ), 0 );
+	EXPECT_EQ( countId( events, 21 ), 1 );
+}
+
+TEST( EventShedTest, LowersWhenDrained ) {
+	shedCollector collector;
+	vector<captured_t> events;
+
+	collector.setLoadShedding( watermarks );
+	for ( uint32_t i = 0; i < 8; i++ ) {
+		push<shed_essential_t>( collector, i );
+	}
+	EXPECT_EQ( collector.getShedLevel(), 3 );
+
+	// One step down per release with the queue drained and the pool
+	// below its low mark.
+	while ( drainOne( collector, events ) ) {
+	}
+	EXPECT_EQ( collector.getShedLevel(), 2 );
+	for ( int round = 0; round < 8 && collector.getShedLevel() > 0; round++ ) {
+		push<shed_essential_t>( collector, 0 );
+		collector.forceSync();
+		while ( drainOne( collector, events ) ) {
+		}
+	}
+	ASSERT_EQ( collector.getShedLevel(), 0 );
+
+	// Back to full capture: detail events are in the trace again.
+	push<shed_detail_t>( collector, 7 );
+	collector.forceSync();
+	while ( drainOne( collector, events ) ) {
+	}
+	EXPECT_EQ( events.back().id, 22 );
+	EXPECT_EQ( events[ events.size() - 2 ].id, EventId<eventShedMarker>::value );
+	EXPECT_EQ( events[ events.size() - 2 ].value, 0 );
+}
+
+TEST( EventShedTest, DisableRestoresCapture ) {
+	shedCollector collector;
+	vector<captured_t> events;
+
+	collector.setLoadShedding( watermarks );
+	for ( uint32_t i = 0; i < 6; i++ ) {
+		push<shed_essential_t>( collector, i );
+	}
+	EXPECT_GT( collector.getShedLevel(), 0 );
+
+	collector.setLoadShedding( {} );
+	EXPECT_EQ( collector.getShedLevel(), 0 );
+	push<shed_detail_t>( collector, 1 );
+
+	collector.forceSync();
+	while ( drainOne( collector, events ) ) {
+	}
+	EXPECT_EQ( events.back().id, 22 );
+}
+
+TEST( EventShedTest, EssentialNeverShed ) {
+	std::atomic<uint8_t> level = eventShedLevelMax;
+
+	EXPECT_TRUE( eventShedAccepts<Event<shed_essential_t>>( level ) );
+	EXPECT_FALSE( eventShedAccepts<Event<shed_normal_t>>( level ) );
+	level = 1;
+	EXPECT_TRUE( eventShedAccepts<Event<shed_normal_t>>( level ) );
+	EXPECT_FALSE( eventShedAccepts<Event<shed_detail_t>>( level ) );
+}
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <event.hpp>
+#include <posix/eventShm.hpp>
+
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Mock event for the shared memory collector.
+typedef struct {
+	uint32_t value;
+} __attribute__( ( packed ) ) shm_event_t;
+
+template <> struct EventId<shm_event_t> {
+	static constexpr uint32_t value = 6;
+};
+
+// Two events per packet, three packets.
+typedef eventConfig<32, 2, 3> shmConfig;
+typedef eventShmCollector<shmConfig>::packet_t::buffer_t shmBuffer_t;
+
+static string shmName( const char *tag ) { return "/evt_test_" + to_string( getpid() ) + tag; }
+
+TEST( EventShmTest, ReadyPacketsSurviveProducerCrash ) {
+	string name = shmName( "_crash" );
+	pid_t pid	= fork();
+
+	ASSERT_GE( pid, 0 );
+	if ( pid == 0 ) {
+		eventShmRegion<shmConfig> region;
+		Event<shm_event_t> evt;
+
+		if ( !region.create( name.c_str() ) ) {
+			_exit( 1 );
+		}
+
+		eventShmCollector<shmConfig> collector( region.platform(), region.packetStore() );
+		collector.setStreamId( 3 );
+
+		// Two full packets reach the ready queue, the fifth event is lost.
+		for ( uint32_t i = 0; i < 5; i++ ) {
+			evt.getParam()->value = i;
+			collector.pushEvent( &evt );
+		}
+
+		// Crash: no cleanup, no flush.
+		_exit( 0 );
+	}
+
+	int status = 0;
+	ASSERT_EQ( waitpid( pid, &status, 0 ), pid );
+	ASSERT_TRUE( WIFEXITED( status ) );
+	ASSERT_EQ( WEXITSTATUS( status ), 0 );
+
+	eventShmReader<shmConfig> reader;
+	ASSERT_TRUE( reader.open( name.c_str() ) );
+	eventShmMapping::unlink( name.c_str() );
+
+	EXPECT_EQ( reader.readyCount(), 2 );
+
+	for ( uint32_t seq = 0; seq < 2; seq++ ) {
+		auto pkt = reader.getSendPacket();
+		ASSERT_TRUE( pkt.has_value() );
+		ASSERT_EQ( pkt.value().size(), sizeof( shmBuffer_t ) );
+
+		const auto *buf = reinterpret_cast<const shmBuffer_t *>( pkt.value().data() );
+		EXPECT_EQ( buf->stream_id, 3 );
+		EXPECT_EQ( buf->packet_seq_count, seq );
+		// header + two events, the second on the event boundary, in bits.
+		EXPECT_EQ( buf->content_size, ( offsetof( shmBuffer_t, eventPayload ) +
+										eventAlignUp( EventHeaderBytes + sizeof( shm_event_t ) ) + EventHeaderBytes +
+										sizeof( shm_event_t ) ) *
+										  8 );
+
+		reader.sendPacketCompleted();
+	}
+
+	EXPECT_FALSE( reader.getSendPacket().has_value() );
+}
+
+TEST( EventShmTest, LockOfDeadOwnerRecovered ) {
+	string name = shmName( "_lock" );
+	eventShmRegion<shmConfig> region;
+
+	ASSERT_TRUE( region.create( name.c_str() ) );
+	eventShmMapping::unlink( name.c_str() );
+
+	pid_t pid = fork();
+	ASSERT_GE( pid, 0 );
+	if ( pid == 0 ) {
+		// Die while holding the packet lock.
+		region.platform().packetLock();
+		_exit( 0 );
+	}
+
+	int status = 0;
+	ASSERT_EQ( waitpid( pid, &status, 0 ), pid );
+
+	eventShmPlatform pltf = region.platform();
+	pltf.packetLock();
+	pltf.packetUnlock();
+	EXPECT_TRUE( pltf.eventTryLock() );
+	pltf.eventUnlock();
+}
+
+TEST( EventShmTest, OpenRejectsOtherConfig ) {
+	string name = shmName( "_cfg" );
+	eventShmRegion<shmConfig> region;
+	eventShmReader<eventConfig<32, 2, 4>> reader;
+
+	ASSERT_TRUE( region.create( name.c_str() ) );
+	EXPECT_FALSE( reader.open( name.c_str() ) );
+	eventShmMapping::unlink( name.c_str() );
+}
+
+// Bookkeeping of the ready queue, the last member of the shared store.
+struct ShmQueueView {
+	uint32_t buffer[ shmConfig::packetCountMax ];
+	size_t head;
+	size_t tail;
+	size_t count;
+};
+
+static_assert( sizeof( ShmQueueView ) == sizeof( Queue<uint32_t, shmConfig::packetCountMax> ) );
+static_assert( sizeof( eventPacketStore<shmConfig> ) ==
+			   sizeof( StaticPool<eventPacketStore<shmConfig>::packet_t, shmConfig::packetCountMax> ) +
+				   sizeof( ShmQueueView ) );
+
+TEST( EventShmTest, QueueRepairedAfterDeathInPushReady ) {
+	string name = shmName( "_push" );
+	eventShmRegion<shmConfig> region;
+
+	ASSERT_TRUE( region.create( name.c_str() ) );
+
+	pid_t pid = fork();
+	ASSERT_GE( pid, 0 );
+	if ( pid == 0 ) {
+		eventShmCollector<shmConfig> collector( region.platform(), region.packetStore() );
+		Event<shm_event_t> evt;
+		auto *ready = reinterpret_cast<ShmQueueView *>( reinterpret_cast<std::byte *>( region.store() + 1 ) ) - 1;
+
+		// Three full packets, the last one queued...
+		for ( uint32_t i = 0; i < 6; i++ ) {
+			collector.pushEvent( &evt );
+		}
+
+		// ...by an insert cut after the tail store: die in pushReady().
+		region.platform().packetLock();
+		ready->count--;
+		_exit( 0 );
+	}
+
+	int status = 0;
+	ASSERT_EQ( waitpid( pid, &status, 0 ), pid );
+
+	eventShmReader<shmConfig> reader;
+	ASSERT_TRUE( reader.open( name.c_str() ) );
+	eventShmMapping::unlink( name.c_str() );
+
+	for ( uint32_t seq = 0; seq < 3; seq++ ) {
+		auto pkt = reader.getSendPacket();
+		ASSERT_TRUE( pkt.has_value() );
+		EXPECT_EQ( reinterpret_cast<const shmBuffer_t *>( pkt.value().data() )->packet_seq_count, seq );
+		reader.sendPacketCompleted();
+	}
+	EXPECT_FALSE( reader.getSendPacket().has_value() );
+	EXPECT_EQ( reader.readyCount(), 0 );
+}
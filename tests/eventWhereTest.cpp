@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <basicEventCollector.hpp>
+#include <event.hpp>
+#include <eventWhere.hpp>
+
+#include <vector>
+
+using namespace std;
+
+// Mock event with a predicate, same shape as the generated one for
+//   where: status != OK && count % 4 == 0
+typedef struct {
+	uint8_t status;
+	uint32_t count;
+} __attribute__( ( packed ) ) where_event_t;
+
+// Mock event without predicate.
+typedef struct {
+	uint32_t value;
+} __attribute__( ( packed ) ) plain_event_t;
+
+template <> struct EventId<where_event_t> {
+	static constexpr uint32_t value = 14;
+};
+
+template <> struct EventId<plain_event_t> {
+	static constexpr uint32_t value = 15;
+};
+
+template <> struct EventWhere<where_event_t> : eventWhereSwitch<where_event_t> {
+	static bool test( const where_event_t &e ) { return ( e.status != ( 0 ) && e.count % 4 == 0 ); }
+};
+
+static_assert( EventHasWhere<where_event_t> );
+static_assert( !EventHasWhere<plain_event_t> );
+
+// Counter clock counting its reads, no locking.
+struct WherePlatform {
+	static inline unsigned clockRead = 0;
+	uint64_t ts						 = 0;
+
+	uint64_t getTimestamp() {
+		clockRead++;
+		return ts += 10;
+	}
+	bool eventTryLock() { return true; }
+	void eventUnlock() {}
+	void packetLock() {}
+	void packetUnlock() {}
+};
+
+typedef eventConfig<32, 16, 2> whereConfig;
+typedef basicEventCollector<WherePlatform, whereConfig> whereCollector;
+typedef whereCollector::packet_t::buffer_t whereBuffer_t;
+
+// Counts of the flushed packet: events (of 17 bytes) and events_discarded.
+static pair<size_t, uint32_t> drainCounts( whereCollector &collector ) {
+	collector.forceSync();
+	auto pkt = collector.getSendPacket();
+	if ( !pkt.has_value() ) {
+		return { 0, 0 };
+	}
+
+	// The last event has no padding up to the next event boundary.
+	const auto *buf	  = reinterpret_cast<const whereBuffer_t *>( pkt.value().data() );
+	const size_t each = eventAlignUp( EventHeaderBytes + sizeof( where_event_t ) );
+	size_t events	  = ( buf->content_size / 8 - offsetof( whereBuffer_t, eventPayload ) + each - 1 ) / each;
+	uint32_t discarded = buf->events_discarded;
+
+	collector.sendPacketCompleted();
+	return { events, discarded };
+}
+
+class EventWhereTest : public ::testing::Test {
+protected:
+	void TearDown() override { EventWhere<where_event_t>::enable( false ); }
+
+	static void push( whereCollector &collector, uint8_t status, uint32_t count ) {
+		Event<where_event_t> evt;
+
+		evt.getParam()->status = status;
+		evt.getParam()->count  = count;
+		collector.pushEvent( &evt );
+	}
+};
+
+TEST_F( EventWhereTest, DisabledCapturesEverything ) {
+	whereCollector collector;
+
+	for ( uint32_t i = 0; i < 8; i++ ) {
+		push( collector, 0, i );
+	}
+
+	EXPECT_EQ( drainCounts( collector ), ( pair<size_t, uint32_t>{ 8, 0 } ) );
+}
+
+TEST_F( EventWhereTest, EnabledCapturesMatchingOnly ) {
+	whereCollector collector;
+	unsigned clockBefore = 0;
+
+	EventWhere<where_event_t>::enable( true );
+	push( collector, 1, 0 ); // opens the packet
+
+	// status 1 and count multiple of 4: 4, 8, 12.
+	clockBefore = WherePlatform::clockRead;
+	for ( uint32_t i = 1; i < 16; i++ ) {
+		push( collector, 1, i );
+		push( collector, 0, i );
+	}
+
+	// Rejected instances read no clock and are not losses.
+	EXPECT_EQ( WherePlatform::clockRead - clockBefore, 3 );
+	EXPECT_EQ( drainCounts( collector ), ( pair<size_t, uint32_t>{ 4, 0 } ) );
+}
+
+TEST_F( EventWhereTest, SwitchedAtRuntime ) {
+	whereCollector collector;
+
+	push( collector, 0, 1 );
+	EventWhere<where_event_t>::enable( true );
+	EXPECT_TRUE( EventWhere<where_event_t>::enabled() );
+	push( collector, 0, 2 );
+	EventWhere<where_event_t>::enable( false );
+	push( collector, 0, 3 );
+
+	EXPECT_EQ( drainCounts( collector ).first, 2 );
+}
+
+TEST_F( EventWhereTest, BatchFiltered ) {
+	whereCollector collector;
+	vector<Event<where_event_t>> burst( 8 );
+
+	for ( uint32_t i = 0; i < burst.size(); i++ ) {
+		burst[ i ].getParam()->status = 2;
+		burst[ i ].getParam()->count  = i;
+	}
+
+	EventWhere<where_event_t>::enable( true );
+	collector.pushEvents( span( burst ) );
+
+	EXPECT_EQ( drainCounts( collector ), ( pair<size_t, uint32_t>{ 2, 0 } ) );
+}
+
+TEST_F( EventWhereTest, EventWithoutPredicateUnaffected ) {
+	Event<plain_event_t> evt;
+
+	EventWhere<where_event_t>::enable( true );
+	EXPECT_TRUE( eventWhereAccepts( &evt ) );
+}
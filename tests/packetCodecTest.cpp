@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <eventCollector.hpp>
+#include <internal/eventPacket.hpp>
+#include <packetCodec.hpp>
+
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+// Mock event with small, slowly changing integer fields.
+typedef struct {
+	uint16_t count;
+	uint8_t state;
+} __attribute__( ( packed ) ) codec_event_t;
+
+template <> struct EventId<codec_event_t> {
+	static constexpr uint32_t value = 3;
+};
+
+// Build a full CTF packet of the default configuration.
+static vector<byte> makePacket() {
+	eventPacket packet;
+	Event<codec_event_t> evt;
+	uint64_t ts = 0x0001020304050000ULL;
+
+	packet.init( 1, 0, ts );
+	while ( !packet.isPacketFull() ) {
+		evt.getParam()->count++;
+		evt.getParam()->state = 1;
+		evt.setTimestamp( ts += 250 );
+		packet.addEvent( &evt );
+	}
+	packet.buildPacket( ts );
+
+	auto raw = packet.getPacketInRaw();
+	return vector<byte>( raw.begin(), raw.end() );
+}
+
+TEST( PacketCodecTest, CompressedFrameRoundTrip ) {
+	static packetCompressor<sizeof( packet_buffer_t )> compressor;
+	vector<byte> pkt = makePacket();
+	vector<byte> restored( pkt.size() );
+	packet_frame_t hdr;
+
+	auto frame = compressor.encode( pkt );
+	ASSERT_GE( frame.size(), sizeof( hdr ) );
+	memcpy( &hdr, frame.data(), sizeof( hdr ) );
+
+	EXPECT_EQ( hdr.magic, PacketFrameMagic );
+	EXPECT_EQ( hdr.codec, packetCodecLz );
+	EXPECT_EQ( hdr.rawSize, pkt.size() );
+	EXPECT_EQ( hdr.bodySize, frame.size() - sizeof( hdr ) );
+	EXPECT_LT( frame.size(), pkt.size() / 2 );
+
+	size_t size = packetCodecDecompress( frame.subspan( sizeof( hdr ) ), restored );
+	EXPECT_EQ( size, pkt.size() );
+	EXPECT_EQ( restored, pkt );
+}
+
+TEST( PacketCodecTest, IncompressibleSentRaw ) {
+	static packetCompressor<64> compressor;
+	vector<byte> pkt( 64 );
+	packet_frame_t hdr;
+	uint32_t x = 0x12345678;
+
+	// xorshift noise has no 4 byte repetition.
+	for ( auto &b : pkt ) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		b = static_cast<byte>( x );
+	}
+
+	auto frame = compressor.encode( pkt );
+	memcpy( &hdr, frame.data(), sizeof( hdr ) );
+
+	EXPECT_EQ( hdr.codec, packetCodecRaw );
+	EXPECT_EQ( hdr.bodySize, pkt.size() );
+	EXPECT_EQ( memcmp( frame.data() + sizeof( hdr ), pkt.data(), pkt.size() ), 0 );
+}
+
+TEST( PacketCodecTest, CorruptedBlockRejected ) {
+	static packetCompressor<sizeof( packet_buffer_t )> compressor;
+	vector<byte> pkt = makePacket();
+	vector<byte> restored( pkt.size() );
+
+	auto frame = compressor.encode( pkt );
+	auto body  = frame.subspan( sizeof( packet_frame_t ) );
+
+	// Truncated block and too small output are both detected.
+	EXPECT_EQ( packetCodecDecompress( body.first( body.size() / 2 ), restored ), 0 );
+	EXPECT_EQ( packetCodecDecompress( body, span( restored ).first( 16 ) ), 0 );
+}
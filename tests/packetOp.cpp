@@ -5,6 +5,17 @@
 
 #define CONVERT_SIZE_IN_BITS( x ) ( ( x ) * 8 )
 
+// Packet header, then `count` raw events of `size` bytes each starting on
+// the event boundary of the layout.
+static size_t contentBytes( size_t size, size_t count ) {
+	size_t bytes = offsetof( packet_buffer_t, eventPayload );
+
+	if ( count > 0 ) {
+		bytes += eventAlignUp( size ) * ( count - 1 ) + size;
+	}
+	return bytes;
+}
+
 class MockEvent : public EventIntf {
 	std::vector<std::byte> m_data;
 
@@ -41,7 +52,7 @@ TEST_F( EventPacketTest, Initialization ) {
 	EXPECT_EQ( pktBuf->events_discarded, 0 );
 	EXPECT_EQ( pktBuf->packet_seq_count, TEST_SEQ_NO );
 
-	EXPECT_EQ( pktBuf->content_size, CONVERT_SIZE_IN_BITS( sizeof( uint32_t ) * 9 ) );
+	EXPECT_EQ( pktBuf->content_size, CONVERT_SIZE_IN_BITS( contentBytes( 0, 0 ) ) );
 	EXPECT_EQ( pktBuf->packet_size, CONVERT_SIZE_IN_BITS( sizeof( packet_buffer_t ) ) );
 }
 
@@ -66,7 +77,8 @@ TEST_F( EventPacketTest, CapacityManagement ) {
 	EXPECT_EQ( pktBuf->events_discarded, 0 );
 	EXPECT_EQ( pktBuf->packet_seq_count, TEST_SEQ_NO );
 
-	EXPECT_EQ( pktBuf->content_size, CONVERT_SIZE_IN_BITS( sizeof( packet_buffer_t ) ) );
+	EXPECT_EQ( pktBuf->content_size,
+			   CONVERT_SIZE_IN_BITS( contentBytes( TEST_EVENT_MAX_SIZE, CONFIG_EVENT_MAX_PER_PACKET ) ) );
 	EXPECT_EQ( pktBuf->packet_size, CONVERT_SIZE_IN_BITS( sizeof( packet_buffer_t ) ) );
 }
 
@@ -75,8 +87,6 @@ TEST_F( EventPacketTest, PaddingValidation ) {
 	eventPacket packet;
 	const packet_buffer_t *pktBuf = nullptr;
 	MockEvent mevt( TEST_EVENT_PADDING_SIZE_1, 0x22 );
-	const uint32_t padSize =
-		( TEST_EVENT_MAX_SIZE - TEST_EVENT_PADDING_SIZE_1 ) * CONFIG_EVENT_MAX_PER_PACKET;
 
 	packet.init( TEST_STREAM_ID, TEST_SEQ_NO, 0ULL );
 
@@ -94,7 +104,8 @@ TEST_F( EventPacketTest, PaddingValidation ) {
 	EXPECT_EQ( pktBuf->events_discarded, 0 );
 	EXPECT_EQ( pktBuf->packet_seq_count, TEST_SEQ_NO );
 
-	EXPECT_EQ( pktBuf->content_size, CONVERT_SIZE_IN_BITS( sizeof( packet_buffer_t ) - padSize ) );
+	EXPECT_EQ( pktBuf->content_size,
+			   CONVERT_SIZE_IN_BITS( contentBytes( TEST_EVENT_PADDING_SIZE_1, CONFIG_EVENT_MAX_PER_PACKET ) ) );
 	EXPECT_EQ( pktBuf->packet_size, CONVERT_SIZE_IN_BITS( sizeof( packet_buffer_t ) ) );
 }
 
@@ -117,6 +128,6 @@ TEST_F( EventPacketTest, DropEventValidation ) {
 	EXPECT_EQ( pktBuf->events_discarded, TEST_EVENT_DROP_COUNT );
 	EXPECT_EQ( pktBuf->packet_seq_count, TEST_SEQ_NO );
 
-	EXPECT_EQ( pktBuf->content_size, CONVERT_SIZE_IN_BITS( sizeof( uint32_t ) * 9 ) );
+	EXPECT_EQ( pktBuf->content_size, CONVERT_SIZE_IN_BITS( contentBytes( 0, 0 ) ) );
 	EXPECT_EQ( pktBuf->packet_size, CONVERT_SIZE_IN_BITS( sizeof( packet_buffer_t ) ) );
 }
@@ -47,3 +47,19 @@ TEST( StaticPoolTest, testPoolRelease ) {
 
 	EXPECT_EQ( sp.usedCount(), 0 );
 }
+
+TEST( StaticPoolTest, testPoolIndex ) {
+	StaticPool<pktPayload_t, 2> sp;
+	pktPayload_t other;
+
+	pktPayload_t *first	 = sp.allocate();
+	pktPayload_t *second = sp.allocate();
+
+	EXPECT_EQ( sp.indexOf( first ), 0 );
+	EXPECT_EQ( sp.indexOf( second ), 1 );
+	EXPECT_EQ( sp.at( 1 ), second );
+
+	// Foreign pointer and out of range index.
+	EXPECT_EQ( sp.indexOf( &other ), 2 );
+	EXPECT_EQ( sp.at( 2 ), nullptr );
+}
@@ -12,7 +12,12 @@
 template <typename T>
 concept PointerType = std::is_pointer_v<T>;
 
-template <PointerType T, std::size_t N> class Queue {
+// Concept: pointers, or integral handles (e.g. pool indices that stay valid
+// when the queue lives in memory shared between processes)
+template <typename T>
+concept QueueItemType = PointerType<T> || std::is_integral_v<T>;
+
+template <QueueItemType T, std::size_t N> class Queue {
 	static_assert( N > 0, "Queue size must be greater than 0" );
 
 private:
@@ -55,4 +60,33 @@ public:
 	constexpr bool isFull() const noexcept { return count == N; }
 
 	constexpr std::size_t size() const noexcept { return count; }
+
+	constexpr bool contains( T item ) const noexcept {
+		for ( std::size_t i = 0; i < count; ++i ) {
+			if ( buffer[ ( head + i ) % N ] == item ) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Bookkeeping sanity check, for a queue found in memory kept over a reset.
+	constexpr bool isValid() const noexcept {
+		return head < N && tail < N && count <= N && ( head + count ) % N == tail;
+	}
+
+	// Restore count from head and tail after an insert or remove cut
+	// between its stores (writer died, memory shared between processes).
+	// head == tail is full when count was within one of it.
+	constexpr void resync() noexcept {
+		if ( head >= N || tail >= N ) {
+			head  = 0;
+			tail  = 0;
+			count = 0;
+			return;
+		}
+
+		std::size_t n = ( tail + N - head ) % N;
+		count		  = ( n == 0 && count + 1 >= N ) ? N : n;
+	}
 };
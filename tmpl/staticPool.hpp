@@ -17,6 +17,13 @@ public:
 	void release( T *ptr ) noexcept;
 	std::size_t usedCount() noexcept;
 
+	// Position independent handle of an element (N when not from this pool).
+	std::size_t indexOf( const T *ptr ) const noexcept;
+	T *at( std::size_t index ) noexcept;
+
+	// True when the element at `index` is allocated.
+	bool isUsed( std::size_t index ) const noexcept;
+
 private:
 	std::array<T, N> pool;
 	std::bitset<N> used{};
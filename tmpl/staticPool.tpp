@@ -33,3 +33,22 @@ template <typename T, std::size_t N>
 std::size_t StaticPool<T, N>::usedCount() noexcept {
 	return used.count();
 }
+
+template <typename T, std::size_t N>
+	requires( !std::is_polymorphic_v<T> )
+std::size_t StaticPool<T, N>::indexOf( const T *ptr ) const noexcept {
+	auto index = static_cast<std::size_t>( ptr - pool.data() );
+	return ( index < N ) ? index : N;
+}
+
+template <typename T, std::size_t N>
+	requires( !std::is_polymorphic_v<T> )
+T *StaticPool<T, N>::at( std::size_t index ) noexcept {
+	return ( index < N ) ? &pool[ index ] : nullptr;
+}
+
+template <typename T, std::size_t N>
+	requires( !std::is_polymorphic_v<T> )
+bool StaticPool<T, N>::isUsed( std::size_t index ) const noexcept {
+	return index < N && used[ index ];
+}
@@ -2,6 +2,7 @@
 #!/usr/bin/env python3
 import sys
 import os
+import re
 import yaml
 import textwrap
 from jinja2 import Template
@@ -9,49 +10,183 @@ from jinja2 import Template
 # Supported C/C++ integer types that can appear in the event definitions.
 _supported_type_list = ["uint8_t", "uint16_t", "uint32_t", "int8_t", "int16_t", "int32_t"]
 
+# Size and registry type (eventFieldType, include/eventRegistry.hpp) of each type.
+_type_info = {
+    "uint8_t": (1, "u8"), "uint16_t": (2, "u16"), "uint32_t": (4, "u32"),
+    "int8_t": (1, "i8"), "int16_t": (2, "i16"), "int32_t": (4, "i32"),
+}
+
+# Field encodings of the YAML ``encoding`` attribute (include/eventEncoding.hpp):
+# value read by the decoder, signed or not.
+_encodings = {"delta": True, "varint": False, "zigzag": True}
+
+# Width tags of an encoded field, CTF variant option of each.
+_encoded_widths = (0, 1, 2, 4)
+
+# Event id reserved for EVT_LOG records (see include/eventLog.hpp).
+_event_log_id = 0xFFFF
+
+# Event id reserved for the load shedding marker (see include/eventShed.hpp),
+# its fields and the highest ``verbosity``.
+_event_shed_id = 0xFFFE
+_event_shed_fields = [{"name": "level", "type": "uint32_t"}, {"name": "ready", "type": "uint32_t"},
+                      {"name": "used", "type": "uint32_t"}]
+_verbosity_max = 3
+
+# Tokens of a ``where`` predicate: integer literal, name or C operator.
+_where_token = re.compile(r"\s*(?:(0[xX][0-9a-fA-F]+|\d+)[uU]?|([A-Za-z_]\w*)|"
+                          r"(<<|>>|<=|>=|==|!=|&&|\|\||[-+*/%<>!~&|^()\[\]?:]))")
+
+# libyaml backed loader when available, large catalogs parse much faster.
+_yaml_loader = getattr(yaml, "CSafeLoader", yaml.SafeLoader)
+
+# Compiled templates, keyed by their source text.
+_template_cache = {}
+
+def _template(tmpl_str):
+    """
+    Return the compiled jinja2 template of ``tmpl_str``; each template is
+    dedented and compiled once per run, not once per event.
+    """
+    tmpl = _template_cache.get(tmpl_str)
+    if tmpl is None:
+        tmpl = Template(textwrap.dedent(tmpl_str))
+        _template_cache[tmpl_str] = tmpl
+    return tmpl
+
+# --------------------------------------------------------------------------- #
+# Event layout -------------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def event_fields(event):
+    """
+    Payload fields of ``event`` in YAML order, with the trailing
+    ``duration`` of scope events.
+    """
+    fields = list(event.get('params', []))
+    if event.get('scope', False):
+        fields.append({"name": "duration", "type": "uint32_t"})
+    return fields
+
+def layout_fields(fields, aligned, boundary=None):
+    """
+    Wire order of ``fields``.  Packed, the YAML order.  Aligned
+    (``--aligned``, CONFIG_EVENT_ALIGNED in include/event.hpp), a stable
+    sort by element size, largest first, so every field is on its natural
+    boundary, then a ``_padding`` array up to ``boundary`` (default the
+    largest element): the C struct has no tail padding the CTF metadata
+    does not describe.
+    """
+    if not aligned:
+        return list(fields)
+
+    out = sorted(fields, key=lambda f: -_type_info[f['type']][0])
+    if boundary is None:
+        boundary = max((_type_info[f['type']][0] for f in out), default=1)
+    size = sum(_type_info[f['type']][0] * f.get('count', 1) for f in out)
+    if size % boundary:
+        out.append({"name": "_padding", "type": "uint8_t", "count": boundary - size % boundary})
+    return out
+
+def is_encoded(event):
+    """
+    True when a field of ``event`` has an ``encoding``: the event is then
+    written by ``EventEncoding<T>::encode()``, fields in YAML order and
+    byte packed in both layouts.
+    """
+    return any('encoding' in f for f in event.get('params', []))
+
+def encoded_bytes_max(event):
+    """
+    Largest encoded payload of ``event``: a width tag and the whole value
+    per encoded field, the others as is.
+    """
+    return sum(_type_info[f['type']][0] * f.get('count', 1) + ('encoding' in f)
+               for f in event_fields(event))
+
+def ctf_byte_type(type_name, aligned):
+    """
+    CTF type of a field of an encoded event, always on a byte boundary:
+    the typedef when packed, an inline integer when the typedef is
+    aligned.
+    """
+    size = _type_info[type_name][0]
+    if not aligned or size == 1:
+        return type_name
+    signed = "true" if type_name.startswith("int") else "false"
+    return f"integer {{ size = {size * 8}; align = 8; signed = {signed}; }}"
+
 # --------------------------------------------------------------------------- #
 # Generic file generator ---------------------------------------------------- #
 # --------------------------------------------------------------------------- #
 class GenerateFile:
     """
-    Base class that handles writing a header file and appending events to it.
-    The file path is stored in ``outfile`` and the stream ID (used in templates)
-    is stored in ``stream_id``.
+    Base class that builds the text of a generated file: a header followed
+    by appended blocks.  The file path is stored in ``outfile`` and the
+    stream ID (used in templates) is stored in ``stream_id``.  Nothing is
+    written before ``write()``.
     """
     def __init__(self, file_path, streamId):
         self.outfile = file_path
-        self.bHeaderAdded = False
         self.stream_id = streamId
+        self.parts = []
 
     # --------------------------------------------------------------------- #
     # Header generation --------------------------------------------------- #
     # --------------------------------------------------------------------- #
-    def add_header(self, tmpl_str):
-        inputs = {}
+    def add_header(self, tmpl_str, **inputs):
         inputs["stream_id"] = self.stream_id
-        template = Template(tmpl_str)
-        with open(self.outfile, 'w+') as f:
-            out_str = template.render(**inputs)
-            f.write(out_str)
+        self.parts = [_template(tmpl_str).render(**inputs)]
+
+    # --------------------------------------------------------------------- #
+    # Stream generation --------------------------------------------------- #
+    # --------------------------------------------------------------------- #
+    def add_stream(self, tmpl_str, stream, **inputs):
+        """
+        Switch to ``stream``: following events belong to it.
+        """
+        self.stream_id = stream["id"]
+        self.add_event(tmpl_str, stream, **inputs)
 
     # --------------------------------------------------------------------- #
     # Event generation ---------------------------------------------------- #
     # --------------------------------------------------------------------- #
-    def add_event(self, tmpl_str, event):
-        inputs = {}
-        inputs["stream_id"] = self.stream_id
-        inputs["evt"] = event
-        template = Template(tmpl_str)
-        with open(self.outfile, 'a') as f:
-            out_str = template.render(**inputs)
-            f.write(out_str)
+    def add_event(self, tmpl_str, event, **inputs):
+        self.parts.append(_template(tmpl_str).render(stream_id=self.stream_id, evt=event, **inputs))
+
+    # --------------------------------------------------------------------- #
+    # Output -------------------------------------------------------------- #
+    # --------------------------------------------------------------------- #
+    def write(self):
+        """
+        Write the file in one pass, only when its content changed: an
+        unchanged output keeps its timestamp and does not trigger a
+        rebuild of the sources including it.  Returns True when written.
+        """
+        content = "".join(self.parts).rstrip("\n") + "\n"
+        try:
+            with open(self.outfile, 'r') as f:
+                if f.read() == content:
+                    return False
+        except OSError:
+            pass
+
+        tmp_file = f"{self.outfile}.tmp"
+        with open(tmp_file, 'w') as f:
+            f.write(content)
+        os.replace(tmp_file, self.outfile)
+        return True
 
 # --------------------------------------------------------------------------- #
 # C++ header file generator ------------------------------------------------- #
 # --------------------------------------------------------------------------- #
-class CppHeaderFile(GenerateFile):
-    def __init__(self, dpath, streamId):
-        super().__init__(f"{dpath}/event_types.hpp", streamId)
+class CppStreamHeader(GenerateFile):
+    """
+    ``event_streams.hpp``: common includes, stream ids and packet context
+    types, shared by every group header.
+    """
+    def __init__(self, dpath, streamId, aligned=False):
+        super().__init__(f"{dpath}/event_streams.hpp", streamId)
+        self.aligned = aligned
         self._create()
 
     # --------------------------------------------------------------------- #
@@ -65,14 +200,71 @@ class CppHeaderFile(GenerateFile):
         c_code_tmpl = """
 
         #include <event.hpp>
+        #include <eventEncoding.hpp>
+        #include <eventScope.hpp>
+        #include <eventShed.hpp>
+        #include <eventWhere.hpp>
 
         #pragma once
 
         #define EVENT_STREAM_ID  {{ stream_id }}
 
         """
-        clean_template = textwrap.dedent(c_code_tmpl)
-        super().add_header(clean_template)
+        super().add_header(c_code_tmpl)
+
+    # --------------------------------------------------------------------- #
+    # Stream identifier --------------------------------------------------- #
+    # --------------------------------------------------------------------- #
+    def addStream(self, stream):
+        """
+        Define ``EVENT_STREAM_ID_<NAME>`` for a named stream, used with
+        ``setStreamId()`` of the collector instance owning the stream, and
+        the ``<name>_context_t`` of its packet context fields (``Context``
+        parameter of ``eventConfig``), packed or laid out up to the 8 byte
+        event boundary.
+        """
+        c_code_tmpl = """
+        {%- if evt.name %}
+        #define EVENT_STREAM_ID_{{ evt.name | upper }}  {{ evt.id }}
+        {% endif %}
+        {%- if evt.context %}
+        typedef struct {
+            {%- for f in evt.layout %}
+            {%- if f.count is defined %}
+            {{ f.type }} {{ f.name }}[{{ f.count }}];
+            {%- else %}
+            {{ f.type }} {{ f.name }};
+            {%- endif %}
+            {%- endfor %}
+        } {% if not aligned %}__attribute__((packed)) {% endif %}{{ evt.name or 'event' }}_context_t;
+        {% endif %}
+        """
+        super().add_stream(c_code_tmpl, dict(stream, layout=layout_fields(stream["context"], self.aligned, 8)),
+                           aligned=self.aligned)
+
+# --------------------------------------------------------------------------- #
+# C++ group header generator ------------------------------------------------ #
+# --------------------------------------------------------------------------- #
+class CppHeaderFile(GenerateFile):
+    """
+    ``event_types_<group>.hpp``: the event types of one YAML file.  A
+    source only needing one group includes its header and is not rebuilt
+    when another group changes.
+    """
+    def __init__(self, dpath, group, streamId, aligned=False):
+        super().__init__(f"{dpath}/event_types_{group}.hpp", streamId)
+        self.aligned = aligned
+        self._create()
+
+    def _create(self):
+        c_code_tmpl = """
+
+        #include <event_streams.hpp>
+
+        #pragma once
+
+        """
+        super().add_header(c_code_tmpl)
 
     # --------------------------------------------------------------------- #
     # Event type definition ----------------------------------------------- #
@@ -81,26 +273,251 @@ class CppHeaderFile(GenerateFile):
         """
         Append a struct and ``EventId`` specialization for the given event.
         The struct is marked with ``__attribute__((packed))`` to avoid
-        padding between fields.
+        padding between fields, or laid out by ``layout_fields`` in the
+        aligned layout.  Scope events get the trailing ``duration`` field
+        and an ``EventScope`` alias, other events a ``<name>_event()``
+        builder for batch submission (``pushEvents``) taking the fields in
+        YAML order.  A ``where`` predicate becomes the ``EventWhere``
+        specialization tested by the collector, encoded fields the
+        ``EventEncoding`` specialization serialising the payload and a
+        non zero ``verbosity`` the ``EventVerbosity`` used by load
+        shedding.
         """
         c_code_tmpl = """
         typedef struct {
-            {%- for f in evt.params %}
+            {%- for f in evt.layout %}
             {%- if f.count is defined %}
             {{ f.type }} {{ f.name }}[{{ f.count }}];
             {%- else %}
             {{ f.type }} {{ f.name }};
             {%- endif %}
             {%- endfor %}
-        } __attribute__((packed)) {{ evt.name }}_t;
+        } {% if not aligned %}__attribute__((packed)) {% endif %}{{ evt.name }}_t;
 
         template <>
         struct EventId<{{ evt.name }}_t> {
             static constexpr uint32_t value = {{ evt.id }};
         };
+        {%- if evt.where_cpp %}
+
+        /* where: {{ evt.where }} */
+        template <>
+        struct EventWhere<{{ evt.name }}_t> : eventWhereSwitch<{{ evt.name }}_t> {
+            static bool test(const {{ evt.name }}_t &e) { return {{ evt.where_cpp }}; }
+        };
+        {%- endif %}
+        {%- if evt.verbosity %}
+
+        template <>
+        struct EventVerbosity<{{ evt.name }}_t> {
+            static constexpr uint8_t value = {{ evt.verbosity }};
+        };
+        {%- endif %}
+        {%- if evt.encoded %}
+
+        template <>
+        struct EventEncoding<{{ evt.name }}_t> {
+            typedef struct {
+                {%- for f in evt.fields if f.encoding == 'delta' %}
+                {{ f.type }} {{ f.name }};
+                {%- endfor %}
+            } state_t;
+
+            static constexpr std::size_t bytesMax = {{ evt.bytes_max }};
+
+            static std::byte *encode(const {{ evt.name }}_t &e, [[maybe_unused]] state_t &prev, std::byte *out) {
+                {%- for f in evt.fields %}
+                {%- if f.encoding == 'delta' %}
+                out = eventEncodeDelta(out, e.{{ f.name }}, prev.{{ f.name }});
+                {%- elif f.encoding == 'varint' %}
+                out = eventEncodeVarint(out, e.{{ f.name }});
+                {%- elif f.encoding == 'zigzag' %}
+                out = eventEncodeZigzag(out, e.{{ f.name }});
+                {%- else %}
+                out = eventEncodeBytes(out, &e.{{ f.name }}, sizeof(e.{{ f.name }}));
+                {%- endif %}
+                {%- endfor %}
+                return out;
+            }
+        };
+        {%- endif %}
+        {%- if evt.scope %}
+
+        typedef EventScope<{{ evt.name }}_t> {{ evt.name }}_scope_t;
+        {%- else %}
+
+        inline Event<{{ evt.name }}_t> {{ evt.name }}_event(
+            {%- for f in evt.params %}
+            {%- if f.count is defined %}const {{ f.type }} (&{{ f.name }})[{{ f.count }}]
+            {%- else %}{{ f.type }} {{ f.name }}{% endif %}{% if not loop.last %}, {% endif %}
+            {%- endfor %}) {
+            Event<{{ evt.name }}_t> evt;
+            {%- for f in evt.params %}
+            {%- if f.count is defined %}
+            for (unsigned i = 0; i < {{ f.count }}; i++) {
+                evt.getParam()->{{ f.name }}[i] = {{ f.name }}[i];
+            }
+            {%- else %}
+            evt.getParam()->{{ f.name }} = {{ f.name }};
+            {%- endif %}
+            {%- endfor %}
+            return evt;
+        }
+        {%- endif %}
+        """
+        super().add_event(c_code_tmpl, dict(event, layout=layout_fields(event_fields(event), self.aligned),
+                                            fields=event_fields(event), encoded=is_encoded(event),
+                                            bytes_max=encoded_bytes_max(event)),
+                          aligned=self.aligned)
+
+# --------------------------------------------------------------------------- #
+# C++ umbrella header generator --------------------------------------------- #
+# --------------------------------------------------------------------------- #
+class CppUmbrellaHeader(GenerateFile):
+    """
+    ``event_types.hpp``: includes every group header and switches the
+    ``where`` predicates at runtime.
+    """
+    def __init__(self, dpath, streamId):
+        super().__init__(f"{dpath}/event_types.hpp", streamId)
+        self._create()
+
+    def _create(self):
+        c_code_tmpl = """
+
+        #include <event_streams.hpp>
+
+        #pragma once
+        """
+        super().add_header(c_code_tmpl)
+
+    def addGroup(self, group):
+        c_code_tmpl = """
+        #include <event_types_{{ evt }}.hpp>
+        """
+        super().add_event(c_code_tmpl, group)
+
+    def addWhere(self, events):
+        """
+        Runtime switches of every capture predicate, by stream and event
+        id (e.g. from a debug command).  ``eventWhereSet`` returns false
+        for an event without predicate.
+        """
+        c_code_tmpl = """
+        inline bool eventWhereSet([[maybe_unused]] uint32_t streamId, [[maybe_unused]] uint32_t id,
+                                  [[maybe_unused]] bool on) {
+            {%- for e in evt %}
+            if (streamId == {{ e.stream }} && id == {{ e.id }}) {
+                EventWhere<{{ e.name }}_t>::enable(on);
+                return true;
+            }
+            {%- endfor %}
+            return false;
+        }
+
+        inline void eventWhereSetAll([[maybe_unused]] bool on) {
+            {%- for e in evt %}
+            EventWhere<{{ e.name }}_t>::enable(on);
+            {%- endfor %}
+        }
+        """
+        super().add_event(c_code_tmpl, events)
+
+# --------------------------------------------------------------------------- #
+# C++ event registry generator ---------------------------------------------- #
+# --------------------------------------------------------------------------- #
+class CppRegistryHeader(GenerateFile):
+    """
+    ``event_registry.hpp``: constexpr table of every event (dense index,
+    id, name, payload size, field offsets and types).  It only includes
+    ``eventRegistry.hpp`` so host tools can use it too.
+    """
+    def __init__(self, dpath, streamId, aligned=False):
+        super().__init__(f"{dpath}/event_registry.hpp", streamId)
+        self.aligned = aligned
+
+    def build(self, streams):
+        """
+        Number the events densely (streams in order, events by id) and
+        lay out their fields as the generated structs do.  The payload size
+        includes the ``_padding`` of the aligned layout, which is not a
+        field.  Offsets are those of the struct; an event with an encoded
+        field has a variable size on wire.
+        """
+        events = []
+        fields = []
+        slots = []
+        tables = []
+        for s in streams:
+            stream_events = sorted((e for g in s["groups"] for e in g["events"]),
+                                   key=lambda e: e['id'])
+            slot_count = stream_events[-1]['id'] + 1 if stream_events else 0
+            tables.append({"id": s["id"], "first": len(slots), "count": slot_count})
+            slots.extend(["eventRegistryNoSlot"] * slot_count)
+
+            for e in stream_events:
+                offset = 0
+                first = len(fields)
+                for f in layout_fields(event_fields(e), self.aligned):
+                    size, kind = _type_info[f['type']]
+                    count = f.get('count', 1)
+                    if f['name'] != "_padding":
+                        fields.append({"name": f['name'], "type": kind, "offset": offset, "count": count,
+                                       "encoding": f.get('encoding', "none")})
+                    offset += size * count
+
+                slots[tables[-1]["first"] + e['id']] = str(len(events))
+                events.append({"stream": s["id"], "id": e['id'], "name": e['name'], "size": offset,
+                               "first": first, "count": len(fields) - first,
+                               "scope": "true" if e.get('scope', False) else "false"})
+
+        if len(events) >= 0xFFFF:
+            print(f"{len(events)} events do not fit the 16 bit registry index")
+            sys.exit(-1)
+
+        c_code_tmpl = """
+
+        #include <eventRegistry.hpp>
+
+        #include <array>
+
+        #pragma once
+
+        struct eventRegistry {
+            static constexpr std::size_t count = {{ evt.events | length }};
+
+            static constexpr std::array<eventFieldInfo, {{ evt.fields | length }}> fields = { {
+                {%- for f in evt.fields %}
+                { "{{ f.name }}", eventFieldType::{{ f.type }}, {{ f.offset }}, {{ f.count }}, eventFieldEncoding::{{ f.encoding }} },
+                {%- endfor %}
+            } };
+
+            static constexpr std::array<eventInfo, {{ evt.events | length }}> events = { {
+                {%- for e in evt.events %}
+                { {{ e.stream }}, {{ e.id }}, "{{ e.name }}", {{ e.size }}, {{ e.first }}, {{ e.count }}, {{ e.scope }} },
+                {%- endfor %}
+            } };
+
+            static constexpr std::array<eventRegistryStream, {{ evt.tables | length }}> streams = { {
+                {%- for t in evt.tables %}
+                { {{ t.id }}, {{ t.first }}, {{ t.count }} },
+                {%- endfor %}
+            } };
+
+            static constexpr std::array<uint16_t, {{ evt.slots | length }}> slots = { {
+                {%- for v in evt.slots %}
+                {{ v }},
+                {%- endfor %}
+            } };
+
+            /* Dense index of an event, `count` when unknown. */
+            static constexpr std::size_t indexOf( uint32_t streamId, uint32_t id ) {
+                return eventRegistryLookup<eventRegistry>( streamId, id );
+            }
+        };
         """
-        clean_template = textwrap.dedent(c_code_tmpl)
-        super().add_event(clean_template, event)
+        super().add_header(c_code_tmpl, evt={"events": events, "fields": fields,
+                                             "tables": tables, "slots": slots})
 
 # --------------------------------------------------------------------------- #
 # Babeltrace metadata generator --------------------------------------------- #
@@ -110,25 +527,27 @@ class BabeltraceMetadata(GenerateFile):
     Generates a Babeltrace (CTF) configuration file that describes the
     trace format and all events.  The main file is named simply ``metadata``.
     """
-    def __init__(self, dpath, streamId):
+    def __init__(self, dpath, streamId, aligned=False):
         super().__init__(f"{dpath}/metadata", streamId)
+        self.aligned = aligned
+        self.width_declared = False
         self._create()
 
     def _create(self):
         """
         Write the core trace definition (types, trace properties,
-        clock, packet header, etc.).  The only dynamic part is
-        ``{{ stream_id }}``.
+        clock, packet header).  Streams are appended by ``addStream``.
+        The aligned layout aligns every integer on its size.
         """
         bb_config_hdr = """\
         /* CTF 1.8 */
 
-        typedef integer { size = 64; align = 8; signed = false; } uint64_t;
-        typedef integer { size = 32; align = 8; signed = false; } uint32_t;
-        typedef integer { size = 16; align = 8; signed = false; } uint16_t;
+        typedef integer { size = 64; align = {{ 64 if aligned else 8 }}; signed = false; } uint64_t;
+        typedef integer { size = 32; align = {{ 32 if aligned else 8 }}; signed = false; } uint32_t;
+        typedef integer { size = 16; align = {{ 16 if aligned else 8 }}; signed = false; } uint16_t;
         typedef integer { size = 8; align = 8; signed = false; }  uint8_t;
-        typedef integer { size = 32; align = 8; signed = true; }  int32_t;
-        typedef integer { size = 16; align = 8; signed = true; }  int16_t;
+        typedef integer { size = 32; align = {{ 32 if aligned else 8 }}; signed = true; }  int32_t;
+        typedef integer { size = 16; align = {{ 16 if aligned else 8 }}; signed = true; }  int16_t;
         typedef integer { size = 8; align = 8; signed = true; }   int8_t;
 
         trace {
@@ -148,8 +567,22 @@ class BabeltraceMetadata(GenerateFile):
              freq = 1000000000; /* 1 GHz = ns */
         };
 
+        """
+        super().add_header(bb_config_hdr, aligned=self.aligned)
+
+    # --------------------------------------------------------------------- #
+    # Stream definition --------------------------------------------------- #
+    # --------------------------------------------------------------------- #
+    def addStream(self, stream):
+        """
+        Append a ``stream`` block; every stream shares the packet and
+        event header layout of the collector, its context fields follow
+        ``packet_seq_count``.  Events added afterwards belong to this
+        stream.
+        """
+        bb_config_stream = """
         stream {
-             id = {{ stream_id }};
+             id = {{ evt.id }};
 
              packet.context := struct {
                  uint64_t timestamp_begin;
@@ -158,6 +591,13 @@ class BabeltraceMetadata(GenerateFile):
                  uint32_t packet_size;
                  uint32_t content_size;
                  uint32_t packet_seq_count;
+                 {%- for f in evt.layout %}
+                 {%- if f.count is defined %}
+                 {{ f.type }} {{ f.name }}[{{ f.count }}];
+                 {%- else %}
+                 {{ f.type }} {{ f.name }};
+                 {%- endif %}
+                 {%- endfor %}
              };
 
              event.header := struct {
@@ -167,8 +607,48 @@ class BabeltraceMetadata(GenerateFile):
         };
 
         """
-        clean_template = textwrap.dedent(bb_config_hdr)
-        super().add_header(clean_template)
+        super().add_stream(bb_config_stream,
+                           dict(stream, layout=layout_fields(stream["context"], self.aligned, 8)))
+        self._addLogEvent()
+        self._addShedEvent()
+
+    # --------------------------------------------------------------------- #
+    # EVT_LOG record definition ------------------------------------------- #
+    # --------------------------------------------------------------------- #
+    def _addLogEvent(self):
+        """
+        Append the fixed ``evt_log`` event used by ``EVT_LOG``.  Only the
+        format string id and the arguments are on wire, the host expands
+        the text with the table from ``event_log_strings.py``.
+        """
+        bb_config_log = """
+        event {
+            name = evt_log;
+            id   = {{ evt.id }};
+            stream_id = {{ stream_id }};
+
+            fields := struct {
+                uint32_t fmt_id;
+                uint8_t argc;
+                {%- if aligned %}
+                uint8_t _padding[3];
+                {%- endif %}
+                uint32_t args[argc];
+            };
+        };
+
+        """
+        super().add_event(bb_config_log, {"id": _event_log_id}, aligned=self.aligned)
+
+    # --------------------------------------------------------------------- #
+    # Load shedding marker ------------------------------------------------ #
+    # --------------------------------------------------------------------- #
+    def _addShedEvent(self):
+        """
+        Append the fixed ``evt_shed`` event the collector writes when its
+        load shedding level changes.
+        """
+        self.addEvent({"name": "evt_shed", "id": _event_shed_id, "params": _event_shed_fields})
 
     # --------------------------------------------------------------------- #
     # Individual event definition ----------------------------------------- #
@@ -185,7 +665,7 @@ class BabeltraceMetadata(GenerateFile):
             stream_id = {{ stream_id }};
 
             fields := struct {
-                {%- for f in evt.params %}
+                {%- for f in evt.layout %}
                 {%- if f.count is defined %}
                 {{ f.type }} {{ f.name }}[{{ f.count }}];
                 {%- else %}
@@ -196,42 +676,142 @@ class BabeltraceMetadata(GenerateFile):
         };
 
         """
-        clean_template = textwrap.dedent(bb_config_event)
-        super().add_event(clean_template, event)
+        if is_encoded(event):
+            self._addEncodedEvent(event)
+            return
+        super().add_event(bb_config_event,
+                          dict(event, layout=layout_fields(event_fields(event), self.aligned)))
+
+    # --------------------------------------------------------------------- #
+    # Event with encoded fields ------------------------------------------- #
+    # --------------------------------------------------------------------- #
+    def _addEncodedEvent(self, event):
+        """
+        Append an event with encoded fields: YAML order, byte packed, an
+        encoded field being its width tag ``<name>_width`` then a variant
+        of the value on that many bytes (``w0`` empty).  The tag enum is
+        declared once, before its first use.
+        """
+        bb_config_width = """
+        typedef enum : uint8_t { w0 = 0, w1 = 1, w2 = 2, w4 = 4 } evt_width_t;
+
+        """
+        bb_config_event = """
+        event {
+            name = {{ evt.name }};
+            id   = {{ evt.id }};
+            stream_id = {{ stream_id }};
+
+            fields := struct {
+                {%- for f in evt.fields %}
+                {%- if f.encoding is defined %}
+                evt_width_t {{ f.name }}_width;
+                variant <{{ f.name }}_width> {
+                    struct { } w0;
+                    {%- for w in evt.widths %}
+                    {{ f.variant[w] }} w{{ w }};
+                    {%- endfor %}
+                } {{ f.name }};
+                {%- elif f.count is defined %}
+                {{ f.ctf }} {{ f.name }}[{{ f.count }}];
+                {%- else %}
+                {{ f.ctf }} {{ f.name }};
+                {%- endif %}
+                {%- endfor %}
+            };
+        };
+
+        """
+        if not self.width_declared:
+            super().add_event(bb_config_width, {})
+            self.width_declared = True
+
+        fields = []
+        for f in event_fields(event):
+            f = dict(f, ctf=ctf_byte_type(f['type'], self.aligned))
+            if 'encoding' in f:
+                sign = "" if _encodings[f['encoding']] else "u"
+                f['variant'] = {w: ctf_byte_type(f"{sign}int{w * 8}_t", self.aligned)
+                                for w in _encoded_widths[1:]}
+            fields.append(f)
+        super().add_event(bb_config_event, dict(event, fields=fields, widths=_encoded_widths[1:]))
 
 # --------------------------------------------------------------------------- #
 # YAML parsing utilities ---------------------------------------------------- #
 # --------------------------------------------------------------------------- #
+def group_name(file_path):
+    """
+    Group of a YAML file: its base name, usable in a file and C name.
+    """
+    stem = re.sub(r"\W", "_", os.path.splitext(os.path.basename(file_path))[0])
+    return f"_{stem}" if stem[:1].isdigit() else stem
+
 def parse_yaml_file(file_path):
     """
-    Generator that yields one event at a time from a potentially large
-    YAML file.  The YAML is expected to be a list of dictionaries,
-    each containing an ``events`` key whose value is a list of events.
+    Load one YAML file (one group of events).  The YAML is expected to be
+    a list of dictionaries: an optional ``stream`` entry (``name``, ``id``
+    and the ``context`` fields written once per packet), optional
+    ``constants`` (named values of the ``where`` predicates) and entries
+    with an ``events`` list.  A file without ``stream`` entry describes
+    the unnamed stream 0.
     """
     with open(file_path, 'r') as f:
-        data = yaml.safe_load(f)
+        data = yaml.load(f, Loader=_yaml_loader) or []
+
+    stream = {"name": None, "id": 0, "context": []}
+    events = []
+    constants = {}
+    for entry in data:
+        if 'stream' in entry:
+            s = entry['stream']
+            stream = {"name": s.get('name'), "id": int(s.get('id', 0)),
+                      "context": s.get('context') or []}
+        constants.update(entry.get('constants') or {})
+        events.extend(entry.get('events') or [])
 
-    for event_entry in data:
-        events = event_entry.get('events', [])
-        for ev in events:
-            yield (ev)
+    return {"group": group_name(file_path), "stream": stream, "events": events,
+            "constants": constants}
 
 # --------------------------------------------------------------------------- #
 # Validation utilities ------------------------------------------------------ #
 # --------------------------------------------------------------------------- #
-def check_argument(event):
+def check_argument(event, gName):
     """
     Validate that the event dictionary contains a string name, a non‑negative
-    integer ID and parameters that use only supported types.
+    integer ID when given and parameters that use only supported types.
     If validation fails, print an error message and exit.
     """
     event_name = event['name']
-    event_id = int(event['id'])
     if not isinstance(event_name, str):
         print(f"group:{gName} event name not a string")
         sys.exit(-1)
-    if event_id < 0:
-        print(f"{event_name} event Id negative not supported")
+    if 'id' in event:
+        if not isinstance(event['id'], int):
+            print(f"{event_name} event Id {event['id']} not an integer")
+            sys.exit(-1)
+        event_id = event['id']
+        if event_id < 0:
+            print(f"{event_name} event Id negative not supported")
+            sys.exit(-1)
+        if event_id == _event_log_id:
+            print(f"{event_name} event Id {event_id} is reserved for EVT_LOG")
+            sys.exit(-1)
+        if event_id == _event_shed_id:
+            print(f"{event_name} event Id {event_id} is reserved for the load shedding marker")
+            sys.exit(-1)
+
+    scope = event.get('scope', False)
+    if not isinstance(scope, bool):
+        print(f"{event_name} scope must be true or false")
+        sys.exit(-1)
+
+    verbosity = event.get('verbosity', 0)
+    if not isinstance(verbosity, int) or isinstance(verbosity, bool) or not 0 <= verbosity <= _verbosity_max:
+        print(f"{event_name} verbosity must be an integer from 0 to {_verbosity_max}")
+        sys.exit(-1)
+
+    if 'where' in event and not isinstance(event['where'], str):
+        print(f"{event_name} where must be a string")
         sys.exit(-1)
 
     params = event.get('params', [])
@@ -252,29 +832,251 @@ def check_argument(event):
             if c <= 0:
                 print(f"group:{gName} event:{event_name} parameter {n} count not allow as negative or zero {c}")
                 sys.exit(-1)
+        if n == '_padding':
+            print(f"event:{event_name} parameter name {n} is reserved for the aligned layout")
+            sys.exit(-1)
+        if scope and n == 'duration':
+            print(f"event:{event_name} scope event already provides parameter {n}")
+            sys.exit(-1)
         if t not in _supported_type_list:
             print(f"group:{gName} event:{event_name} have unsupported type {t}")
             sys.exit(-1)
+        if 'encoding' in p:
+            check_encoding(event, p)
+
+def check_encoding(event, field):
+    """
+    ``encoding`` of a field: a scalar; ``varint`` for an unsigned type,
+    ``zigzag`` for a signed one, ``delta`` for any.  The width tag
+    ``<name>_width`` must not clash with another field.
+    """
+    enc = field['encoding']
+    n = field['name']
+    if enc not in _encodings:
+        print(f"event:{event['name']} parameter {n}: encoding {enc} not one of {', '.join(_encodings)}")
+        sys.exit(-1)
+    if 'count' in field:
+        print(f"event:{event['name']} parameter {n}: encoding not supported on an array")
+        sys.exit(-1)
+    if enc != "delta" and _encodings[enc] != field['type'].startswith("int"):
+        print(f"event:{event['name']} parameter {n}: encoding {enc} needs "
+              f"{'a signed' if _encodings[enc] else 'an unsigned'} type")
+        sys.exit(-1)
+    if any(f['name'] == f"{n}_width" for f in event_fields(event)):
+        print(f"event:{event['name']} parameter {n}_width clashes with the width tag of {n}")
+        sys.exit(-1)
+
+def compile_where(event, constants):
+    """
+    C++ expression of the ``where`` predicate of ``event`` on a payload
+    ``e``: field names become members, names of ``constants`` their value,
+    operators and integer literals are kept.  Array fields must be
+    indexed.  Anything else (assignment, call, unknown name) is an error.
+    """
+    text = event['where'].rstrip()
+    fields = {f['name']: f for f in event_fields(event)}
+    tokens = []
+    pos = 0
+    while pos < len(text):
+        m = _where_token.match(text, pos)
+        if m is None:
+            print(f"event:{event['name']} where: unexpected '{text[pos:].strip()}'")
+            sys.exit(-1)
+        tokens.append(m)
+        pos = m.end()
+
+    out = []
+    for i, m in enumerate(tokens):
+        number, name, op = m.groups()
+        if number is not None:
+            out.append(m.group().strip())
+        elif op is not None:
+            out.append(op)
+        elif name in fields:
+            indexed = i + 1 < len(tokens) and tokens[i + 1].group(3) == "["
+            if indexed != ('count' in fields[name]):
+                print(f"event:{event['name']} where: field {name} "
+                      f"{'must' if not indexed else 'cannot'} be indexed")
+                sys.exit(-1)
+            out.append(f"e.{name}")
+        elif name in constants:
+            out.append(f"({constants[name]})")
+        else:
+            print(f"event:{event['name']} where: unknown name {name}")
+            sys.exit(-1)
+
+    if not out:
+        print(f"event:{event['name']} where: empty predicate")
+        sys.exit(-1)
+    expr = re.sub(r"\s*\[\s*", "[", " ".join(out))
+    expr = re.sub(r"\s*\]", "]", expr)
+    return "(" + re.sub(r"\(\s+", "(", re.sub(r"\s+\)", ")", expr)) + ")"
+
+def check_constants(group):
+    """
+    ``constants`` of a group: identifiers mapped to integers.  In a
+    predicate a field name takes precedence over a constant.
+    """
+    for n, v in group["constants"].items():
+        if not isinstance(n, str) or not re.fullmatch(r"[A-Za-z_]\w*", n):
+            print(f"group:{group['group']} constant name {n} is not an identifier")
+            sys.exit(-1)
+        if not isinstance(v, int) or isinstance(v, bool):
+            print(f"group:{group['group']} constant {n} value {v} is not an integer")
+            sys.exit(-1)
+
+def check_streams(groups):
+    """
+    Every YAML file is one group of one stream; several groups may share
+    a stream by declaring the same ``stream`` entry.  Group names must be
+    unique and, with more than one stream, every stream must be named.
+    Returns the streams in order of appearance, each with its groups.
+    """
+    streams = {}
+    names = set()
+    for g in groups:
+        s = g["stream"]
+        if g["group"] in names:
+            print(f"group {g['group']} defined by more than one file")
+            sys.exit(-1)
+        names.add(g["group"])
+
+        if s["id"] < 0:
+            print(f"stream {s['name']} Id negative not supported")
+            sys.exit(-1)
+        if s["id"] in streams:
+            known = streams[s["id"]]
+            if known["name"] != s["name"] or known["context"] != s["context"]:
+                print(f"stream Id {s['id']} declared differently in group {g['group']}")
+                sys.exit(-1)
+            known["groups"].append(g)
+            continue
+        streams[s["id"]] = dict(s, groups=[g])
+
+    for s in streams.values():
+        if len(streams) > 1 and not isinstance(s["name"], str):
+            print(f"stream Id {s['id']} needs a name when several streams are generated")
+            sys.exit(-1)
+
+        fields = set()
+        for f in s["context"]:
+            n = f.get('name')
+            t = f.get('type')
+            if not isinstance(n, str) or n in fields:
+                print(f"stream {s['name']} context field name {n} missing or duplicated")
+                sys.exit(-1)
+            if t not in _supported_type_list or 'count' in f:
+                print(f"stream {s['name']} context field {n}: only scalar supported types allowed")
+                sys.exit(-1)
+            fields.add(n)
+
+    return list(streams.values())
+
+def assign_ids(events):
+    """
+    Give every event of a stream without ``id`` the lowest id not used in
+    the stream, in file order.  Auto ids move when events are added in
+    front, pin them in the YAML when older traces must stay decodable.
+    """
+    used = {e['id'] for e in events if 'id' in e}
+    used.update((_event_log_id, _event_shed_id))
+
+    next_id = 0
+    for e in events:
+        if 'id' not in e:
+            while next_id in used:
+                next_id += 1
+            e['id'] = next_id
+            used.add(next_id)
+
+def check_unique(event, stream, names, ids):
+    """
+    Event names map to C++ types and must be unique in the trace, event
+    ids only need to be unique inside their stream.
+    """
+    if event['name'] in names:
+        print(f"{event['name']} event defined more than once")
+        sys.exit(-1)
+    if event['id'] in ids:
+        print(f"{event['name']} event Id {event['id']} duplicated in stream {stream['id']}"
+              f" (already used by {ids[event['id']]})")
+        sys.exit(-1)
+    names.add(event['name'])
+    ids[event['id']] = event['name']
 
 # --------------------------------------------------------------------------- #
 # Main entry point ---------------------------------------------------------- #
 # --------------------------------------------------------------------------- #
-def main(yaml_file, out_path):
+def main(yaml_files, out_path, aligned=False):
     """
-    High‑level driver that creates the C++ header and Babeltrace
-    metadata files, then iterates over all events in the YAML file,
-    validates them, and writes their definitions to both outputs.
+    High‑level driver: loads every YAML file (one group each), validates
+    groups, streams and events, assigns missing ids, then builds the
+    headers and the Babeltrace metadata in memory.  Each output is written
+    once at the end and only when its content changed:
+
+        event_streams.hpp        stream ids and packet context types
+        event_types_<group>.hpp  event types of one YAML file
+        event_types.hpp          includes every group header, predicate switches
+        event_registry.hpp       constexpr table of all events
+        metadata                 CTF metadata of all streams
+
+    ``aligned`` selects the naturally aligned layout of
+    CONFIG_EVENT_ALIGNED (cmake EVENT_ALIGNED_LAYOUT) instead of packed.
     """
-    c_file = CppHeaderFile(out_path, 0)
-    bb_file = BabeltraceMetadata(out_path, 0)
+    groups = [parse_yaml_file(f) for f in yaml_files]
+    streams = check_streams(groups)
+    os.makedirs(out_path, exist_ok=True)
+    names = set()
+
+    for g in groups:
+        check_constants(g)
+        for event in g["events"]:
+            check_argument(event, g["group"])
+            if 'where' in event:
+                event['where_cpp'] = compile_where(event, g["constants"])
+
+    for s in streams:
+        events = [e for g in s["groups"] for e in g["events"]]
+        assign_ids(events)
+        ids = {}
+        for event in events:
+            check_unique(event, s, names, ids)
+
+    s_file = CppStreamHeader(out_path, streams[0]["id"], aligned)
+    u_file = CppUmbrellaHeader(out_path, streams[0]["id"])
+    bb_file = BabeltraceMetadata(out_path, streams[0]["id"], aligned)
+
+    for s in streams:
+        s_file.addStream(s)
+        bb_file.addStream(s)
+        for g in s["groups"]:
+            for event in g["events"]:
+                bb_file.addEvent(event)
+
+    for g in groups:
+        c_file = CppHeaderFile(out_path, g["group"], g["stream"]["id"], aligned)
+        for event in g["events"]:
+            c_file.addEvent(event)
+        c_file.write()
+        u_file.addGroup(g["group"])
+
+    u_file.addWhere([dict(e, stream=s["id"]) for s in streams
+                     for g in s["groups"] for e in g["events"] if 'where' in e])
+
+    r_file = CppRegistryHeader(out_path, streams[0]["id"], aligned)
+    r_file.build(streams)
 
-    for event in parse_yaml_file(yaml_file):
-        check_argument(event)
-        c_file.addEvent(event)
-        bb_file.addEvent(event)
+    s_file.write()
+    u_file.write()
+    r_file.write()
+    bb_file.write()
 
 if __name__ == "__main__":
-    if len(sys.argv) != 3:
-        print(f"Usage: {sys.argv[0]} <yaml_file>")
+    args = sys.argv[1:]
+    aligned = "--aligned" in args
+    if aligned:
+        args.remove("--aligned")
+    if len(args) < 2:
+        print(f"Usage: {sys.argv[0]} [--aligned] <yaml_file> [<yaml_file> ...] <out_dir>")
         sys.exit(1)
-    main(sys.argv[1], sys.argv[2])
+    main(args[:-1], args[-1], aligned)
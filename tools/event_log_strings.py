@@ -0,0 +1,152 @@
+# SPDX-License-Identifier: MIT | Author: Rohit Patil
+#!/usr/bin/env python3
+import os
+import re
+import struct
+import subprocess
+import sys
+import tempfile
+import yaml
+
+# Linker section holding the EVT_LOG format strings (see include/eventLog.hpp).
+_fmt_section = "evt_log_fmt"
+
+# Printf conversion specifier: flags, width, precision, length and type.
+# Same grammar as eventLogArgCount(): no `*`, %s or %n.
+_fmt_spec = re.compile(r"%(%|[-+ #0]*\d*(?:\.\d*)?(?:hh|h|ll|l|z|j|t)?([diuxXoceEfgGp]))")
+
+# --------------------------------------------------------------------------- #
+# String id ----------------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def fmt_id(fmt):
+    """
+    FNV-1a hash of the format string, same as ``eventLogFmtId()``.
+    """
+    h = 0x811C9DC5
+    for c in fmt.encode("utf-8"):
+        h ^= c
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return h
+
+def fmt_valid(fmt):
+    """
+    True when every ``%`` of the format starts a ``_fmt_spec`` specifier,
+    as ``eventLogArgCount()`` requires.
+    """
+    pos = fmt.find("%")
+    while pos >= 0:
+        m = _fmt_spec.match(fmt, pos)
+        if not m:
+            return False
+        pos = fmt.find("%", m.end())
+    return True
+
+# --------------------------------------------------------------------------- #
+# Post-link extraction ------------------------------------------------------ #
+# --------------------------------------------------------------------------- #
+def extract(elf_file, out_file):
+    """
+    Dump the format string section of the linked image and write the
+    ``id -> format`` table next to the babeltrace metadata.
+    """
+    objcopy = os.environ.get("OBJCOPY", "objcopy")
+
+    with tempfile.TemporaryDirectory() as tmp:
+        raw_file = os.path.join(tmp, "fmt.bin")
+        subprocess.run([objcopy, "-O", "binary", f"--only-section={_fmt_section}",
+                        elf_file, raw_file], check=True)
+        with open(raw_file, "rb") as f:
+            raw = f.read()
+
+    table = {}
+    for s in raw.split(b"\0"):
+        if not s:
+            continue
+        fmt = s.decode("utf-8")
+        if not fmt_valid(fmt):
+            print(f"format string not supported by EVT_LOG: '{fmt}'")
+            sys.exit(-1)
+        sid = fmt_id(fmt)
+        if sid in table and table[sid] != fmt:
+            print(f"format string id collision 0x{sid:08x}: '{table[sid]}' '{fmt}'")
+            sys.exit(-1)
+        table[sid] = fmt
+
+    with open(out_file, "w") as f:
+        yaml.safe_dump([{"id": k, "fmt": v} for k, v in sorted(table.items())], f)
+
+def load_table(table_file):
+    with open(table_file, "r") as f:
+        return {e["id"]: e["fmt"] for e in (yaml.safe_load(f) or [])}
+
+# --------------------------------------------------------------------------- #
+# Message expansion --------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def expand(fmt, args):
+    """
+    Expand a C format string with the 32-bit argument words of a record.
+    """
+    words = iter(args)
+
+    def _conv(m):
+        if m.group(1) == "%":
+            return "%"
+        spec = m.group(0)
+        kind = m.group(2)
+        word = next(words, 0) & 0xFFFFFFFF
+        # Drop C length modifiers, python does not know them.
+        spec = re.sub(r"(hh|h|ll|l|z|j|t)(?=[a-zA-Z]$)", "", spec)
+        if kind in "di":
+            value = word - (1 << 32) if word & 0x80000000 else word
+        elif kind in "eEfgG":
+            value = struct.unpack("<f", struct.pack("<I", word))[0]
+        elif kind == "c":
+            value = word & 0xFF
+        else:
+            value = word
+        if kind == "u":
+            spec = spec[:-1] + "d"
+        elif kind == "p":
+            spec = spec[:-1] + "x"
+        return spec % value
+
+    return _fmt_spec.sub(_conv, fmt)
+
+# babeltrace2 text output of one evt_log record.
+_bt_log = re.compile(r"evt_log: (?:\{[^{}]*\}, )*\{ fmt_id = (\d+), argc = (\d+)"
+                     r"(?:, args = \[(.*)\])? \}")
+
+def expand_stream(table, lines, out):
+    """
+    Replace the evt_log payload in ``babeltrace2`` text output with the
+    expanded message.
+    """
+    for line in lines:
+        m = _bt_log.search(line)
+        if m:
+            sid = int(m.group(1))
+            args = [int(v) for v in re.findall(r"\] = (\d+)", m.group(3) or "")]
+            text = expand(table[sid], args) if sid in table else f"<unknown fmt 0x{sid:08x}>"
+            line = line[:m.start()] + f"evt_log: {text}" + line[m.end():]
+        out.write(line)
+
+# --------------------------------------------------------------------------- #
+# Main entry point ---------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def main(argv):
+    if len(argv) == 4 and argv[1] == "extract":
+        extract(argv[2], argv[3])
+    elif len(argv) in (3, 4) and argv[1] == "expand":
+        table = load_table(argv[2])
+        if len(argv) == 4:
+            with open(argv[3], "r") as f:
+                expand_stream(table, f, sys.stdout)
+        else:
+            expand_stream(table, sys.stdin, sys.stdout)
+    else:
+        print(f"Usage: {argv[0]} extract <elf_file> <table_file>")
+        print(f"       {argv[0]} expand <table_file> [babeltrace2_text]")
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main(sys.argv)
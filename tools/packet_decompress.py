@@ -0,0 +1,102 @@
+# SPDX-License-Identifier: MIT | Author: Rohit Patil
+#!/usr/bin/env python3
+import struct
+import sys
+
+# Frame header, see include/packetCodec.hpp.
+_frame_magic = 0xC7F1
+_frame_hdr = struct.Struct("<HBBII")
+
+_codec_raw = 0
+_codec_lz = 1
+
+# Shortest encoded match.
+_match_min = 4
+
+# --------------------------------------------------------------------------- #
+# Block decoder ------------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def _varint(buf, pos):
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(buf):
+            raise ValueError("truncated varint")
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if (b & 0x80) == 0:
+            return value, pos
+        shift += 7
+
+def decompress(block, raw_size):
+    """
+    Decode one ``packetCodecLz`` block into the plain CTF packet.
+    """
+    out = bytearray()
+    pos = 0
+    while True:
+        lit, pos = _varint(block, pos)
+        out += block[pos:pos + lit]
+        pos += lit
+        m, pos = _varint(block, pos)
+        if m == 0:
+            break
+        offset, pos = _varint(block, pos)
+        if offset == 0 or offset > len(out):
+            raise ValueError("bad match offset")
+        # Overlapping copy repeats the last ``offset`` bytes.
+        for _ in range(m + _match_min - 1):
+            out.append(out[-offset])
+
+    if len(out) != raw_size:
+        raise ValueError(f"block decoded to {len(out)} bytes, expected {raw_size}")
+    return bytes(out)
+
+# --------------------------------------------------------------------------- #
+# Frame stream -------------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def unframe(data):
+    """
+    Generator yielding the plain CTF packets of a framed stream.
+    """
+    pos = 0
+    while pos < len(data):
+        magic, codec, _, body_size, raw_size = _frame_hdr.unpack_from(data, pos)
+        if magic != _frame_magic:
+            raise ValueError(f"bad frame magic at offset {pos}")
+        pos += _frame_hdr.size
+        body = data[pos:pos + body_size]
+        pos += body_size
+
+        if codec == _codec_raw:
+            yield body
+        elif codec == _codec_lz:
+            yield decompress(body, raw_size)
+        else:
+            raise ValueError(f"unknown codec {codec} at offset {pos}")
+
+# --------------------------------------------------------------------------- #
+# Main entry point ---------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def main(in_file, out_file):
+    """
+    Restore a plain CTF stream file, readable by babeltrace2, from the
+    framed (optionally compressed) packets written by ``packetCompressor``.
+    """
+    with open(in_file, "rb") as f:
+        data = f.read()
+
+    with open(out_file, "wb") as f:
+        for pkt in unframe(data):
+            f.write(pkt)
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        print(f"Usage: {sys.argv[0]} <framed_stream> <ctf_stream>")
+        sys.exit(1)
+    try:
+        main(sys.argv[1], sys.argv[2])
+    except ValueError as e:
+        print(f"{sys.argv[1]}: {e}")
+        sys.exit(-1)
@@ -0,0 +1,98 @@
+# SPDX-License-Identifier: MIT | Author: Rohit Patil
+#!/usr/bin/env python3
+import argparse
+import itertools
+import json
+import os
+import subprocess
+import sys
+
+# Harness sources, relative to this script.
+_soak_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "soak")
+
+# Columns of the result table: (title, JSON key, format).
+_columns = [
+    ("size", "event_size", "{}"),
+    ("ev/pkt", "events_per_packet", "{}"),
+    ("pkts", "packets", "{}"),
+    ("pushed", "pushed", "{}"),
+    ("drop %", "drop_pct", "{:.3f}"),
+    ("lock", "lock_busy", "{}"),
+    ("no pkt", "pool_exhausted", "{}"),
+    ("rdy max", "ready_max", "{}"),
+    ("full %", "pool_full_pct", "{:.1f}"),
+    ("p99 ns", "p99_ns", "{}"),
+    ("p99.9 ns", "p999_ns", "{}"),
+]
+
+def _int_list(text):
+    return [int(v) for v in text.split(",")]
+
+# --------------------------------------------------------------------------- #
+# Build and run one configuration ------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def build(build_dir, yaml_file, size, per_packet, packets):
+    """
+    Configure and build the harness for one buffer configuration.  Returns
+    None on success, else the last compiler line: a catalog event larger
+    than ``size`` fails the build (EventMemCopyable).
+    """
+    cfg = ["cmake", "-S", _soak_dir, "-B", build_dir, "-DCMAKE_BUILD_TYPE=Release",
+           f"-DMAX_EVENT_SIZE={size}", f"-DMAX_EVENT_PER_PACKET={per_packet}",
+           f"-DMAX_PACKETS={packets}"]
+    if yaml_file:
+        cfg.append(f"-DSOAK_EVENT_DESCRIPTION_FILE={os.path.abspath(yaml_file)}")
+
+    for cmd in (cfg, ["cmake", "--build", build_dir, "--target", "soak"]):
+        res = subprocess.run(cmd, capture_output=True, text=True)
+        if res.returncode != 0:
+            errors = [l for l in res.stdout.splitlines() + res.stderr.splitlines() if "error" in l]
+            return errors[0] if errors else "build failed"
+    return None
+
+def run(build_dir, load_args):
+    """
+    Run the harness and return its JSON summary.
+    """
+    res = subprocess.run([os.path.join(build_dir, "soak"), "--json"] + load_args,
+                         capture_output=True, text=True, check=True)
+    return json.loads(res.stdout.strip().splitlines()[-1])
+
+# --------------------------------------------------------------------------- #
+# Main entry point ---------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def main(argv):
+    """
+    Sweep the buffer configuration (MAX_EVENT_SIZE x MAX_EVENT_PER_PACKET x
+    MAX_PACKETS) against one load and print a table, to pick the smallest
+    configuration meeting the drop budget for a given transport.
+    """
+    p = argparse.ArgumentParser(description=main.__doc__)
+    p.add_argument("--event-size", type=_int_list, default=[64], help="comma separated MAX_EVENT_SIZE values")
+    p.add_argument("--per-packet", type=_int_list, default=[10], help="comma separated MAX_EVENT_PER_PACKET values")
+    p.add_argument("--packets", type=_int_list, default=[3], help="comma separated MAX_PACKETS values")
+    p.add_argument("--yaml", help="event catalog (default example/example.yml)")
+    p.add_argument("--build-dir", default="build/soak_sweep", help="build tree, reused across runs")
+    p.add_argument("--budget", type=float, help="drop percentage budget; flags the configurations within it")
+    args, load_args = p.parse_known_args(argv[1:])
+
+    print(" | ".join(f"{c[0]:>8}" for c in _columns) + (" | budget" if args.budget is not None else ""))
+
+    for size, per_packet, packets in itertools.product(args.event_size, args.per_packet, args.packets):
+        error = build(args.build_dir, args.yaml, size, per_packet, packets)
+        if error is not None:
+            print(f"{size:>8} | {per_packet:>8} | {packets:>8} | does not build: {error}")
+            continue
+
+        result = run(args.build_dir, load_args)
+        line = " | ".join(f"{c[2].format(result[c[1]]):>8}" for c in _columns)
+        if args.budget is not None:
+            line += " | " + ("ok" if result["drop_pct"] <= args.budget else "over")
+        print(line, flush=True)
+
+if __name__ == "__main__":
+    try:
+        main(sys.argv)
+    except subprocess.CalledProcessError as e:
+        print(f"{' '.join(e.cmd)}: exit {e.returncode}\n{e.stderr}")
+        sys.exit(-1)
@@ -0,0 +1,335 @@
+# SPDX-License-Identifier: MIT | Author: Rohit Patil
+#!/usr/bin/env python3
+import argparse
+import mmap
+import os
+import sys
+
+import numpy as np
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import event_generate
+import trace_index
+
+# numpy types of the YAML types.
+_dtypes = {"uint8_t": "<u1", "uint16_t": "<u2", "uint32_t": "<u4",
+           "int8_t": "<i1", "int16_t": "<i2", "int32_t": "<i4"}
+
+# Payload size of an id that is not fixed: EVT_LOG records and encoded
+# events are sized on the way.
+_variable = -1
+_unknown = -2
+
+# --------------------------------------------------------------------------- #
+# Vectorised reads ---------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def _gather(data, pos, nbytes):
+    """
+    ``nbytes`` bytes at each offset of ``pos``, one contiguous row per
+    offset.  Rows running past the end of the file read zeros.
+    """
+    idx = pos[:, None] + np.arange(nbytes)
+    rows = data[np.minimum(idx, data.size - 1)]
+    rows[idx >= data.size] = 0
+    return np.ascontiguousarray(rows)
+
+def _read(data, pos, dtype):
+    """
+    One ``dtype`` value at each offset of ``pos``.
+    """
+    dtype = np.dtype(dtype)
+    return _gather(data, pos, dtype.itemsize).view(dtype).reshape(-1)
+
+def _tagged(data, pos, signed):
+    """
+    Encoded field at each offset of ``pos`` (include/eventEncoding.hpp):
+    width tag then that many little endian bytes.  Returns the values as
+    int64 and the offsets past them.
+    """
+    width = data[pos].astype(np.int64)
+    raw = _gather(data, pos + 1, 4).astype(np.int64)
+    raw[np.arange(4) >= width[:, None]] = 0
+    value = (raw << (8 * np.arange(4))).sum(axis=1)
+    if signed:
+        bits = 8 * width
+        neg = (width > 0) & ((value >> np.maximum(bits - 1, 0)) & 1).astype(bool)
+        value = np.where(neg, value - (np.int64(1) << bits), value)
+    return value, pos + 1 + width
+
+# --------------------------------------------------------------------------- #
+# Event types --------------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+class _EventType:
+    """
+    One event type of a stream: wire size and structured dtype of its
+    rows, a ``timestamp`` column then the payload fields (arrays as
+    subarrays, the ``_padding`` of the aligned layout left out).
+    """
+    def __init__(self, name, fields, aligned, encoded):
+        self.name = name
+        self.fields = fields
+        self.encoded = encoded
+        self.row = np.dtype([("timestamp", "<u8")] +
+                            [(f['name'], _dtypes[f['type']], (f['count'],) if f.get('count', 1) > 1 else ())
+                             for f in fields if f['name'] != "_padding"])
+        if encoded:
+            self.size = _variable
+            self.wire = None
+            return
+
+        # Wire payload as a dtype with explicit offsets, padding skipped.
+        names, formats, offsets = [], [], []
+        offset = 0
+        for f in event_generate.layout_fields(fields, aligned):
+            size = event_generate._type_info[f['type']][0] * f.get('count', 1)
+            if f['name'] != "_padding":
+                names.append(f['name'])
+                formats.append(self.row.fields[f['name']][0])
+                offsets.append(offset)
+            offset += size
+        self.size = offset
+        self.wire = np.dtype({"names": names, "formats": formats, "offsets": offsets, "itemsize": max(offset, 1)})
+
+    def sizes(self, data, pos):
+        """
+        Payload size of each encoded event at ``pos``.
+        """
+        end = pos
+        for f in self.fields:
+            if 'encoding' in f:
+                end = end + 1 + data[end].astype(np.int64)
+            else:
+                end = end + event_generate._type_info[f['type']][0] * f.get('count', 1)
+        return end - pos
+
+    def decode(self, data, pos, ts, packet):
+        """
+        Rows of the events whose payload starts at ``pos``, in packet then
+        capture order (``packet`` groups the delta fields).
+        """
+        out = np.empty(pos.size, dtype=self.row)
+        out["timestamp"] = ts
+        if not self.encoded:
+            payload = _gather(data, pos, self.wire.itemsize).view(self.wire).reshape(-1)
+            for name in self.wire.names:
+                out[name] = payload[name]
+            return out
+
+        first = np.ones(pos.size, dtype=bool)
+        first[1:] = packet[1:] != packet[:-1]
+        for f in self.fields:
+            size = event_generate._type_info[f['type']][0]
+            count = f.get('count', 1)
+            enc = f.get('encoding')
+            if enc is None:
+                value = _gather(data, pos, size * count).view(_dtypes[f['type']])
+                out[f['name']] = value.reshape(out[f['name']].shape)
+                pos = pos + size * count
+                continue
+
+            value, pos = _tagged(data, pos, event_generate._encodings[enc])
+            if enc == "delta":
+                # Running sum per packet, the previous value starts at 0.
+                total = np.cumsum(value)
+                base = (total - value)[first]
+                value = total - np.repeat(base, np.diff(np.append(np.flatnonzero(first), pos.size)))
+            mask = (np.int64(1) << (8 * size)) - 1
+            out[f['name']] = (value & mask).astype(_dtypes[f['type']].replace("i", "u")).view(_dtypes[f['type']])
+        return out
+
+def event_types(stream, aligned):
+    """
+    Event types of a catalog stream (``trace_index.load_catalog``) by id,
+    with the reserved ``evt_shed`` marker.  EVT_LOG records are read
+    apart.
+    """
+    types = {}
+    for e in stream["defs"]:
+        types[e['id']] = _EventType(e['name'], event_generate.event_fields(e), aligned,
+                                    event_generate.is_encoded(e))
+    types[event_generate._event_shed_id] = _EventType("evt_shed", event_generate._event_shed_fields,
+                                                       aligned, False)
+    return types
+
+# --------------------------------------------------------------------------- #
+# Packet walk --------------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def walk(data, packets, stream, types):
+    """
+    Offsets of every event of ``packets``, all packets in lock step: each
+    round reads the next event header of every packet still open, so the
+    work per round is a few array operations and the number of rounds is
+    the largest event count of a packet.  Returns, per event id, the
+    payload offsets, timestamps and packet numbers in packet then capture
+    order.
+    """
+    layout = stream["layout"]
+    evt_hdr = layout.evt_hdr.size
+    ts_at = evt_hdr - 8
+
+    sizes = np.full(1 << 16, _unknown, dtype=np.int64)
+    for eid, t in types.items():
+        sizes[eid] = t.size
+    sizes[event_generate._event_log_id] = _variable
+
+    start = np.array([p.offset for p in packets], dtype=np.int64)
+    end = start + np.array([p.content for p in packets], dtype=np.int64)
+    pos = start + layout.pkt_hdr.size + stream["context"][0].size
+    active = np.arange(len(packets))
+    found = []
+
+    while active.size:
+        p = pos[active]
+        p += -(p - start[active]) % layout.align
+        open_ = p + evt_hdr <= end[active]
+        active, p = active[open_], p[open_]
+        if not active.size:
+            break
+
+        eid = _read(data, p, "<u4").astype(np.int64)
+        ts = _read(data, p + ts_at, "<u8")
+        size = np.where(eid < sizes.size, sizes[np.minimum(eid, sizes.size - 1)], _unknown)
+        if (size == _unknown).any():
+            bad = p[size == _unknown][0]
+            raise ValueError(f"unknown event id {eid[size == _unknown][0]} of stream "
+                             f"{packets[0].stream} at offset {bad + evt_hdr}")
+
+        payload = p + evt_hdr
+        for vid in np.unique(eid[size == _variable]):
+            sel = eid == vid
+            if vid == event_generate._event_log_id:
+                argc = data[payload[sel] + 4].astype(np.int64)
+                size[sel] = layout.log_hdr.size + 4 * argc
+            else:
+                size[sel] = types[vid].sizes(data, payload[sel])
+
+        found.append((eid, payload, ts, active))
+        pos[active] = payload + size
+
+    by_id = {}
+    if not found:
+        return by_id
+    eid, payload, ts, pkt = (np.concatenate(c) for c in zip(*found))
+    order = np.argsort(pkt, kind="stable")
+    eid, payload, ts, pkt = eid[order], payload[order], ts[order], pkt[order]
+    for vid in np.unique(eid):
+        sel = eid == vid
+        by_id[int(vid)] = (payload[sel], ts[sel], pkt[sel])
+    return by_id
+
+def _log_rows(data, layout, pos, ts):
+    """
+    EVT_LOG records: ``fmt_id``, ``argc`` and the arguments, padded with
+    0 up to the largest ``argc``.
+    """
+    fmt_id = _read(data, pos, "<u4")
+    argc = data[pos + 4]
+    width = max(int(argc.max(initial=0)), 1)
+    out = np.empty(pos.size, dtype=[("timestamp", "<u8"), ("fmt_id", "<u4"), ("argc", "u1"),
+                                     ("args", "<u4", (width,))])
+    out["timestamp"] = ts
+    out["fmt_id"] = fmt_id
+    out["argc"] = argc
+    args = _gather(data, pos + layout.log_hdr.size, 4 * width).view("<u4")
+    args[np.arange(width) >= argc[:, None]] = 0
+    out["args"] = args
+    return out
+
+# --------------------------------------------------------------------------- #
+# Loading ------------------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def load(traces, yaml_files, begin=0, end=2**64 - 1, aligned=False):
+    """
+    Events of plain CTF stream files as one structured array per stream
+    and event type: ``{stream name: {event name: array}}``, rows in
+    timestamp order, timestamps in ``[begin, end)``.  The files are
+    mmapped and each column is filled by a vectorised gather, no Python
+    object is made per event.  Packets come from the sidecar index of
+    ``trace_index.py``.
+    """
+    catalog = trace_index.load_catalog(yaml_files, aligned)
+    parts = {}
+    for path in traces:
+        packets, _ = trace_index.load_index(path, aligned)
+        by_stream = {}
+        for p in trace_index.select(packets, begin, end):
+            if p.stream not in catalog:
+                raise ValueError(f"{path}: stream {p.stream} not in the catalog")
+            by_stream.setdefault(p.stream, []).append(p)
+        if not by_stream:
+            continue
+
+        with open(path, "rb") as f, mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as m:
+            data = np.frombuffer(m, dtype=np.uint8)
+            for sid, pkts in by_stream.items():
+                stream = catalog[sid]
+                types = event_types(stream, aligned)
+                for eid, (pos, ts, pkt) in walk(data, pkts, stream, types).items():
+                    keep = (ts >= begin) & (ts < end)
+                    if eid == event_generate._event_log_id:
+                        rows = _log_rows(data, stream["layout"], pos, ts)
+                        name = "evt_log"
+                    else:
+                        rows = types[eid].decode(data, pos, ts, pkt)
+                        name = types[eid].name
+                    parts.setdefault((stream["name"], name), []).append(rows[keep])
+            del data
+
+    out = {}
+    for sid, stream in catalog.items():
+        arrays = out.setdefault(stream["name"], {})
+        for t in event_types(stream, aligned).values():
+            arrays[t.name] = np.empty(0, dtype=t.row)
+    for (sname, name), rows in parts.items():
+        if name == "evt_log":
+            width = max(r.dtype["args"].shape[0] for r in rows)
+            rows = [_widen_log(r, width) for r in rows]
+        rows = np.concatenate(rows)
+        out[sname][name] = rows[np.argsort(rows["timestamp"], kind="stable")]
+    return out
+
+def _widen_log(rows, width):
+    """
+    EVT_LOG rows with ``width`` argument slots, so files with different
+    largest ``argc`` concatenate.
+    """
+    if rows.dtype["args"].shape[0] == width:
+        return rows
+    out = np.zeros(rows.size, dtype=[("timestamp", "<u8"), ("fmt_id", "<u4"), ("argc", "u1"),
+                                     ("args", "<u4", (width,))])
+    for name in ("timestamp", "fmt_id", "argc"):
+        out[name] = rows[name]
+    out["args"][:, :rows.dtype["args"].shape[0]] = rows["args"]
+    return out
+
+# --------------------------------------------------------------------------- #
+# Main entry point ---------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def main(argv):
+    """
+    Decode plain CTF stream files into one structured NumPy array per
+    stream and event type.  With ``--out``, each array is saved as
+    ``<stream>.<event>.npy``, ``numpy.load(path, mmap_mode="r")`` maps it
+    back without a copy.
+    """
+    p = argparse.ArgumentParser(description=main.__doc__)
+    p.add_argument("--aligned", action="store_true",
+                   help="traces of an EVENT_ALIGNED_LAYOUT build (naturally aligned fields)")
+    p.add_argument("traces", nargs="+")
+    p.add_argument("--yaml", action="append", required=True, help="event catalog, repeat per file")
+    p.add_argument("--begin", type=int, default=0)
+    p.add_argument("--end", type=int, default=2**64 - 1)
+    p.add_argument("--out", help="directory receiving the .npy files")
+    args = p.parse_args(argv[1:])
+
+    arrays = load(args.traces, args.yaml, args.begin, args.end, args.aligned)
+    if args.out:
+        os.makedirs(args.out, exist_ok=True)
+    for sname, events in arrays.items():
+        for name, rows in events.items():
+            print(f"{sname}.{name}: {rows.size} events, {rows.dtype.descr}")
+            if args.out:
+                np.save(os.path.join(args.out, f"{sname}.{name}.npy"), rows)
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -0,0 +1,449 @@
+# SPDX-License-Identifier: MIT | Author: Rohit Patil
+#!/usr/bin/env python3
+import argparse
+import bisect
+import collections
+import heapq
+import mmap
+import os
+import struct
+import sys
+from concurrent.futures import ProcessPoolExecutor
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import event_generate
+
+# Wire layout, packed or naturally aligned (``--aligned``, see
+# include/event.hpp): packet header up to packet_seq_count (packetBuffer in
+# include/internal/eventPacket.hpp, sizes on wire are in bits), event
+# header (id, timestamp), EVT_LOG record header (include/eventLog.hpp:
+# fmt_id, argc, then argc words) and the boundary every event starts on.
+Layout = collections.namedtuple("Layout", "pkt_hdr evt_hdr log_hdr align")
+_layouts = {
+    False: Layout(struct.Struct("<IQQIIII"), struct.Struct("<IQ"), struct.Struct("<IB"), 1),
+    True: Layout(struct.Struct("<I4xQQIIII"), struct.Struct("<I4xQ"), struct.Struct("<IB3x"), 8),
+}
+
+# Sidecar index ``<trace>.idx``: header, then one record per packet in
+# file order.  The header pins the trace size and mtime, a sidecar that no
+# longer matches its trace is rebuilt.
+_idx_magic = b"CTFX"
+_idx_version = 2
+_idx_hdr = struct.Struct("<4sIQQQI")    # magic, version, trace size, mtime_ns, scanned bytes, aligned
+_idx_rec = struct.Struct("<QQQIIIII")   # begin, end, offset, packet bytes, content bytes, stream, seq, discarded
+
+Packet = collections.namedtuple("Packet", "begin end offset size content stream seq discarded")
+
+# struct codes of the YAML types.
+_type_codes = {"uint8_t": "B", "uint16_t": "H", "uint32_t": "I",
+               "int8_t": "b", "int16_t": "h", "int32_t": "i"}
+
+# --------------------------------------------------------------------------- #
+# Packet index -------------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def scan(path, aligned=False):
+    """
+    Walk the packet headers of a plain CTF stream file without decoding
+    events.  Returns the packets and the number of bytes scanned; a
+    truncated last packet (crash, rotation) ends the scan.
+    """
+    _pkt_hdr = _layouts[aligned].pkt_hdr
+    packets = []
+    with open(path, "rb") as f:
+        size = os.fstat(f.fileno()).st_size
+        offset = 0
+        while offset + _pkt_hdr.size <= size:
+            f.seek(offset)
+            sid, begin, end, discarded, psize, csize, seq = _pkt_hdr.unpack(f.read(_pkt_hdr.size))
+            psize //= 8
+            csize //= 8
+            if psize < _pkt_hdr.size or csize > psize:
+                raise ValueError(f"bad packet header at offset {offset}")
+            if offset + psize > size:
+                break
+            packets.append(Packet(begin, end, offset, psize, csize, sid, seq, discarded))
+            offset += psize
+    return packets, offset
+
+def load_index(path, aligned=False):
+    """
+    Packets of ``path`` from its sidecar index, (re)building the sidecar
+    when missing, stale or built for the other layout.  Returns
+    ``(packets, trailing bytes)``.
+    """
+    st = os.stat(path)
+    idx_path = path + ".idx"
+    try:
+        with open(idx_path, "rb") as f:
+            data = f.read()
+        magic, version, size, mtime, scanned, layout = _idx_hdr.unpack_from(data, 0)
+        if (magic, version, size, mtime, layout) == (_idx_magic, _idx_version, st.st_size,
+                                                     st.st_mtime_ns, int(aligned)):
+            packets = [Packet(*r) for r in _idx_rec.iter_unpack(data[_idx_hdr.size:])]
+            return packets, size - scanned
+    except (OSError, struct.error):
+        pass
+
+    packets, scanned = scan(path, aligned)
+    data = bytearray(_idx_hdr.pack(_idx_magic, _idx_version, st.st_size, st.st_mtime_ns, scanned,
+                                   int(aligned)))
+    for p in packets:
+        data += _idx_rec.pack(*p)
+    try:
+        with open(idx_path + ".tmp", "wb") as f:
+            f.write(data)
+        os.replace(idx_path + ".tmp", idx_path)
+    except OSError:
+        pass    # read only trace directory, index kept in memory
+    return packets, st.st_size - scanned
+
+def load_indexes(paths, jobs, aligned=False):
+    """
+    Index every trace file, one file per worker.
+    """
+    with ProcessPoolExecutor(jobs) as pool:
+        return dict(zip(paths, pool.map(load_index, paths, [aligned] * len(paths))))
+
+def select(packets, t0, t1):
+    """
+    Packets overlapping ``[t0, t1]``.  Bisect on the begin time, bounded
+    below by the longest packet, then filter on the end time.
+    """
+    ordered = sorted(packets, key=lambda p: p.begin)
+    begins = [p.begin for p in ordered]
+    span = max((p.end - p.begin for p in ordered), default=0)
+    lo = bisect.bisect_left(begins, t0 - span) if t0 > span else 0
+    hi = bisect.bisect_right(begins, t1)
+    return [p for p in ordered[lo:hi] if p.end >= t0]
+
+# --------------------------------------------------------------------------- #
+# Integrity report ---------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def report(path, packets, trailing, out):
+    """
+    Per stream summary of one trace file: time range, events discarded and
+    gaps in ``packet_seq_count``.  Every execution level (thread, IRQ)
+    numbers its packets from 0 (include/basicEventCollector.hpp), so one
+    stream can hold several interleaved sequences: a packet continues the
+    sequence expecting its number, 0 opens a new one, anything else closes
+    the gap of the closest lower sequence.
+    """
+    print(f"{path}: {len(packets)} packets", file=out)
+    if trailing:
+        print(f"  {trailing} trailing bytes (truncated packet)", file=out)
+
+    by_stream = collections.defaultdict(list)
+    for p in packets:
+        by_stream[p.stream].append(p)
+
+    for sid, pkts in sorted(by_stream.items()):
+        expected = set()
+        sequences = 0
+        gaps = []
+        for p in pkts:
+            if p.seq in expected:
+                expected.remove(p.seq)
+            elif p.seq == 0 or not expected:
+                sequences += 1
+            else:
+                lower = [e for e in expected if e < p.seq]
+                if lower:
+                    expected.remove(max(lower))
+                    gaps.append((max(lower), p.seq - 1, p.offset))
+                else:
+                    gaps.append((p.seq, p.seq, p.offset))  # replayed or reordered
+            expected.add(p.seq + 1)
+
+        discarded = sum(p.discarded for p in pkts)
+        print(f"  stream {sid}: {len(pkts)} packets, {sequences} sequence(s), "
+              f"ts {min(p.begin for p in pkts)}..{max(p.end for p in pkts)}, "
+              f"{discarded} events discarded", file=out)
+        for first, last, offset in gaps:
+            if first <= last:
+                print(f"    seq gap: {first}..{last} missing before offset {offset}", file=out)
+            else:
+                print(f"    seq {first} out of order at offset {offset}", file=out)
+
+# --------------------------------------------------------------------------- #
+# Event decoding ------------------------------------------------------------ #
+# --------------------------------------------------------------------------- #
+def _fields_struct(fields):
+    """
+    Decoder of fields in wire order, the ``_padding`` of the aligned
+    layout is skipped.
+    """
+    names = [(f['name'], f.get('count', 1)) for f in fields if f['name'] != "_padding"]
+    fmt = "<" + "".join(f"{f.get('count', 1)}{'x' if f['name'] == '_padding' else _type_codes[f['type']]}"
+                        for f in fields)
+    return struct.Struct(fmt), names
+
+class _EncodedFields:
+    """
+    Decoder of an event with encoded fields (include/eventEncoding.hpp):
+    YAML order, byte packed, an encoded field is a width tag then a little
+    endian value of that many bytes.  A delta is added to the previous
+    value of the field, kept in ``prev`` for the packet.
+    """
+    def __init__(self, fields):
+        self.fields = [(f['name'], f['type'], f.get('count', 1), f.get('encoding')) for f in fields]
+
+    def decode(self, data, pos, prev):
+        values = []
+        for name, type_name, count, enc in self.fields:
+            size = event_generate._type_info[type_name][0]
+            if enc is None:
+                values.extend(struct.unpack_from(f"<{count}{_type_codes[type_name]}", data, pos))
+                pos += size * count
+                continue
+
+            width = data[pos]
+            value = int.from_bytes(data[pos + 1:pos + 1 + width], "little",
+                                   signed=event_generate._encodings[enc])
+            pos += 1 + width
+            if enc == "delta":
+                bits = size * 8
+                value = (prev.get(name, 0) + value) & ((1 << bits) - 1)
+                prev[name] = value
+                if type_name.startswith("int") and value >> (bits - 1):
+                    value -= 1 << bits
+            values.append(value)
+        return values, pos
+
+def load_catalog(yaml_files, aligned=False):
+    """
+    Decoders of every stream of the YAML catalog, validated, numbered and
+    laid out as ``event_generate.py`` does: stream id -> name, wire
+    layout, context decoder, event id -> (name, payload struct, field
+    names) and the checked YAML events; the payload decoder of an event
+    with encoded fields is an ``_EncodedFields``.
+    """
+    groups = [event_generate.parse_yaml_file(f) for f in yaml_files]
+    streams = event_generate.check_streams(groups)
+    catalog = {}
+    for s in streams:
+        events = [e for g in s["groups"] for e in g["events"]]
+        for g in s["groups"]:
+            for e in g["events"]:
+                event_generate.check_argument(e, g["group"])
+        event_generate.assign_ids(events)
+
+        decoders = {}
+        for e in events:
+            if event_generate.is_encoded(e):
+                fields = event_generate.event_fields(e)
+                decoders[e['id']] = (e['name'], _EncodedFields(fields),
+                                     [(f['name'], f.get('count', 1)) for f in fields])
+                continue
+            fields = event_generate.layout_fields(event_generate.event_fields(e), aligned)
+            decoders[e['id']] = (e['name'],) + _fields_struct(fields)
+
+        decoders[event_generate._event_shed_id] = ("evt_shed",) + _fields_struct(event_generate._event_shed_fields)
+
+        context = event_generate.layout_fields(s["context"], aligned, 8)
+        catalog[s["id"]] = {"name": s["name"] or f"stream{s['id']}",
+                            "layout": _layouts[aligned],
+                            "context": _fields_struct(context),
+                            "events": decoders,
+                            "defs": events}
+    return catalog
+
+def _format(names, values):
+    """
+    babeltrace2 text layout of a field struct, so ``event_log_strings.py
+    expand`` also works on merged output.
+    """
+    out = []
+    pos = 0
+    for name, count in names:
+        if count == 1:
+            out.append(f"{name} = {values[pos]}")
+        else:
+            items = ", ".join(f"[{i}] = {v}" for i, v in enumerate(values[pos:pos + count]))
+            out.append(f"{name} = [ {items} ]")
+        pos += count
+    return "{ " + ", ".join(out) + " }"
+
+def decode_packet(data, pkt, stream, t0, t1):
+    """
+    Generator of ``(timestamp, text)`` for the events of one packet with a
+    timestamp in ``[t0, t1)``.
+    """
+    layout = stream["layout"]
+    ctx_struct, ctx_names = stream["context"]
+    pos = pkt.offset + layout.pkt_hdr.size
+    prefix = stream["name"] + "."
+    if ctx_names:
+        prefix_ctx = _format(ctx_names, ctx_struct.unpack_from(data, pos)) + ", "
+    else:
+        prefix_ctx = ""
+    pos += ctx_struct.size
+    end = pkt.offset + pkt.content
+    prev = collections.defaultdict(dict)  # previous values of delta fields, per event id
+
+    # Packets and the event payload start on the event boundary.
+    while True:
+        pos += -(pos - pkt.offset) % layout.align
+        if pos + layout.evt_hdr.size > end:
+            break
+        eid, ts = layout.evt_hdr.unpack_from(data, pos)
+        pos += layout.evt_hdr.size
+        if eid == event_generate._event_log_id:
+            fmt_id, argc = layout.log_hdr.unpack_from(data, pos)
+            args = struct.unpack_from(f"<{argc}I", data, pos + layout.log_hdr.size)
+            pos += layout.log_hdr.size + 4 * argc
+            text = _format([("fmt_id", 1), ("argc", 1), ("args", argc)] if argc else
+                           [("fmt_id", 1), ("argc", 1)], (fmt_id, argc) + args)
+            name = "evt_log"
+        elif eid in stream["events"]:
+            name, fields, names = stream["events"][eid]
+            if isinstance(fields, _EncodedFields):
+                values, pos = fields.decode(data, pos, prev[eid])
+                text = _format(names, values)
+            else:
+                text = _format(names, fields.unpack_from(data, pos))
+                pos += fields.size
+        else:
+            raise ValueError(f"unknown event id {eid} of stream {pkt.stream} at offset {pos}")
+
+        if t0 <= ts < t1:
+            yield ts, f"[{ts}] {prefix}{name}: {prefix_ctx}{text}"
+
+# --------------------------------------------------------------------------- #
+# k-way merge --------------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+_worker_catalog = None
+
+def merge_slice(job):
+    """
+    Merge the events of ``[t0, t1)`` from the packets overlapping it.  Each
+    packet is a sorted run; runs join the heap only once the merge reaches
+    their begin time, so the heap holds the overlapping packets only.
+    """
+    global _worker_catalog
+    yaml_files, aligned, t0, t1, packets = job
+    if _worker_catalog is None:
+        _worker_catalog = load_catalog(yaml_files, aligned)
+
+    files = {}
+    heap = []
+    lines = []
+    runs = sorted(packets, key=lambda fp: fp[1].begin)
+    i = 0
+    try:
+        while i < len(runs) or heap:
+            while i < len(runs) and (not heap or runs[i][1].begin <= heap[0][0]):
+                path, pkt = runs[i]
+                if path not in files:
+                    with open(path, "rb") as f:
+                        files[path] = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+                it = decode_packet(files[path], pkt, _worker_catalog[pkt.stream], t0, t1)
+                first = next(it, None)
+                if first is not None:
+                    heapq.heappush(heap, (first[0], i, first[1], it))
+                i += 1
+            if not heap:
+                continue
+
+            ts, k, text, it = heapq.heappop(heap)
+            lines.append(text)
+            nxt = next(it, None)
+            if nxt is not None:
+                heapq.heappush(heap, (nxt[0], k, nxt[1], it))
+    finally:
+        for m in files.values():
+            m.close()
+
+    return "".join(l + "\n" for l in lines)
+
+def merge(indexes, yaml_files, t0, t1, jobs, out, aligned=False):
+    """
+    Split ``[t0, t1]`` into slices holding about the same number of
+    packets (from the index), merge the slices in parallel and write them
+    in order: one timestamp ordered text stream of all files.
+    """
+    catalog = load_catalog(yaml_files, aligned)
+    packets = [(path, p) for path, (pkts, _) in indexes.items() for p in select(pkts, t0, t1)]
+    for path, p in packets:
+        if p.stream not in catalog:
+            raise ValueError(f"{path}: stream {p.stream} not in the catalog")
+    if not packets:
+        return
+
+    lo = max(t0, min(p.begin for _, p in packets))
+    hi = min(t1, max(p.end for _, p in packets)) + 1
+    begins = sorted(max(p.begin, lo) for _, p in packets)
+    slices = jobs * 4
+    bounds = sorted({lo, hi} | {begins[len(begins) * k // slices] for k in range(1, slices)})
+
+    work = []
+    for s0, s1 in zip(bounds, bounds[1:]):
+        work.append((yaml_files, aligned, s0, s1, [(path, p) for path, p in packets if p.end >= s0 and p.begin < s1]))
+
+    with ProcessPoolExecutor(jobs) as pool:
+        for text in pool.map(merge_slice, work):
+            out.write(text)
+
+# --------------------------------------------------------------------------- #
+# Main entry point ---------------------------------------------------------- #
+# --------------------------------------------------------------------------- #
+def main(argv):
+    """
+    Index, query and merge plain CTF stream files (``packet_decompress.py``
+    restores framed ones).  The sidecar ``<file>.idx`` is built on first
+    use and reused while the trace is unchanged.
+    """
+    p = argparse.ArgumentParser(description=main.__doc__)
+    p.add_argument("-j", "--jobs", type=int, default=os.cpu_count(), help="worker processes")
+    p.add_argument("--aligned", action="store_true",
+                   help="traces of an EVENT_ALIGNED_LAYOUT build (naturally aligned fields)")
+    sub = p.add_subparsers(dest="cmd", required=True)
+
+    s = sub.add_parser("index", help="build the sidecars, report seq gaps and discarded events")
+    s.add_argument("traces", nargs="+")
+
+    s = sub.add_parser("query", help="packets overlapping a time range")
+    s.add_argument("traces", nargs="+")
+    s.add_argument("--begin", type=int, default=0)
+    s.add_argument("--end", type=int, default=2**64 - 1)
+    s.add_argument("--out", help="directory receiving the selected packets, one file per trace")
+
+    s = sub.add_parser("merge", help="one timestamp ordered event stream of all traces")
+    s.add_argument("traces", nargs="+")
+    s.add_argument("--yaml", action="append", required=True, help="event catalog, repeat per file")
+    s.add_argument("--begin", type=int, default=0)
+    s.add_argument("--end", type=int, default=2**64 - 1)
+    s.add_argument("-o", "--output", help="output file (default stdout)")
+
+    args = p.parse_args(argv[1:])
+    indexes = load_indexes(args.traces, args.jobs, args.aligned)
+
+    if args.cmd == "index":
+        for path, (packets, trailing) in indexes.items():
+            report(path, packets, trailing, sys.stdout)
+    elif args.cmd == "query":
+        if args.out:
+            os.makedirs(args.out, exist_ok=True)
+        for path, (packets, _) in indexes.items():
+            selected = select(packets, args.begin, args.end)
+            for pkt in selected:
+                print(f"{path} offset {pkt.offset} size {pkt.size} stream {pkt.stream} "
+                      f"seq {pkt.seq} ts {pkt.begin}..{pkt.end}")
+            if args.out:
+                with open(path, "rb") as src, open(os.path.join(args.out, os.path.basename(path)), "wb") as dst:
+                    for pkt in sorted(selected, key=lambda p: p.offset):
+                        src.seek(pkt.offset)
+                        dst.write(src.read(pkt.size))
+    else:
+        out = open(args.output, "w") if args.output else sys.stdout
+        try:
+            merge(indexes, args.yaml, args.begin, args.end, args.jobs, out, args.aligned)
+        finally:
+            if out is not sys.stdout:
+                out.close()
+
+if __name__ == "__main__":
+    try:
+        main(sys.argv)
+    except ValueError as e:
+        print(e)
+        sys.exit(-1)